@@ -17,3 +17,8 @@ WEB_CONFIG="-s USE_GLFW=3 -s ASYNCIFY"
 SHELL_FILE="--shell-file gen/$APP_NAME.html"
 
 emcc -o site/$APP_NAME.html src/$APP_NAME.c -Os -Wall $SETTINGS $RAYLIB_LIB $RAYLIB_INCLUDE $WEB_CONFIG -DPLATFORM_WEB $SHELL_FILE
+
+cd dist
+echo "Compressing..."
+./main.out compress
+cd ..
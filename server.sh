@@ -1,4 +1,4 @@
 #!/usr/bin/env sh
 
-cd site
-python3 -m http.server
+cd dist
+./main.out serve
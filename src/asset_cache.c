@@ -0,0 +1,157 @@
+/*
+  A content-addressed cache for the game asset build. Every converted asset is stored in
+  ../gen/asset_cache/<key>.bin, where the key is a hash of everything the output depends on: the
+  bytes of its input files, and the name and version of the converter that made it. An unchanged
+  asset then costs a hash and a file read, instead of a decode and a re-encode.
+
+  Converters bump their version whenever their output changes, so stale entries simply stop being
+  found. Entries that weren't used by a build are deleted at the end of it, and deleting the whole
+  directory is always safe.
+*/
+
+#define ASSET_CACHE_DIRECTORY "../gen/asset_cache"
+#define ASSET_CACHE_MAGIC 0x48434b41 /* NOTE: "AKCH" */
+#define ASSET_CACHE_KEY_MAX 64
+
+typedef struct
+{
+    u32 Magic;
+    u32 Reserved;
+    u64 Key;
+    u64 InfoSize; /* NOTE: The fixed-size description of the output, then the output's data. */
+    u64 DataSize;
+} asset_cache_header;
+
+typedef struct
+{
+    u64 Keys[ASSET_CACHE_KEY_MAX];
+    u32 KeyCount;
+    b32 KeysDropped;
+    u32 HitCount;
+    u32 MissCount;
+} asset_cache_usage;
+
+internal u64 GetAssetCacheKey(char *Converter, u32 Version, u64 *InputHashes, u32 InputCount)
+{
+    u64 Hashes[8] = {HashCString((u8 *)Converter), Version};
+    u32 HashCount = 2;
+
+    for (u32 I = 0; I < InputCount && HashCount < ArrayCount(Hashes); ++I)
+    {
+        Hashes[HashCount++] = InputHashes[I];
+    }
+
+    u64 Key = HashBytes((u8 *)Hashes, HashCount * sizeof(u64));
+    return Key;
+}
+
+internal void GetAssetCachePath(u64 Key, u8 *Path, s32 PathMax)
+{
+    snprintf((char *)Path, PathMax, "%s/%016llx.bin", ASSET_CACHE_DIRECTORY, (unsigned long long)Key);
+}
+
+/*
+  Read the entry for Key into Arena. On a hit, Info gets a copy of the description and Data points
+  at the entry's data inside Arena.
+*/
+internal b32 ReadAssetCache(ryn_memory_arena *Arena, u64 Key, void *Info, u64 InfoSize, u8 **Data, u64 *DataSize)
+{
+    b32 Hit = 0;
+    u8 Path[256];
+    GetAssetCachePath(Key, Path, sizeof(Path));
+
+    if (platform_GetFileInfo(Path).Exists)
+    {
+        u64 Offset = Arena->Offset;
+        u64 FileSize = ReadFileIntoAllocator(Arena, Path);
+        u64 Size = FileSize ? FileSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator. */
+        asset_cache_header *Header = (asset_cache_header *)(Arena->Data + Offset);
+
+        /* NOTE: A size mismatch means the entry was cut short, e.g. by a build that crashed while writing it. */
+        Hit = (Size >= sizeof(asset_cache_header) &&
+               Header->Magic == ASSET_CACHE_MAGIC &&
+               Header->Key == Key &&
+               Header->InfoSize == InfoSize &&
+               sizeof(asset_cache_header) + Header->InfoSize + Header->DataSize == Size);
+
+        if (Hit)
+        {
+            core_CopyMemory((u8 *)(Header + 1), Info, InfoSize);
+            *Data = (u8 *)(Header + 1) + InfoSize;
+            *DataSize = Header->DataSize;
+        }
+        else
+        {
+            Arena->Offset = Offset;
+        }
+    }
+
+    return Hit;
+}
+
+internal void WriteAssetCache(u64 Key, void *Info, u64 InfoSize, u8 *Data, u64 DataSize)
+{
+    u8 Path[256];
+    asset_cache_header Header = {ASSET_CACHE_MAGIC, 0, Key, InfoSize, DataSize};
+    GetAssetCachePath(Key, Path, sizeof(Path));
+
+    file File = platform_OpenFile(Path);
+
+    if (File.File)
+    {
+        platform_WriteFile(File, (u8 *)&Header, sizeof(Header));
+        platform_WriteFile(File, Info, InfoSize);
+        platform_WriteFile(File, Data, DataSize);
+        CloseFile(File);
+    }
+}
+
+/* NOTE: Only called from the main thread, after the jobs are done. */
+internal void UseAssetCacheKey(asset_cache_usage *Usage, u64 Key, b32 Hit)
+{
+    if (Usage->KeyCount < ASSET_CACHE_KEY_MAX)
+    {
+        Usage->Keys[Usage->KeyCount++] = Key;
+    }
+    else
+    {
+        Usage->KeysDropped = 1;
+    }
+
+    Usage->HitCount += Hit != 0;
+    Usage->MissCount += Hit == 0;
+}
+
+/* Delete the entries this build didn't use, so the cache doesn't grow with every edit. */
+internal void PruneAssetCache(ryn_memory_arena *Arena, asset_cache_usage *Usage)
+{
+    if (Usage->KeysDropped)
+    {
+        /* NOTE: Some keys weren't recorded, so we can't tell which entries are unused. */
+        return;
+    }
+
+    ryn_memory_ArenaStackPush(Arena);
+    u64 ListOffset = Arena->Offset;
+    file_list *Files = WalkDirectory(Arena, (u8 *)ASSET_CACHE_DIRECTORY);
+
+    /* NOTE: WalkDirectory doesn't allocate anything when the directory is empty. */
+    for (file_list *File = Arena->Offset != ListOffset ? Files : 0; File; File = File->Next)
+    {
+        b32 IsUsed = 0;
+
+        for (u32 I = 0; !IsUsed && I < Usage->KeyCount; ++I)
+        {
+            u8 Path[256];
+            GetAssetCachePath(Usage->Keys[I], Path, sizeof(Path));
+            IsUsed = StringsEqual(Path, File->Name.Bytes);
+        }
+
+        if (!IsUsed)
+        {
+            remove((char *)File->Name.Bytes);
+        }
+    }
+
+    ryn_memory_ArenaStackPop(Arena);
+}
@@ -0,0 +1,247 @@
+/*
+  Load raylib types out of an asset pack (see asset_pack.h). Assets are decompressed straight into
+  memory from MemAlloc, so the results are freed with the usual raylib Unload calls. Textures and
+  sound bank Waves are the exception, they use the pack's data in place.
+*/
+
+internal Image LoadPackImage(asset_pack_header *Pack, char *Name)
+{
+    Image Result = {0};
+    asset_pack_entry *Entry = FindAsset(Pack, Name);
+
+    if (Entry && Entry->Type == asset_type_Image)
+    {
+        u8 *Pixels = MemAlloc((unsigned int)Entry->Size);
+
+        if (Pixels && UnpackAsset(Pack, Entry, Pixels))
+        {
+            Result.data = Pixels;
+            Result.width = (int)Entry->Parameters[0];
+            Result.height = (int)Entry->Parameters[1];
+            Result.mipmaps = 1;
+            Result.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        }
+        else
+        {
+            MemFree(Pixels);
+        }
+    }
+
+    if (!Result.data)
+    {
+        printf("Error in LoadPackImage: could not load \"%s\"\n", Name);
+    }
+
+    return Result;
+}
+
+/*
+  Upload an image to the GPU. Small image entries are stored uncompressed, so the Image wraps the
+  pixels inside the pack and LoadTextureFromImage reads them from there, without a copy. That Image
+  is never unloaded, since the pack owns its memory. Big ones are LZ4 compressed (see
+  ASSET_RAW_IMAGE_SIZE_MAX), and are unpacked once into an Image that is freed after the upload.
+*/
+internal Texture2D LoadPackTexture(asset_pack_header *Pack, char *Name)
+{
+    Texture2D Result = {0};
+    asset_pack_entry *Entry = FindAsset(Pack, Name);
+
+    if (Entry && Entry->Type == asset_type_Image)
+    {
+        if (Entry->Codec == asset_codec_None && Entry->PackedSize == Entry->Size)
+        {
+            Image PackImage = {0};
+            PackImage.data = GetAssetData(Pack, Entry);
+            PackImage.width = (int)Entry->Parameters[0];
+            PackImage.height = (int)Entry->Parameters[1];
+            PackImage.mipmaps = 1;
+            PackImage.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+            Result = LoadTextureFromImage(PackImage);
+        }
+        else
+        {
+            Image UnpackedImage = LoadPackImage(Pack, Name);
+
+            if (IsImageReady(UnpackedImage))
+            {
+                Result = LoadTextureFromImage(UnpackedImage);
+                UnloadImage(UnpackedImage);
+            }
+        }
+    }
+
+    if (!IsTextureReady(Result))
+    {
+        printf("Error in LoadPackTexture: could not load \"%s\"\n", Name);
+    }
+
+    return Result;
+}
+
+internal Wave LoadPackWave(asset_pack_header *Pack, char *Name)
+{
+    Wave Result = {0};
+    asset_pack_entry *Entry = FindAsset(Pack, Name);
+
+    if (Entry && Entry->Type == asset_type_Wave)
+    {
+        u8 *Samples = MemAlloc((unsigned int)Entry->Size);
+
+        if (Samples && UnpackAsset(Pack, Entry, Samples))
+        {
+            Result.data = Samples;
+            Result.frameCount = Entry->Parameters[0];
+            Result.sampleRate = Entry->Parameters[1];
+            Result.sampleSize = Entry->Parameters[2];
+            Result.channels = Entry->Parameters[3];
+        }
+        else
+        {
+            MemFree(Samples);
+        }
+    }
+
+    if (!Result.data)
+    {
+        printf("Error in LoadPackWave: could not load \"%s\"\n", Name);
+    }
+
+    return Result;
+}
+
+/*
+  Get a sound out of a sound bank (see sound_bank.c). The Wave points at the samples in the pack, so
+  it's never unloaded, LoadSoundFromWave makes the audio device's copy of it.
+*/
+internal Wave LoadPackBankWave(asset_pack_header *Pack, char *BankName, char *Name)
+{
+    Wave Result = {0};
+    asset_pack_entry *Entry = FindAsset(Pack, BankName);
+
+    if (Entry && Entry->Type == asset_type_SoundBank && Entry->Codec == asset_codec_None)
+    {
+        u8 *Bank = GetAssetData(Pack, Entry);
+        asset_sound *Sounds = (asset_sound *)Bank;
+        u32 SoundCount = Entry->Parameters[0];
+        u32 FrameSize = Entry->Parameters[2] / 8 * Entry->Parameters[3];
+
+        for (u32 I = 0; I < SoundCount && (I + 1) * sizeof(asset_sound) <= Entry->Size; ++I)
+        {
+            if (StringsEqual(Sounds[I].Name, (u8 *)Name) &&
+                Sounds[I].Offset + (u64)Sounds[I].FrameCount * FrameSize <= Entry->Size)
+            {
+                Result.data = Bank + Sounds[I].Offset;
+                Result.frameCount = Sounds[I].FrameCount;
+                Result.sampleRate = Entry->Parameters[1];
+                Result.sampleSize = Entry->Parameters[2];
+                Result.channels = Entry->Parameters[3];
+                break;
+            }
+        }
+    }
+
+    if (!Result.data)
+    {
+        printf("Error in LoadPackBankWave: could not find \"%s\" in \"%s\"\n", Name, BankName);
+    }
+
+    return Result;
+}
+
+/* NOTE: raylib still has to rasterize the font, so the TTF is only unpacked for as long as that takes. */
+internal Font LoadPackFont(asset_pack_header *Pack, char *Name, s32 FontSize, s32 *Codepoints, s32 CodepointCount)
+{
+    Font Result = {0};
+    asset_pack_entry *Entry = FindAsset(Pack, Name);
+
+    if (Entry && Entry->Type == asset_type_Font)
+    {
+        u8 *FontData = MemAlloc((unsigned int)Entry->Size);
+
+        if (FontData && UnpackAsset(Pack, Entry, FontData))
+        {
+            Result = LoadFontFromMemory(".ttf", FontData, (int)Entry->Size, FontSize, Codepoints, CodepointCount);
+        }
+
+        MemFree(FontData);
+    }
+
+    if (!IsFontReady(Result))
+    {
+        printf("Error in LoadPackFont: could not load \"%s\"\n", Name);
+    }
+
+    return Result;
+}
+
+/*
+  Load a font the asset build baked (see font_atlas.c). The glyphs are already rasterized, so this
+  only widens the atlas to the gray-alpha pixels raylib fonts use and copies the metrics. The result
+  is freed with UnloadFont.
+*/
+internal Font LoadPackBakedFont(asset_pack_header *Pack, char *Name)
+{
+    Font Result = {0};
+    asset_pack_entry *Entry = FindAsset(Pack, Name);
+
+    if (Entry && Entry->Type == asset_type_BakedFont)
+    {
+        u32 GlyphCount = Entry->Parameters[1];
+        u32 AtlasWidth = Entry->Parameters[2];
+        u32 AtlasHeight = Entry->Parameters[3];
+        u64 GlyphsSize = GlyphCount * sizeof(asset_font_glyph);
+        u64 AtlasSize = (u64)AtlasWidth * (u64)AtlasHeight;
+        u8 *FontData = MemAlloc((unsigned int)Entry->Size);
+        u8 *Pixels = MemAlloc((unsigned int)(AtlasSize * 2));
+        GlyphInfo *Glyphs = MemAlloc(GlyphCount * sizeof(GlyphInfo));
+        Rectangle *Rects = MemAlloc(GlyphCount * sizeof(Rectangle));
+
+        if (FontData && Pixels && Glyphs && Rects && GlyphsSize + AtlasSize == Entry->Size &&
+            UnpackAsset(Pack, Entry, FontData))
+        {
+            asset_font_glyph *BakedGlyphs = (asset_font_glyph *)FontData;
+            u8 *Coverage = FontData + GlyphsSize;
+
+            for (u64 I = 0; I < AtlasSize; ++I)
+            {
+                Pixels[2*I] = 255;
+                Pixels[2*I + 1] = Coverage[I];
+            }
+
+            for (u32 I = 0; I < GlyphCount; ++I)
+            {
+                asset_font_glyph *Baked = &BakedGlyphs[I];
+                Glyphs[I] = (GlyphInfo){Baked->Codepoint, Baked->OffsetX, Baked->OffsetY, Baked->AdvanceX, {0}};
+                Rects[I] = (Rectangle){(f32)Baked->X, (f32)Baked->Y, (f32)Baked->Width, (f32)Baked->Height};
+            }
+
+            Image Atlas = {Pixels, (int)AtlasWidth, (int)AtlasHeight, 1, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA};
+            Result.texture = LoadTextureFromImage(Atlas);
+        }
+
+        if (IsTextureReady(Result.texture))
+        {
+            Result.baseSize = (int)Entry->Parameters[0];
+            Result.glyphCount = (int)GlyphCount;
+            Result.glyphPadding = ASSET_FONT_GLYPH_PADDING;
+            Result.glyphs = Glyphs;
+            Result.recs = Rects;
+        }
+        else
+        {
+            MemFree(Glyphs);
+            MemFree(Rects);
+        }
+
+        MemFree(Pixels);
+        MemFree(FontData);
+    }
+
+    if (!IsFontReady(Result))
+    {
+        printf("Error in LoadPackBakedFont: could not load \"%s\"\n", Name);
+    }
+
+    return Result;
+}
@@ -0,0 +1,255 @@
+/*
+  Asset packs bundle a game's assets into one binary blob that gets embedded into the game, instead
+  of a C array per asset.
+
+  A pack starts with an asset_pack_header, then a table of contents with an asset_pack_entry per
+  asset, then the data of each entry. Offsets are from the start of the pack, and entry data is
+  aligned to ASSET_PACK_ALIGNMENT. Everything is little-endian.
+
+  The asset build (GenerateGameAssets) does the decoding up front: images are stored as RGBA8
+  pixels, waves as raw PCM frames and fonts as rasterized glyphs with their metrics, so loading an
+  asset is only a decompress. Entries are compressed with LZ4's block format, unless that doesn't
+  make them smaller. Images and sound banks are always stored uncompressed, so their data can be used
+  in place (see GetAssetData).
+
+  This file is shared by main.c, which writes packs, and the games, which read them. Games embed a
+  pack by including the generated gen/<name>_pack.h.
+*/
+
+#define ASSET_PACK_MAGIC 0x4b504b4f /* NOTE: "OKPK" */
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_NAME_MAX 32
+#define ASSET_PACK_ALIGNMENT 16
+#define ASSET_FONT_GLYPH_PADDING 2 /* NOTE: Empty pixels around each glyph in a baked font's atlas. */
+
+typedef enum
+{
+    asset_type_Undefined,
+    asset_type_Image, /* NOTE: Parameters are width and height, the data is RGBA8 pixels. */
+    asset_type_Wave,  /* NOTE: Parameters are frame count, sample rate, sample size in bits and channels. */
+    asset_type_Font,  /* NOTE: The data is the TTF file. */
+    asset_type_BakedFont, /* NOTE: Parameters are size in pixels, glyph count, atlas width and atlas height, see asset_font_glyph. */
+    asset_type_SoundBank, /* NOTE: Parameters are sound count, sample rate, sample size in bits and channels, see asset_sound. */
+    asset_type_Count,
+} asset_type;
+
+typedef enum
+{
+    asset_codec_None,
+    asset_codec_Lz4,
+    asset_codec_Count,
+} asset_codec;
+
+typedef struct
+{
+    u32 Magic;
+    u32 Version;
+    u32 EntryCount;
+    u32 Reserved;
+    u64 Size; /* NOTE: Of the whole pack, header included. */
+    u64 Reserved2;
+} asset_pack_header;
+
+typedef struct
+{
+    u8 Name[ASSET_PACK_NAME_MAX];
+    u32 Type;
+    u32 Codec;
+    u64 Offset;
+    u64 PackedSize;
+    u64 Size;
+    u32 Parameters[4];
+} asset_pack_entry;
+
+/*
+  The data of a baked font entry is an asset_font_glyph per glyph, then the atlas as 8-bit coverage,
+  a byte per pixel. The metrics are in pixels at the baked size, the way raylib's Font has them.
+*/
+typedef struct
+{
+    s32 Codepoint;
+    s32 OffsetX;
+    s32 OffsetY;
+    s32 AdvanceX;
+    u32 X, Y, Width, Height; /* NOTE: The glyph's rectangle in the atlas, without the padding. */
+} asset_font_glyph;
+
+/*
+  The data of a sound bank entry is an asset_sound per sound, then the samples of every sound,
+  starting at ASSET_PACK_ALIGNMENT. Samples are mono, signed 16-bit PCM.
+*/
+typedef struct
+{
+    u8 Name[ASSET_PACK_NAME_MAX]; /* NOTE: The file name without ".wav". */
+    u32 Offset;                   /* NOTE: Of the sound's first sample, from the start of the entry's data. */
+    u32 FrameCount;
+} asset_sound;
+
+/*
+  Embed the file at Path as u8 Name[]. The path is relative to the directory the compiler runs in,
+  which is the repo root for build.sh. Emscripten can't .incbin into wasm, so web builds include a
+  generated array instead.
+*/
+#if defined(__MACH__)
+#define ASSET_PACK_SECTION ".const_data"
+#define ASSET_PACK_SYMBOL(Name) "_" #Name
+#else
+#define ASSET_PACK_SECTION ".section .rodata"
+#define ASSET_PACK_SYMBOL(Name) #Name
+#endif
+
+#define ASSET_PACK_INCBIN(Name, Path)\
+    __asm__(ASSET_PACK_SECTION "\n"\
+            ".globl " ASSET_PACK_SYMBOL(Name) "\n"\
+            ".balign 16\n"\
+            ASSET_PACK_SYMBOL(Name) ":\n"\
+            ".incbin \"" Path "\"\n"\
+            ".previous\n");\
+    extern u8 Name[]
+
+internal asset_pack_header *GetAssetPack(u8 *Data)
+{
+    asset_pack_header *Pack = (asset_pack_header *)Data;
+
+    if (!Pack || Pack->Magic != ASSET_PACK_MAGIC || Pack->Version != ASSET_PACK_VERSION)
+    {
+        Pack = 0;
+    }
+
+    return Pack;
+}
+
+internal asset_pack_entry *FindAsset(asset_pack_header *Pack, char *Name)
+{
+    asset_pack_entry *Result = 0;
+    asset_pack_entry *Entries = (asset_pack_entry *)(Pack + 1);
+
+    for (u32 I = 0; Pack && I < Pack->EntryCount; ++I)
+    {
+        if (StringsEqual(Entries[I].Name, (u8 *)Name))
+        {
+            Result = &Entries[I];
+            break;
+        }
+    }
+
+    return Result;
+}
+
+internal u8 *GetAssetData(asset_pack_header *Pack, asset_pack_entry *Entry)
+{
+    u8 *Data = (u8 *)Pack + Entry->Offset;
+    return Data;
+}
+
+/* NOTE: A length of 15 continues in the following bytes, up to and including the first byte that isn't 255. */
+internal b32 Lz4ReadLength(u8 **Source, u8 *SourceEnd, u64 *Length)
+{
+    u8 Byte = 255;
+
+    while (Byte == 255)
+    {
+        if (*Source == SourceEnd)
+        {
+            return 0;
+        }
+
+        Byte = **Source;
+        *Source += 1;
+        *Length += Byte;
+    }
+
+    return 1;
+}
+
+/* Decode an LZ4 block. Returns the number of bytes written, or 0 if the block is malformed or doesn't fit. */
+internal u64 Lz4Decompress(u8 *Source, u64 SourceSize, u8 *Destination, u64 DestinationSize)
+{
+    u8 *SourceEnd = Source + SourceSize;
+    u8 *Out = Destination;
+    u8 *OutEnd = Destination + DestinationSize;
+
+    while (Source < SourceEnd)
+    {
+        u8 Token = *Source++;
+        u64 LiteralLength = Token >> 4;
+
+        if (LiteralLength == 15 && !Lz4ReadLength(&Source, SourceEnd, &LiteralLength))
+        {
+            return 0;
+        }
+
+        if (LiteralLength > (u64)(SourceEnd - Source) || LiteralLength > (u64)(OutEnd - Out))
+        {
+            return 0;
+        }
+
+        for (u64 I = 0; I < LiteralLength; ++I)
+        {
+            Out[I] = Source[I];
+        }
+
+        Source += LiteralLength;
+        Out += LiteralLength;
+
+        if (Source == SourceEnd)
+        {
+            /* NOTE: The last sequence is only literals. */
+            break;
+        }
+        else if (SourceEnd - Source < 2)
+        {
+            return 0;
+        }
+
+        u64 Offset = Source[0] | (Source[1] << 8);
+        u64 MatchLength = (Token & 15);
+        Source += 2;
+
+        if (MatchLength == 15 && !Lz4ReadLength(&Source, SourceEnd, &MatchLength))
+        {
+            return 0;
+        }
+
+        MatchLength += 4;
+
+        if (Offset == 0 || Offset > (u64)(Out - Destination) || MatchLength > (u64)(OutEnd - Out))
+        {
+            return 0;
+        }
+
+        /* NOTE: Byte by byte, since the match may overlap what it is writing. */
+        u8 *Match = Out - Offset;
+        for (u64 I = 0; I < MatchLength; ++I)
+        {
+            Out[I] = Match[I];
+        }
+
+        Out += MatchLength;
+    }
+
+    return (u64)(Out - Destination);
+}
+
+/* Decompress or copy an entry into Destination, which must hold Entry->Size bytes. */
+internal b32 UnpackAsset(asset_pack_header *Pack, asset_pack_entry *Entry, u8 *Destination)
+{
+    b32 Unpacked = 0;
+    u8 *Data = GetAssetData(Pack, Entry);
+
+    if (Entry->Codec == asset_codec_Lz4)
+    {
+        Unpacked = Lz4Decompress(Data, Entry->PackedSize, Destination, Entry->Size) == Entry->Size;
+    }
+    else if (Entry->Codec == asset_codec_None && Entry->PackedSize == Entry->Size)
+    {
+        for (u64 I = 0; I < Entry->Size; ++I)
+        {
+            Destination[I] = Data[I];
+        }
+
+        Unpacked = 1;
+    }
+
+    return Unpacked;
+}
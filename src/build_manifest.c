@@ -0,0 +1,551 @@
+/*
+  The build manifest records, for every file the site generator writes, the inputs that went into
+  it (source files, include targets and preprocessor variables) along with a hash of each input.
+  On the next run an output is only regenerated if one of its recorded inputs changed.
+
+  The manifest is a plain text file, one record per output:
+
+      output ../site/index.html
+      generator 5b2f0e8c41d7a963
+      file 4f0a9c31d2e6b7a8 2048 1699459200000000000 ../src/layout/index.html
+      variable 9e107d9d372bb682 FileName
+      content 1f3870be274f6c49
+      end
+
+  Every record is stamped with the hash of the generator that wrote it (a version constant plus
+  anything compiled in that shapes the output, e.g. page templates). Records from a different
+  generator are never found, so a new binary rebuilds everything the old one wrote.
+
+  Deleting the manifest forces a full rebuild.
+*/
+
+#define BUILD_MANIFEST_VERSION 2
+#define BUILD_RECORD_INPUT_MAX 32
+#define BUILD_MANIFEST_LINE_MAX 1024
+
+typedef enum
+{
+    build_input_type_Undefined,
+    build_input_type_File,
+    build_input_type_Variable,
+    build_input_type_Content,
+    build_input_type_Count,
+} build_input_type;
+
+typedef struct
+{
+    build_input_type Type;
+    u64 Hash;
+    u64 Size;
+    u64 ModifiedTime;
+    u8 *Name;
+} build_input;
+
+typedef struct build_record build_record;
+struct build_record
+{
+    build_record *Next;
+    u64 OutputHash;
+    u64 GeneratorHash;
+    u8 *OutputPath;
+    s32 InputCount;
+    build_input Inputs[BUILD_RECORD_INPUT_MAX];
+};
+
+typedef struct
+{
+    u8 *Path;
+    ryn_memory_arena Arena;
+    u64 GeneratorHash;
+
+    build_record *OldRecords;
+    build_record *NewRecords;
+    build_record *CurrentRecord;
+
+    /* NOTE: Open-addressed by OutputHash, so FindBuildRecord doesn't walk the whole list for every output. */
+    build_record **OldRecordTable;
+    u32 OldRecordTableMask;
+    s32 OldRecordCount;
+
+    /* NOTE: Set when a record is built or an input's modified-time is updated. */
+    b32 Changed;
+
+    s32 BuiltCount;
+    s32 SkippedCount;
+} build_manifest;
+
+global_variable u8 *BuildInputTypeNames[build_input_type_Count] = {
+    [build_input_type_Undefined] = (u8 *)"undefined",
+    [build_input_type_File]      = (u8 *)"file",
+    [build_input_type_Variable]  = (u8 *)"variable",
+    [build_input_type_Content]   = (u8 *)"content",
+};
+
+internal u8 *PushCString(ryn_memory_arena *Arena, u8 *String)
+{
+    s32 Length = GetStringLength(String);
+    u8 *Result = ryn_memory_PushSize(Arena, Length + 1);
+
+    if (Result)
+    {
+        core_CopyMemory(String, Result, Length);
+        Result[Length] = 0;
+    }
+
+    return Result;
+}
+
+internal u64 HashCString(u8 *String)
+{
+    u64 Hash = HashBytes(String, GetStringLength(String));
+    return Hash;
+}
+
+/* Build the lookup table for OldRecords. The table is at most half full, so probes stay short. */
+internal void IndexBuildRecords(build_manifest *Manifest)
+{
+    u32 TableSize = 16;
+    Manifest->OldRecordCount = 0;
+
+    for (build_record *Record = Manifest->OldRecords; Record; Record = Record->Next)
+    {
+        Manifest->OldRecordCount += 1;
+    }
+
+    while (TableSize < 2 * (u32)Manifest->OldRecordCount)
+    {
+        TableSize *= 2;
+    }
+
+    Manifest->Arena.Offset = (Manifest->Arena.Offset + 7) & ~(u64)7;
+    Manifest->OldRecordTable = ryn_memory_PushSize(&Manifest->Arena, TableSize * sizeof(build_record *));
+    Manifest->OldRecordTableMask = TableSize - 1;
+
+    if (!Manifest->OldRecordTable)
+    {
+        printf("Error in IndexBuildRecords: could not allocate a table for %d records\n", Manifest->OldRecordCount);
+        return;
+    }
+
+    SetMemory((u8 *)Manifest->OldRecordTable, 0, TableSize * sizeof(build_record *));
+
+    for (build_record *Record = Manifest->OldRecords; Record; Record = Record->Next)
+    {
+        u32 Slot = (u32)Record->OutputHash & Manifest->OldRecordTableMask;
+
+        while (Manifest->OldRecordTable[Slot])
+        {
+            Slot = (Slot + 1) & Manifest->OldRecordTableMask;
+        }
+
+        Manifest->OldRecordTable[Slot] = Record;
+    }
+}
+
+/* Find the old record for an output. Records stamped by a different generator don't count. */
+internal build_record *FindBuildRecord(build_manifest *Manifest, u8 *OutputPath)
+{
+    build_record *Result = 0;
+    u64 OutputHash = HashCString(OutputPath);
+
+    if (Manifest->OldRecordTable)
+    {
+        u32 Slot = (u32)OutputHash & Manifest->OldRecordTableMask;
+
+        for (build_record *Record = Manifest->OldRecordTable[Slot]; Record; Record = Manifest->OldRecordTable[Slot])
+        {
+            if (Record->OutputHash == OutputHash && StringsEqual(Record->OutputPath, OutputPath))
+            {
+                Result = Record->GeneratorHash == Manifest->GeneratorHash ? Record : 0;
+                break;
+            }
+
+            Slot = (Slot + 1) & Manifest->OldRecordTableMask;
+        }
+    }
+
+    return Result;
+}
+
+internal build_record *PushBuildRecord(build_manifest *Manifest, build_record **Records, u8 *OutputPath)
+{
+    build_record *Record = ryn_memory_PushZeroStruct(&Manifest->Arena, build_record);
+
+    if (Record)
+    {
+        Record->OutputPath = PushCString(&Manifest->Arena, OutputPath);
+        Record->OutputHash = HashCString(OutputPath);
+        Record->Next = *Records;
+        *Records = Record;
+    }
+
+    return Record;
+}
+
+internal build_input *PushBuildInput(build_record *Record, build_input_type Type, u8 *Name, u64 Hash)
+{
+    build_input *Input = 0;
+
+    if (!Record)
+    {
+        /* NOTE: No output is being recorded, so there is nothing to do. */
+    }
+    else if (Record->InputCount >= BUILD_RECORD_INPUT_MAX)
+    {
+        printf("Error in PushBuildInput: too many inputs for \"%s\"\n", Record->OutputPath);
+    }
+    else
+    {
+        Input = &Record->Inputs[Record->InputCount];
+        Input->Type = Type;
+        Input->Name = Name;
+        Input->Hash = Hash;
+        Input->Size = 0;
+        Input->ModifiedTime = 0;
+        Record->InputCount += 1;
+    }
+
+    return Input;
+}
+
+internal build_manifest LoadBuildManifest(u8 *Path, u64 GeneratorHash)
+{
+    build_manifest Manifest = {0};
+    Manifest.Path = Path;
+    Manifest.Arena = ryn_memory_CreateArena(Megabytes(64));
+    Manifest.GeneratorHash = GeneratorHash;
+
+    FILE *File = fopen((char *)Path, "rb");
+
+    if (File)
+    {
+        char Line[BUILD_MANIFEST_LINE_MAX];
+        build_record *Record = 0;
+        b32 VersionMatches = 0;
+
+        while (fgets(Line, sizeof(Line), File))
+        {
+            s32 Length = GetStringLength((u8 *)Line);
+            unsigned long long Hash = 0, Size = 0, ModifiedTime = 0;
+            s32 NameOffset = 0;
+            s32 Version = 0;
+
+            if (Length > 0 && Line[Length - 1] == '\n')
+            {
+                Line[Length - 1] = 0;
+            }
+
+            if (sscanf(Line, "version %d", &Version) == 1)
+            {
+                VersionMatches = Version == BUILD_MANIFEST_VERSION;
+            }
+            else if (!VersionMatches)
+            {
+                break;
+            }
+            else if (sscanf(Line, "output %n", &NameOffset) == 0 && NameOffset)
+            {
+                Record = PushBuildRecord(&Manifest, &Manifest.OldRecords, (u8 *)Line + NameOffset);
+            }
+            else if (sscanf(Line, "generator %llx", &Hash) == 1)
+            {
+                if (Record)
+                {
+                    Record->GeneratorHash = Hash;
+                }
+            }
+            else if (sscanf(Line, "file %llx %llu %llu %n", &Hash, &Size, &ModifiedTime, &NameOffset) == 3 && NameOffset)
+            {
+                u8 *Name = PushCString(&Manifest.Arena, (u8 *)Line + NameOffset);
+                build_input *Input = PushBuildInput(Record, build_input_type_File, Name, Hash);
+
+                if (Input)
+                {
+                    Input->Size = Size;
+                    Input->ModifiedTime = ModifiedTime;
+                }
+            }
+            else if (sscanf(Line, "variable %llx %n", &Hash, &NameOffset) == 1 && NameOffset)
+            {
+                u8 *Name = PushCString(&Manifest.Arena, (u8 *)Line + NameOffset);
+                PushBuildInput(Record, build_input_type_Variable, Name, Hash);
+            }
+            else if (sscanf(Line, "content %llx", &Hash) == 1)
+            {
+                PushBuildInput(Record, build_input_type_Content, 0, Hash);
+            }
+            else if (StringsEqual((u8 *)Line, (u8 *)"end"))
+            {
+                Record = 0;
+            }
+
+            NameOffset = 0;
+        }
+
+        if (!VersionMatches)
+        {
+            printf("Build manifest \"%s\" is out of date, rebuilding everything\n", Path);
+            Manifest.OldRecords = 0;
+        }
+
+        CountFileRead((u64)ftell(File));
+        fclose(File);
+    }
+
+    IndexBuildRecords(&Manifest);
+
+    return Manifest;
+}
+
+/* Write the new records, unless every old record was kept as it was, in which case the file already says the same thing. */
+internal void WriteBuildManifest(build_manifest *Manifest)
+{
+    if (!Manifest->Changed && Manifest->SkippedCount == Manifest->OldRecordCount && platform_GetFileInfo(Manifest->Path).Exists)
+    {
+        return;
+    }
+
+    FILE *File = fopen((char *)Manifest->Path, "wb");
+
+    if (!File)
+    {
+        printf("Error in WriteBuildManifest: trying to open file \"%s\"\n", Manifest->Path);
+        return;
+    }
+
+    fprintf(File, "version %d\n", BUILD_MANIFEST_VERSION);
+
+    for (build_record *Record = Manifest->NewRecords; Record; Record = Record->Next)
+    {
+        fprintf(File, "output %s\n", Record->OutputPath);
+        fprintf(File, "generator %016llx\n", (unsigned long long)Record->GeneratorHash);
+
+        for (s32 I = 0; I < Record->InputCount; ++I)
+        {
+            build_input *Input = &Record->Inputs[I];
+            u8 *TypeName = BuildInputTypeNames[Input->Type];
+
+            switch (Input->Type)
+            {
+            case build_input_type_File:
+            {
+                fprintf(File, "%s %016llx %llu %llu %s\n", TypeName, (unsigned long long)Input->Hash,
+                        (unsigned long long)Input->Size, (unsigned long long)Input->ModifiedTime, Input->Name);
+            } break;
+            case build_input_type_Variable:
+            {
+                fprintf(File, "%s %016llx %s\n", TypeName, (unsigned long long)Input->Hash, Input->Name);
+            } break;
+            case build_input_type_Content:
+            {
+                fprintf(File, "%s %016llx\n", TypeName, (unsigned long long)Input->Hash);
+            } break;
+            default: break;
+            }
+        }
+
+        fprintf(File, "end\n");
+    }
+
+    CountFileWrite(1, (u64)ftell(File));
+    fclose(File);
+}
+
+internal b32 IsFileInputCurrent(build_manifest *Manifest, build_input *Input)
+{
+    b32 IsCurrent = 0;
+    file_info FileInfo = platform_GetFileInfo(Input->Name);
+
+    if (!FileInfo.Exists)
+    {
+        IsCurrent = 0;
+    }
+    else if (FileInfo.Size == Input->Size && FileInfo.ModifiedTime == Input->ModifiedTime)
+    {
+        /* NOTE: Same size and modified-time, so trust the recorded hash without reading the file. */
+        IsCurrent = 1;
+    }
+    else if (FileInfo.Size == Input->Size)
+    {
+        buffer *Buffer = ReadFileIntoBuffer(Input->Name);
+
+        if (Buffer)
+        {
+            IsCurrent = HashBytes(Buffer->Data, Buffer->Size) == Input->Hash;
+            FreeBuffer(Buffer);
+
+            if (IsCurrent)
+            {
+                /* NOTE: The file was touched but not changed, remember the new modified-time. */
+                Input->ModifiedTime = FileInfo.ModifiedTime;
+                Manifest->Changed = 1;
+            }
+        }
+    }
+
+    return IsCurrent;
+}
+
+/* Carry an old record over to the new manifest, so that skipped outputs are remembered for the next run. */
+internal void KeepBuildRecord(build_manifest *Manifest, build_record *OldRecord)
+{
+    build_record *Record = PushBuildRecord(Manifest, &Manifest->NewRecords, OldRecord->OutputPath);
+
+    if (Record)
+    {
+        Record->GeneratorHash = OldRecord->GeneratorHash;
+        Record->InputCount = OldRecord->InputCount;
+
+        for (s32 I = 0; I < OldRecord->InputCount; ++I)
+        {
+            Record->Inputs[I] = OldRecord->Inputs[I];
+        }
+    }
+
+    Manifest->SkippedCount += 1;
+}
+
+internal void BeginBuildRecord(build_manifest *Manifest, u8 *OutputPath)
+{
+    Assert(Manifest->CurrentRecord == 0);
+    Manifest->CurrentRecord = PushBuildRecord(Manifest, &Manifest->NewRecords, OutputPath);
+    Manifest->Changed = 1;
+
+    if (Manifest->CurrentRecord)
+    {
+        Manifest->CurrentRecord->GeneratorHash = Manifest->GeneratorHash;
+    }
+}
+
+internal void EndBuildRecord(build_manifest *Manifest)
+{
+    Manifest->CurrentRecord = 0;
+    Manifest->BuiltCount += 1;
+}
+
+internal void AddBuildFileInputHash(build_manifest *Manifest, u8 *Path, u64 Hash, u64 FileSize, u64 ModifiedTime)
+{
+    build_record *Record = Manifest->CurrentRecord;
+
+    if (Record)
+    {
+        u8 *Name = PushCString(&Manifest->Arena, Path);
+        build_input *Input = PushBuildInput(Record, build_input_type_File, Name, Hash);
+
+        if (Input)
+        {
+            Input->Size = FileSize;
+            Input->ModifiedTime = ModifiedTime;
+        }
+    }
+}
+
+internal void AddBuildFileInput(build_manifest *Manifest, u8 *Path, u8 *Data, u64 Size)
+{
+    if (Manifest->CurrentRecord)
+    {
+        file_info FileInfo = platform_GetFileInfo(Path);
+        AddBuildFileInputHash(Manifest, Path, HashBytes(Data, Size), FileInfo.Size, FileInfo.ModifiedTime);
+    }
+}
+
+internal void AddBuildVariableInput(build_manifest *Manifest, u8 *Key, u8 *Value)
+{
+    build_record *Record = Manifest->CurrentRecord;
+
+    if (Record)
+    {
+        u8 *Name = PushCString(&Manifest->Arena, Key);
+        u64 Hash = Value ? HashCString(Value) : 0;
+        PushBuildInput(Record, build_input_type_Variable, Name, Hash);
+    }
+}
+
+/* Write a file that was generated in memory, skipping the write if the previous run wrote the same bytes. */
+internal b32 WriteOutputIfChanged(build_manifest *Manifest, u8 *OutputPath, u8 *Data, u64 Size)
+{
+    b32 Written = 0;
+    u64 Hash = HashBytes(Data, Size);
+    build_record *OldRecord = FindBuildRecord(Manifest, OutputPath);
+    b32 IsCurrent = (OldRecord &&
+                     OldRecord->InputCount == 1 &&
+                     OldRecord->Inputs[0].Type == build_input_type_Content &&
+                     OldRecord->Inputs[0].Hash == Hash &&
+                     platform_GetFileInfo(OutputPath).Exists);
+
+    if (IsCurrent)
+    {
+        KeepBuildRecord(Manifest, OldRecord);
+    }
+    else
+    {
+        BeginBuildRecord(Manifest, OutputPath);
+        PushBuildInput(Manifest->CurrentRecord, build_input_type_Content, 0, Hash);
+        WriteFileWithPath(OutputPath, Data, Size);
+        EndBuildRecord(Manifest);
+        Written = 1;
+    }
+
+    return Written;
+}
+
+/* Copy a record into Manifest's arena, names included, so it doesn't depend on the arena it came from. */
+internal build_record *CopyBuildRecord(build_manifest *Manifest, build_record **Records, build_record *SourceRecord)
+{
+    build_record *Record = PushBuildRecord(Manifest, Records, SourceRecord->OutputPath);
+
+    if (Record)
+    {
+        Record->GeneratorHash = SourceRecord->GeneratorHash;
+        Record->InputCount = SourceRecord->InputCount;
+
+        for (s32 I = 0; I < SourceRecord->InputCount; ++I)
+        {
+            Record->Inputs[I] = SourceRecord->Inputs[I];
+
+            if (SourceRecord->Inputs[I].Name)
+            {
+                Record->Inputs[I].Name = PushCString(&Manifest->Arena, SourceRecord->Inputs[I].Name);
+            }
+        }
+    }
+
+    return Record;
+}
+
+/* Move the records built into a separate manifest, e.g. by a job on another thread, into Manifest. */
+internal void MergeBuildRecords(build_manifest *Manifest, build_manifest *Source)
+{
+    for (build_record *SourceRecord = Source->NewRecords; SourceRecord; SourceRecord = SourceRecord->Next)
+    {
+        CopyBuildRecord(Manifest, &Manifest->NewRecords, SourceRecord);
+    }
+
+    Manifest->Changed |= Source->Changed;
+    Manifest->BuiltCount += Source->BuiltCount;
+    Manifest->SkippedCount += Source->SkippedCount;
+}
+
+/*
+  Start another run in the same process, e.g. for watch mode. The records from this run become the
+  old records of the next one. They are copied into a fresh arena, so memory use doesn't grow with
+  the number of runs.
+*/
+internal void RollBuildManifest(build_manifest *Manifest)
+{
+    build_manifest Next = {0};
+    Next.Path = Manifest->Path;
+    Next.Arena = ryn_memory_CreateArena(Manifest->Arena.Capacity);
+    Next.GeneratorHash = Manifest->GeneratorHash;
+
+    Assert(Manifest->CurrentRecord == 0);
+
+    for (build_record *Record = Manifest->NewRecords; Record; Record = Record->Next)
+    {
+        CopyBuildRecord(&Next, &Next.OldRecords, Record);
+    }
+
+    IndexBuildRecords(&Next);
+    ryn_memory_FreeArena(Manifest->Arena);
+    *Manifest = Next;
+}
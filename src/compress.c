@@ -0,0 +1,1035 @@
+/*
+  Precompressed copies of the static site, so that a web server can send "index.html.gz" (or
+  "index.html.br") to clients that accept it instead of compressing every response itself.
+
+  Gzip is written here from scratch: LZ77 over a 32K window with hash chains and lazy matching,
+  followed by one dynamic-Huffman block per DEFLATE_BLOCK_SYMBOLS symbols, falling back to stored
+  blocks for data that does not compress. Brotli is only written if libbrotlienc can be loaded at
+  run-time, we don't link against it or vendor it.
+
+  Every file is compressed by its own job. The inputs of each compressed file are recorded in a
+  separate build manifest, so files that have the same content as last time are skipped.
+*/
+
+#define DEFLATE_WINDOW_SIZE 32768
+#define DEFLATE_WINDOW_MASK (DEFLATE_WINDOW_SIZE - 1)
+#define DEFLATE_HASH_BITS 15
+#define DEFLATE_HASH_SIZE (1 << DEFLATE_HASH_BITS)
+#define DEFLATE_MIN_MATCH 3
+#define DEFLATE_MAX_MATCH 258
+#define DEFLATE_MAX_CHAIN 128
+#define DEFLATE_GOOD_MATCH 32 /* NOTE: Don't bother looking for a lazy match if we already have one this long. */
+#define DEFLATE_FAR_MATCH 4096 /* NOTE: Matches of DEFLATE_MIN_MATCH further away than this cost more than literals. */
+#define DEFLATE_BLOCK_SYMBOLS 16384
+#define DEFLATE_STORED_MAX 65535
+#define DEFLATE_MAX_CODE_LENGTH 15
+#define DEFLATE_MAX_CODE_LENGTH_LENGTH 7
+#define DEFLATE_LITERAL_CODE_COUNT 286
+#define DEFLATE_DISTANCE_CODE_COUNT 30
+#define DEFLATE_CODE_LENGTH_CODE_COUNT 19
+#define DEFLATE_END_OF_BLOCK 256
+
+#define GZIP_HEADER_SIZE 10
+#define GZIP_TRAILER_SIZE 8
+
+#define COMPRESS_JOB_MAX 1024
+#define COMPRESS_MANIFEST_PATH "../gen/compress_manifest.txt"
+#define COMPRESS_GENERATOR_VERSION 1 /* NOTE: Bump when the compressed output changes, so every file is compressed again. */
+
+typedef struct
+{
+    u8 *Data;
+    u64 Capacity;
+    u64 Size;
+    u64 Bits;
+    u32 BitCount;
+    b32 Overflow;
+} bit_writer;
+
+typedef struct
+{
+    u16 LengthOrLiteral;
+    u16 Distance; /* NOTE: Zero for literals. */
+} deflate_symbol;
+
+typedef struct
+{
+    u8 Lengths[DEFLATE_LITERAL_CODE_COUNT + 2];
+    u16 Codes[DEFLATE_LITERAL_CODE_COUNT + 2];
+} huffman_code;
+
+typedef int brotli_encoder_compress(int Quality, int WindowBits, int Mode, size InputSize, const u8 *Input,
+                                    size *EncodedSize, u8 *Encoded);
+typedef size brotli_encoder_max_compressed_size(size InputSize);
+
+typedef struct
+{
+    brotli_encoder_compress *Compress;
+    brotli_encoder_max_compressed_size *MaxCompressedSize;
+} brotli_encoder;
+
+typedef struct
+{
+    u8 *InputPath;
+    u8 *GzipPath;
+    u8 *BrotliPath;
+    brotli_encoder *Brotli;
+
+    u64 Hash;
+    u64 Size;
+    u64 ModifiedTime;
+    u64 GzipSize;
+    u64 BrotliSize;
+    b32 Error;
+} compress_job;
+
+global_variable u16 DeflateLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+global_variable u8 DeflateLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+global_variable u16 DeflateDistanceBase[DEFLATE_DISTANCE_CODE_COUNT] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+    4097, 6145, 8193, 12289, 16385, 24577,
+};
+global_variable u8 DeflateDistanceExtra[DEFLATE_DISTANCE_CODE_COUNT] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+global_variable u8 DeflateCodeLengthOrder[DEFLATE_CODE_LENGTH_CODE_COUNT] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+};
+
+/* NOTE: Filled in by InitDeflateTables, which must run before any compression job. */
+global_variable u8 DeflateLengthCode[DEFLATE_MAX_MATCH + 1];
+global_variable u8 DeflateDistanceCodeNear[256];
+global_variable u8 DeflateDistanceCodeFar[256];
+global_variable u32 Crc32Table[256];
+global_variable b32 DeflateTablesReady;
+
+internal void InitDeflateTables(void)
+{
+    if (DeflateTablesReady)
+    {
+        return;
+    }
+
+    for (u32 Code = 0; Code < ArrayCount(DeflateLengthBase); ++Code)
+    {
+        u32 Count = 1 << DeflateLengthExtra[Code];
+
+        for (u32 I = 0; I < Count && DeflateLengthBase[Code] + I <= DEFLATE_MAX_MATCH; ++I)
+        {
+            DeflateLengthCode[DeflateLengthBase[Code] + I] = (u8)Code;
+        }
+    }
+
+    /* NOTE: 258 could also be written as 227 + 31, but the format says to use its own code. */
+    DeflateLengthCode[DEFLATE_MAX_MATCH] = 28;
+
+    for (u32 Code = 0; Code < DEFLATE_DISTANCE_CODE_COUNT; ++Code)
+    {
+        u32 Count = 1 << DeflateDistanceExtra[Code];
+
+        for (u32 I = 0; I < Count; ++I)
+        {
+            u32 Distance = DeflateDistanceBase[Code] + I - 1;
+
+            if (Distance < 256)
+            {
+                DeflateDistanceCodeNear[Distance] = (u8)Code;
+            }
+            else
+            {
+                DeflateDistanceCodeFar[Distance >> 7] = (u8)Code;
+            }
+        }
+    }
+
+    for (u32 I = 0; I < 256; ++I)
+    {
+        u32 Crc = I;
+
+        for (s32 Bit = 0; Bit < 8; ++Bit)
+        {
+            Crc = (Crc & 1) ? (Crc >> 1) ^ 0xedb88320 : Crc >> 1;
+        }
+
+        Crc32Table[I] = Crc;
+    }
+
+    DeflateTablesReady = 1;
+}
+
+internal u32 GetDeflateDistanceCode(u32 Distance)
+{
+    u32 Index = Distance - 1;
+    u32 Code = Index < 256 ? DeflateDistanceCodeNear[Index] : DeflateDistanceCodeFar[Index >> 7];
+    return Code;
+}
+
+internal u32 Crc32(u8 *Data, u64 Size)
+{
+    u32 Crc = 0xffffffff;
+
+    for (u64 I = 0; I < Size; ++I)
+    {
+        Crc = Crc32Table[(Crc ^ Data[I]) & 0xff] ^ (Crc >> 8);
+    }
+
+    return Crc ^ 0xffffffff;
+}
+
+internal void PutByte(bit_writer *Writer, u8 Byte)
+{
+    if (Writer->Size < Writer->Capacity)
+    {
+        Writer->Data[Writer->Size] = Byte;
+        Writer->Size += 1;
+    }
+    else
+    {
+        Writer->Overflow = 1;
+    }
+}
+
+internal void PutBits(bit_writer *Writer, u32 Value, u32 Count)
+{
+    Writer->Bits |= (u64)Value << Writer->BitCount;
+    Writer->BitCount += Count;
+
+    while (Writer->BitCount >= 8)
+    {
+        PutByte(Writer, (u8)Writer->Bits);
+        Writer->Bits >>= 8;
+        Writer->BitCount -= 8;
+    }
+}
+
+internal void FlushBits(bit_writer *Writer)
+{
+    if (Writer->BitCount > 0)
+    {
+        PutByte(Writer, (u8)Writer->Bits);
+    }
+
+    Writer->Bits = 0;
+    Writer->BitCount = 0;
+}
+
+internal void PutU32LittleEndian(bit_writer *Writer, u32 Value)
+{
+    PutByte(Writer, (u8)(Value));
+    PutByte(Writer, (u8)(Value >> 8));
+    PutByte(Writer, (u8)(Value >> 16));
+    PutByte(Writer, (u8)(Value >> 24));
+}
+
+/* Code lengths for the given frequencies, no longer than MaxLength, with at least two codes so the code is complete. */
+internal void BuildHuffmanLengths(u32 *Frequencies, u32 SymbolCount, u32 MaxLength, u8 *Lengths)
+{
+    u16 Symbols[DEFLATE_LITERAL_CODE_COUNT];
+    u32 NodeFrequencies[2 * DEFLATE_LITERAL_CODE_COUNT];
+    u16 Parents[2 * DEFLATE_LITERAL_CODE_COUNT];
+    u16 Depths[2 * DEFLATE_LITERAL_CODE_COUNT];
+    s32 LengthCounts[64] = {0};
+    u32 UsedCount = 0;
+
+    for (u32 I = 0; I < SymbolCount; ++I)
+    {
+        Lengths[I] = 0;
+
+        if (Frequencies[I])
+        {
+            Symbols[UsedCount] = (u16)I;
+            UsedCount += 1;
+        }
+    }
+
+    if (UsedCount < 2)
+    {
+        u32 Used = UsedCount ? Symbols[0] : 0;
+        Lengths[Used] = 1;
+        Lengths[Used == 0 ? 1 : 0] = 1;
+        return;
+    }
+
+    for (u32 I = 1; I < UsedCount; ++I)
+    { /* NOTE: Insertion sort by frequency, there are at most a few hundred symbols. */
+        u16 Symbol = Symbols[I];
+        u32 J = I;
+
+        while (J > 0 && Frequencies[Symbols[J - 1]] > Frequencies[Symbol])
+        {
+            Symbols[J] = Symbols[J - 1];
+            J -= 1;
+        }
+
+        Symbols[J] = Symbol;
+    }
+
+    { /* NOTE: Build the tree with two queues, leaves are sorted and new nodes come out sorted too. */
+        u32 NextLeaf = 0;
+        u32 NextNode = UsedCount;
+        u32 NodeCount = UsedCount;
+
+        for (u32 I = 0; I < UsedCount; ++I)
+        {
+            NodeFrequencies[I] = Frequencies[Symbols[I]];
+        }
+
+        while (NodeCount < 2 * UsedCount - 1)
+        {
+            u32 Children[2];
+
+            for (s32 C = 0; C < 2; ++C)
+            {
+                b32 TakeLeaf = (NextLeaf < UsedCount &&
+                                (NextNode >= NodeCount || NodeFrequencies[NextLeaf] <= NodeFrequencies[NextNode]));
+                Children[C] = TakeLeaf ? NextLeaf++ : NextNode++;
+            }
+
+            NodeFrequencies[NodeCount] = NodeFrequencies[Children[0]] + NodeFrequencies[Children[1]];
+            Parents[Children[0]] = (u16)NodeCount;
+            Parents[Children[1]] = (u16)NodeCount;
+            NodeCount += 1;
+        }
+
+        Depths[NodeCount - 1] = 0;
+
+        for (s32 I = (s32)NodeCount - 2; I >= 0; --I)
+        {
+            Depths[I] = Depths[Parents[I]] + 1;
+        }
+
+        for (u32 I = 0; I < UsedCount; ++I)
+        {
+            LengthCounts[Depths[I] < 63 ? Depths[I] : 63] += 1;
+        }
+    }
+
+    { /* NOTE: Limit the code lengths, moving leaves down until the code is complete again. */
+        u32 Total = 0;
+
+        for (u32 I = MaxLength + 1; I < ArrayCount(LengthCounts); ++I)
+        {
+            LengthCounts[MaxLength] += LengthCounts[I];
+            LengthCounts[I] = 0;
+        }
+
+        for (u32 I = MaxLength; I > 0; --I)
+        {
+            Total += (u32)LengthCounts[I] << (MaxLength - I);
+        }
+
+        while (Total != (1u << MaxLength))
+        {
+            LengthCounts[MaxLength] -= 1;
+
+            for (u32 I = MaxLength - 1; I > 0; --I)
+            {
+                if (LengthCounts[I])
+                {
+                    LengthCounts[I] -= 1;
+                    LengthCounts[I + 1] += 2;
+                    break;
+                }
+            }
+
+            Total -= 1;
+        }
+    }
+
+    { /* NOTE: The most frequent symbols get the shortest codes. */
+        u32 Next = UsedCount;
+
+        for (u32 Length = 1; Length <= MaxLength; ++Length)
+        {
+            for (s32 Count = LengthCounts[Length]; Count > 0; --Count)
+            {
+                Next -= 1;
+                Lengths[Symbols[Next]] = (u8)Length;
+            }
+        }
+    }
+}
+
+/* Canonical codes for the given lengths, bit-reversed because deflate writes them starting from the high bit. */
+internal void BuildHuffmanCodes(u8 *Lengths, u32 SymbolCount, u16 *Codes)
+{
+    u32 LengthCounts[DEFLATE_MAX_CODE_LENGTH + 1] = {0};
+    u32 NextCodes[DEFLATE_MAX_CODE_LENGTH + 1] = {0};
+    u32 Code = 0;
+
+    for (u32 I = 0; I < SymbolCount; ++I)
+    {
+        LengthCounts[Lengths[I]] += 1;
+    }
+
+    LengthCounts[0] = 0;
+
+    for (u32 Length = 1; Length <= DEFLATE_MAX_CODE_LENGTH; ++Length)
+    {
+        Code = (Code + LengthCounts[Length - 1]) << 1;
+        NextCodes[Length] = Code;
+    }
+
+    for (u32 I = 0; I < SymbolCount; ++I)
+    {
+        u32 Length = Lengths[I];
+        Codes[I] = 0;
+
+        if (Length)
+        {
+            u32 Value = NextCodes[Length]++;
+            u32 Reversed = 0;
+
+            for (u32 Bit = 0; Bit < Length; ++Bit)
+            {
+                Reversed = (Reversed << 1) | ((Value >> Bit) & 1);
+            }
+
+            Codes[I] = (u16)Reversed;
+        }
+    }
+}
+
+internal void WriteStoredBlocks(bit_writer *Writer, u8 *Data, u64 Size, b32 IsFinal)
+{
+    u64 Offset = 0;
+
+    do
+    {
+        u64 ChunkSize = Size - Offset < DEFLATE_STORED_MAX ? Size - Offset : DEFLATE_STORED_MAX;
+        b32 IsLastChunk = Offset + ChunkSize == Size;
+
+        PutBits(Writer, IsFinal && IsLastChunk, 1);
+        PutBits(Writer, 0, 2);
+        FlushBits(Writer);
+
+        PutByte(Writer, (u8)ChunkSize);
+        PutByte(Writer, (u8)(ChunkSize >> 8));
+        PutByte(Writer, (u8)~ChunkSize);
+        PutByte(Writer, (u8)(~ChunkSize >> 8));
+
+        for (u64 I = 0; I < ChunkSize; ++I)
+        {
+            PutByte(Writer, Data[Offset + I]);
+        }
+
+        Offset += ChunkSize;
+    } while (Offset < Size);
+}
+
+/* Write Symbols, which encode Data[0..Size), as one dynamic-Huffman block, or as stored blocks if that is smaller. */
+internal void WriteDeflateBlock(bit_writer *Writer, deflate_symbol *Symbols, u32 SymbolCount, u8 *Data, u64 Size, b32 IsFinal)
+{
+    u32 LiteralFrequencies[DEFLATE_LITERAL_CODE_COUNT] = {0};
+    u32 DistanceFrequencies[DEFLATE_DISTANCE_CODE_COUNT] = {0};
+    u32 CodeLengthFrequencies[DEFLATE_CODE_LENGTH_CODE_COUNT] = {0};
+    huffman_code Literals;
+    huffman_code Distances;
+    huffman_code CodeLengths;
+    u8 RunSymbols[DEFLATE_LITERAL_CODE_COUNT + DEFLATE_DISTANCE_CODE_COUNT];
+    u8 RunExtras[DEFLATE_LITERAL_CODE_COUNT + DEFLATE_DISTANCE_CODE_COUNT];
+    u8 AllLengths[DEFLATE_LITERAL_CODE_COUNT + DEFLATE_DISTANCE_CODE_COUNT];
+    u32 RunCount = 0;
+    u64 BitCost = 3 + 5 + 5 + 4;
+
+    for (u32 I = 0; I < SymbolCount; ++I)
+    {
+        deflate_symbol Symbol = Symbols[I];
+
+        if (Symbol.Distance)
+        {
+            LiteralFrequencies[257 + DeflateLengthCode[Symbol.LengthOrLiteral]] += 1;
+            DistanceFrequencies[GetDeflateDistanceCode(Symbol.Distance)] += 1;
+        }
+        else
+        {
+            LiteralFrequencies[Symbol.LengthOrLiteral] += 1;
+        }
+    }
+
+    LiteralFrequencies[DEFLATE_END_OF_BLOCK] = 1;
+
+    BuildHuffmanLengths(LiteralFrequencies, DEFLATE_LITERAL_CODE_COUNT, DEFLATE_MAX_CODE_LENGTH, Literals.Lengths);
+    BuildHuffmanLengths(DistanceFrequencies, DEFLATE_DISTANCE_CODE_COUNT, DEFLATE_MAX_CODE_LENGTH, Distances.Lengths);
+    BuildHuffmanCodes(Literals.Lengths, DEFLATE_LITERAL_CODE_COUNT, Literals.Codes);
+    BuildHuffmanCodes(Distances.Lengths, DEFLATE_DISTANCE_CODE_COUNT, Distances.Codes);
+
+    u32 LiteralCount = DEFLATE_LITERAL_CODE_COUNT;
+    u32 DistanceCount = DEFLATE_DISTANCE_CODE_COUNT;
+
+    while (LiteralCount > 257 && Literals.Lengths[LiteralCount - 1] == 0) LiteralCount -= 1;
+    while (DistanceCount > 1 && Distances.Lengths[DistanceCount - 1] == 0) DistanceCount -= 1;
+
+    { /* NOTE: Run-length encode both sets of code lengths together, with codes 16, 17 and 18. */
+        u32 LengthCount = LiteralCount + DistanceCount;
+        core_CopyMemory(Literals.Lengths, AllLengths, LiteralCount);
+        core_CopyMemory(Distances.Lengths, AllLengths + LiteralCount, DistanceCount);
+
+        for (u32 I = 0; I < LengthCount;)
+        {
+            u8 Length = AllLengths[I];
+            u32 Run = 1;
+
+            while (I + Run < LengthCount && AllLengths[I + Run] == Length) Run += 1;
+
+            if (Length == 0 && Run >= 11)
+            {
+                Run = Run > 138 ? 138 : Run;
+                RunSymbols[RunCount] = 18;
+                RunExtras[RunCount++] = (u8)(Run - 11);
+            }
+            else if (Length == 0 && Run >= 3)
+            {
+                RunSymbols[RunCount] = 17;
+                RunExtras[RunCount++] = (u8)(Run - 3);
+            }
+            else if (Length != 0 && Run >= 4)
+            {
+                /* NOTE: Code 16 repeats the previous length, so write the length itself once first. */
+                Run = Run > 7 ? 7 : Run;
+                RunSymbols[RunCount] = Length;
+                RunExtras[RunCount++] = 0;
+                RunSymbols[RunCount] = 16;
+                RunExtras[RunCount++] = (u8)(Run - 4);
+            }
+            else
+            {
+                Run = 1;
+                RunSymbols[RunCount] = Length;
+                RunExtras[RunCount++] = 0;
+            }
+
+            I += Run;
+        }
+
+        for (u32 I = 0; I < RunCount; ++I)
+        {
+            CodeLengthFrequencies[RunSymbols[I]] += 1;
+        }
+    }
+
+    BuildHuffmanLengths(CodeLengthFrequencies, DEFLATE_CODE_LENGTH_CODE_COUNT, DEFLATE_MAX_CODE_LENGTH_LENGTH, CodeLengths.Lengths);
+    BuildHuffmanCodes(CodeLengths.Lengths, DEFLATE_CODE_LENGTH_CODE_COUNT, CodeLengths.Codes);
+
+    u32 CodeLengthCount = DEFLATE_CODE_LENGTH_CODE_COUNT;
+    while (CodeLengthCount > 4 && CodeLengths.Lengths[DeflateCodeLengthOrder[CodeLengthCount - 1]] == 0) CodeLengthCount -= 1;
+
+    { /* NOTE: Add up the size of the block, to compare it against storing the bytes as they are. */
+        u8 RunExtraBits[DEFLATE_CODE_LENGTH_CODE_COUNT] = {[16] = 2, [17] = 3, [18] = 7};
+
+        BitCost += 3 * CodeLengthCount;
+
+        for (u32 I = 0; I < RunCount; ++I)
+        {
+            BitCost += CodeLengths.Lengths[RunSymbols[I]] + RunExtraBits[RunSymbols[I]];
+        }
+
+        for (u32 I = 0; I < DEFLATE_LITERAL_CODE_COUNT; ++I)
+        {
+            u32 ExtraBits = I > DEFLATE_END_OF_BLOCK ? DeflateLengthExtra[I - 257] : 0;
+            BitCost += (u64)LiteralFrequencies[I] * (Literals.Lengths[I] + ExtraBits);
+        }
+
+        for (u32 I = 0; I < DEFLATE_DISTANCE_CODE_COUNT; ++I)
+        {
+            BitCost += (u64)DistanceFrequencies[I] * (Distances.Lengths[I] + DeflateDistanceExtra[I]);
+        }
+    }
+
+    u64 StoredBitCost = (Size + 5 * (Size / DEFLATE_STORED_MAX + 1)) * 8;
+
+    if (StoredBitCost <= BitCost)
+    {
+        WriteStoredBlocks(Writer, Data, Size, IsFinal);
+        return;
+    }
+
+    PutBits(Writer, IsFinal, 1);
+    PutBits(Writer, 2, 2);
+    PutBits(Writer, LiteralCount - 257, 5);
+    PutBits(Writer, DistanceCount - 1, 5);
+    PutBits(Writer, CodeLengthCount - 4, 4);
+
+    for (u32 I = 0; I < CodeLengthCount; ++I)
+    {
+        PutBits(Writer, CodeLengths.Lengths[DeflateCodeLengthOrder[I]], 3);
+    }
+
+    for (u32 I = 0; I < RunCount; ++I)
+    {
+        u8 Symbol = RunSymbols[I];
+        PutBits(Writer, CodeLengths.Codes[Symbol], CodeLengths.Lengths[Symbol]);
+
+        if (Symbol == 16) PutBits(Writer, RunExtras[I], 2);
+        else if (Symbol == 17) PutBits(Writer, RunExtras[I], 3);
+        else if (Symbol == 18) PutBits(Writer, RunExtras[I], 7);
+    }
+
+    for (u32 I = 0; I < SymbolCount; ++I)
+    {
+        deflate_symbol Symbol = Symbols[I];
+
+        if (Symbol.Distance)
+        {
+            u32 LengthCode = DeflateLengthCode[Symbol.LengthOrLiteral];
+            u32 DistanceCode = GetDeflateDistanceCode(Symbol.Distance);
+
+            PutBits(Writer, Literals.Codes[257 + LengthCode], Literals.Lengths[257 + LengthCode]);
+            PutBits(Writer, Symbol.LengthOrLiteral - DeflateLengthBase[LengthCode], DeflateLengthExtra[LengthCode]);
+            PutBits(Writer, Distances.Codes[DistanceCode], Distances.Lengths[DistanceCode]);
+            PutBits(Writer, Symbol.Distance - DeflateDistanceBase[DistanceCode], DeflateDistanceExtra[DistanceCode]);
+        }
+        else
+        {
+            PutBits(Writer, Literals.Codes[Symbol.LengthOrLiteral], Literals.Lengths[Symbol.LengthOrLiteral]);
+        }
+    }
+
+    PutBits(Writer, Literals.Codes[DEFLATE_END_OF_BLOCK], Literals.Lengths[DEFLATE_END_OF_BLOCK]);
+}
+
+internal u32 HashDeflateBytes(u8 *Bytes)
+{
+    u32 Hash = ((u32)Bytes[0] << 10) ^ ((u32)Bytes[1] << 5) ^ (u32)Bytes[2];
+    return Hash & (DEFLATE_HASH_SIZE - 1);
+}
+
+internal u32 FindDeflateMatch(u8 *Data, u64 Size, u64 Position, s32 *Head, s32 *Previous, u32 *MatchDistance)
+{
+    u32 BestLength = 0;
+
+    if (Position + DEFLATE_MIN_MATCH > Size)
+    {
+        return BestLength;
+    }
+
+    u32 MaxLength = Size - Position < DEFLATE_MAX_MATCH ? (u32)(Size - Position) : DEFLATE_MAX_MATCH;
+    s32 Candidate = Head[HashDeflateBytes(Data + Position)];
+    u8 *Current = Data + Position;
+
+    for (s32 Chain = 0; Chain < DEFLATE_MAX_CHAIN && Candidate >= 0; ++Chain)
+    {
+        u64 Distance = Position - (u64)Candidate;
+
+        if (Distance > DEFLATE_WINDOW_SIZE)
+        {
+            break;
+        }
+
+        u8 *Match = Data + Candidate;
+
+        if (Match[BestLength] == Current[BestLength] && Match[0] == Current[0])
+        {
+            u32 Length = 0;
+            while (Length < MaxLength && Match[Length] == Current[Length]) Length += 1;
+
+            if (Length > BestLength)
+            {
+                BestLength = Length;
+                *MatchDistance = (u32)Distance;
+
+                if (Length == MaxLength)
+                {
+                    break;
+                }
+            }
+        }
+
+        s32 Next = Previous[Candidate & DEFLATE_WINDOW_MASK];
+
+        if (Next >= Candidate)
+        {
+            break;
+        }
+
+        Candidate = Next;
+    }
+
+    if (BestLength == DEFLATE_MIN_MATCH && *MatchDistance > DEFLATE_FAR_MATCH)
+    {
+        BestLength = 0;
+    }
+
+    return BestLength < DEFLATE_MIN_MATCH ? 0 : BestLength;
+}
+
+/* The worst case for GzipCompress, every byte stored. */
+internal u64 GzipCompressCapacity(u64 Size)
+{
+    /* NOTE: Every block but the last covers at least DEFLATE_BLOCK_SYMBOLS bytes, and stored blocks are split
+       every DEFLATE_STORED_MAX bytes. Each one costs a 5 byte header, plus a little slack for the bit padding. */
+    u64 BlockCount = Size / DEFLATE_BLOCK_SYMBOLS + Size / DEFLATE_STORED_MAX + 2;
+    u64 Capacity = GZIP_HEADER_SIZE + GZIP_TRAILER_SIZE + Size + 8 * BlockCount + 64;
+    return Capacity;
+}
+
+/* Gzip Data into the arena. Returns a zero-size buffer if the arena is too small. */
+internal buffer GzipCompress(ryn_memory_arena *Arena, u8 *Data, u64 Size)
+{
+    buffer Result = {0};
+    u64 ArenaOffset = Arena->Offset;
+
+    s32 *Head = ryn_memory_PushSize(Arena, DEFLATE_HASH_SIZE * sizeof(s32));
+    s32 *Previous = ryn_memory_PushSize(Arena, DEFLATE_WINDOW_SIZE * sizeof(s32));
+    deflate_symbol *Symbols = ryn_memory_PushSize(Arena, DEFLATE_BLOCK_SYMBOLS * sizeof(deflate_symbol));
+    u64 Capacity = GzipCompressCapacity(Size);
+    u8 *Output = ryn_memory_PushSize(Arena, Capacity);
+
+    if (!Head || !Previous || !Symbols || !Output)
+    {
+        LogError("allocating gzip buffers");
+        Arena->Offset = ArenaOffset;
+        return Result;
+    }
+
+    SetMemory((u8 *)Head, 0xff, DEFLATE_HASH_SIZE * sizeof(s32));
+
+    bit_writer Writer = {0};
+    Writer.Data = Output;
+    Writer.Capacity = Capacity;
+
+    { /* NOTE: Header, with no file name and a zero modified-time so the output only depends on the input. */
+        u8 Header[GZIP_HEADER_SIZE] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+
+        for (u32 I = 0; I < GZIP_HEADER_SIZE; ++I)
+        {
+            PutByte(&Writer, Header[I]);
+        }
+    }
+
+    u64 Position = 0;
+    u64 Inserted = 0;
+    u64 BlockStart = 0;
+    u32 SymbolCount = 0;
+    u32 PendingLength = 0;
+    u32 PendingDistance = 0;
+    b32 HasPending = 0;
+
+    while (Position < Size)
+    {
+        u32 Length = 0;
+        u32 Distance = 0;
+
+        for (; Inserted < Position && Inserted + DEFLATE_MIN_MATCH <= Size; ++Inserted)
+        {
+            u32 Hash = HashDeflateBytes(Data + Inserted);
+            Previous[Inserted & DEFLATE_WINDOW_MASK] = Head[Hash];
+            Head[Hash] = (s32)Inserted;
+        }
+
+        if (HasPending)
+        {
+            Length = PendingLength;
+            Distance = PendingDistance;
+            HasPending = 0;
+        }
+        else
+        {
+            Length = FindDeflateMatch(Data, Size, Position, Head, Previous, &Distance);
+        }
+
+        if (Length && Length < DEFLATE_GOOD_MATCH && Position + 1 < Size)
+        { /* NOTE: Lazy matching, if the next byte starts a longer match then this byte is better off as a literal. */
+            for (; Inserted < Position + 1 && Inserted + DEFLATE_MIN_MATCH <= Size; ++Inserted)
+            {
+                u32 Hash = HashDeflateBytes(Data + Inserted);
+                Previous[Inserted & DEFLATE_WINDOW_MASK] = Head[Hash];
+                Head[Hash] = (s32)Inserted;
+            }
+
+            PendingLength = FindDeflateMatch(Data, Size, Position + 1, Head, Previous, &PendingDistance);
+
+            if (PendingLength > Length)
+            {
+                Length = 0;
+                HasPending = 1;
+            }
+        }
+
+        if (Length)
+        {
+            Symbols[SymbolCount].LengthOrLiteral = (u16)Length;
+            Symbols[SymbolCount].Distance = (u16)Distance;
+            Position += Length;
+        }
+        else
+        {
+            Symbols[SymbolCount].LengthOrLiteral = Data[Position];
+            Symbols[SymbolCount].Distance = 0;
+            Position += 1;
+        }
+
+        SymbolCount += 1;
+
+        if (SymbolCount == DEFLATE_BLOCK_SYMBOLS && Position < Size)
+        {
+            WriteDeflateBlock(&Writer, Symbols, SymbolCount, Data + BlockStart, Position - BlockStart, 0);
+            BlockStart = Position;
+            SymbolCount = 0;
+        }
+    }
+
+    WriteDeflateBlock(&Writer, Symbols, SymbolCount, Data + BlockStart, Size - BlockStart, 1);
+    FlushBits(&Writer);
+
+    PutU32LittleEndian(&Writer, Crc32(Data, Size));
+    PutU32LittleEndian(&Writer, (u32)Size);
+
+    if (Writer.Overflow)
+    {
+        LogError("gzip output overflowed its buffer");
+        Arena->Offset = ArenaOffset;
+        return Result;
+    }
+
+    /* NOTE: Move the output down over the match tables, so they don't stay allocated. */
+    u8 *Destination = Arena->Data + ArenaOffset;
+    memmove(Destination, Output, Writer.Size);
+    Arena->Offset = ArenaOffset + Writer.Size;
+
+    Result.Data = Destination;
+    Result.Size = (s32)Writer.Size;
+
+    return Result;
+}
+
+/* NOTE: Arguments to BrotliEncoderCompress, see brotli/encode.h. Static files are compressed once, so use the best quality. */
+#define BROTLI_QUALITY 11     /* NOTE: BROTLI_MAX_QUALITY */
+#define BROTLI_WINDOW_BITS 22 /* NOTE: BROTLI_DEFAULT_WINDOW, a 4MB window */
+#define BROTLI_MODE_GENERIC 0 /* NOTE: BROTLI_MODE_GENERIC, the text and font modes don't fit wasm */
+
+/* Look for libbrotlienc, returns 0 if it isn't installed. */
+internal brotli_encoder *LoadBrotliEncoder(brotli_encoder *Encoder)
+{
+    char *LibraryNames[] = {
+        "libbrotlienc.dylib",
+        "/opt/homebrew/lib/libbrotlienc.dylib",
+        "/usr/local/lib/libbrotlienc.dylib",
+        "libbrotlienc.so.1",
+        "libbrotlienc.so",
+    };
+    brotli_encoder *Result = 0;
+
+    for (u32 I = 0; I < ArrayCount(LibraryNames) && !Result; ++I)
+    {
+        void *Library = platform_LoadLibrary((u8 *)LibraryNames[I]);
+
+        if (Library)
+        {
+            Encoder->Compress = (brotli_encoder_compress *)platform_GetLibraryProc(Library, (u8 *)"BrotliEncoderCompress");
+            Encoder->MaxCompressedSize = (brotli_encoder_max_compressed_size *)platform_GetLibraryProc(Library, (u8 *)"BrotliEncoderMaxCompressedSize");
+
+            if (Encoder->Compress && Encoder->MaxCompressedSize)
+            {
+                Result = Encoder;
+            }
+        }
+    }
+
+    return Result;
+}
+
+internal b32 IsCompressedSiteFile(u8 *Path)
+{
+    char *Extensions[] = {".html", ".css", ".js", ".wasm"};
+    b32 Result = 0;
+    s32 PathLength = GetStringLength(Path);
+
+    for (u32 I = 0; I < ArrayCount(Extensions); ++I)
+    {
+        s32 ExtensionLength = GetStringLength((u8 *)Extensions[I]);
+
+        if (PathLength > ExtensionLength && StringsEqual(Path + PathLength - ExtensionLength, (u8 *)Extensions[I]))
+        {
+            Result = 1;
+            break;
+        }
+    }
+
+    return Result;
+}
+
+internal void CompressSiteFileJob(void *Data, s32 WorkerIndex)
+{
+    compress_job *Job = Data;
+    file_info FileInfo = platform_GetFileInfo(Job->InputPath);
+    ryn_memory_arena Arena = ryn_memory_CreateArena(GzipCompressCapacity(FileInfo.Size) + FileInfo.Size + Megabytes(1));
+
+    if (!Arena.Data)
+    {
+        LogError("allocating compression arena");
+        Job->Error = 1;
+        return;
+    }
+
+    u8 *Source = ryn_memory_GetArenaWriteLocation(&Arena);
+    u64 FileSize = ReadFileIntoAllocator(&Arena, Job->InputPath);
+    u64 SourceSize = FileSize ? FileSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator. */
+
+    Job->Hash = HashBytes(Source, SourceSize);
+    Job->Size = FileInfo.Size;
+    Job->ModifiedTime = FileInfo.ModifiedTime;
+
+    if (!FileSize || SourceSize != FileInfo.Size)
+    {
+        printf("Error in CompressSiteFileJob: reading \"%s\"\n", Job->InputPath);
+        Job->Error = 1;
+    }
+    else
+    {
+        buffer Gzip = GzipCompress(&Arena, Source, SourceSize);
+
+        if (Gzip.Data)
+        {
+            WriteFileWithPath(Job->GzipPath, Gzip.Data, Gzip.Size);
+            Job->GzipSize = Gzip.Size;
+        }
+        else
+        {
+            Job->Error = 1;
+        }
+
+        if (Job->Brotli)
+        {
+            brotli_encoder *Brotli = Job->Brotli;
+            size BrotliSize = Brotli->MaxCompressedSize(SourceSize);
+            u8 *BrotliData = AllocateMemory(BrotliSize);
+
+            if (BrotliData && Brotli->Compress(BROTLI_QUALITY, BROTLI_WINDOW_BITS, BROTLI_MODE_GENERIC, SourceSize, Source, &BrotliSize, BrotliData))
+            {
+                WriteFileWithPath(Job->BrotliPath, BrotliData, BrotliSize);
+                Job->BrotliSize = BrotliSize;
+            }
+            else
+            {
+                printf("Error in CompressSiteFileJob: brotli failed for \"%s\"\n", Job->InputPath);
+                Job->Error = 1;
+            }
+
+            FreeMemory(BrotliData);
+        }
+    }
+
+    ryn_memory_FreeArena(Arena);
+}
+
+internal u8 *PushPathWithExtension(ryn_memory_arena *Arena, u8 *Path, u8 *Extension)
+{
+    s32 PathLength = GetStringLength(Path);
+    s32 ExtensionLength = GetStringLength(Extension);
+    u8 *Result = ryn_memory_PushSize(Arena, PathLength + ExtensionLength + 1);
+
+    if (Result)
+    {
+        core_CopyMemory(Path, Result, PathLength);
+        core_CopyMemory(Extension, Result + PathLength, ExtensionLength);
+        Result[PathLength + ExtensionLength] = 0;
+    }
+
+    return Result;
+}
+
+/* Write a .gz (and .br, if brotli is available) next to every html, css, js and wasm file under SiteDirectory. */
+internal void CompressSite(u8 *SiteDirectory)
+{
+    ryn_memory_arena Arena = ryn_memory_CreateArena(Megabytes(64));
+    u64 GeneratorVersion = COMPRESS_GENERATOR_VERSION;
+    build_manifest Manifest = LoadBuildManifest((u8 *)COMPRESS_MANIFEST_PATH, HashBytes((u8 *)&GeneratorVersion, sizeof(GeneratorVersion)));
+    brotli_encoder BrotliEncoder = {0};
+    brotli_encoder *Brotli = LoadBrotliEncoder(&BrotliEncoder);
+    compress_job *Jobs = ryn_memory_PushSize(&Arena, COMPRESS_JOB_MAX * sizeof(compress_job));
+    s32 JobCount = 0;
+    u64 InputSize = 0;
+    u64 GzipSize = 0;
+    u64 BrotliSize = 0;
+
+    if (!Jobs)
+    {
+        LogError("allocating compression jobs");
+        ryn_memory_FreeArena(Arena);
+        return;
+    }
+
+    InitDeflateTables();
+    job_system *JobSystem = CreateJobSystem(0);
+
+    for (file_list *File = WalkDirectory(&Arena, SiteDirectory); File; File = File->Next)
+    {
+        u8 *InputPath = File->Name.Bytes;
+
+        if (!IsCompressedSiteFile(InputPath))
+        {
+            continue;
+        }
+
+        u8 *GzipPath = PushPathWithExtension(&Arena, InputPath, (u8 *)".gz");
+        u8 *BrotliPath = PushPathWithExtension(&Arena, InputPath, (u8 *)".br");
+        build_record *OldRecord = FindBuildRecord(&Manifest, GzipPath);
+        b32 IsCurrent = OldRecord && (!Brotli || platform_GetFileInfo(BrotliPath).Exists) && platform_GetFileInfo(GzipPath).Exists;
+
+        for (s32 I = 0; IsCurrent && I < OldRecord->InputCount; ++I)
+        {
+            build_input *Input = &OldRecord->Inputs[I];
+            IsCurrent = Input->Type == build_input_type_File && IsFileInputCurrent(&Manifest, Input);
+        }
+
+        if (IsCurrent)
+        {
+            KeepBuildRecord(&Manifest, OldRecord);
+        }
+        else if (JobCount >= COMPRESS_JOB_MAX)
+        {
+            printf("Error in CompressSite: too many files to compress, skipping \"%s\"\n", InputPath);
+        }
+        else
+        {
+            compress_job *Job = &Jobs[JobCount];
+            SetMemory((u8 *)Job, 0, sizeof(compress_job));
+            Job->InputPath = InputPath;
+            Job->GzipPath = GzipPath;
+            Job->BrotliPath = BrotliPath;
+            Job->Brotli = Brotli;
+
+            PushJob(JobSystem, CompressSiteFileJob, Job);
+            JobCount += 1;
+        }
+    }
+
+    RunJobs(JobSystem);
+
+    for (s32 I = 0; I < JobCount; ++I)
+    {
+        compress_job *Job = &Jobs[I];
+
+        if (!Job->Error)
+        {
+            BeginBuildRecord(&Manifest, Job->GzipPath);
+            AddBuildFileInputHash(&Manifest, Job->InputPath, Job->Hash, Job->Size, Job->ModifiedTime);
+            EndBuildRecord(&Manifest);
+        }
+
+        InputSize += Job->Size;
+        GzipSize += Job->GzipSize;
+        BrotliSize += Job->BrotliSize;
+    }
+
+    WriteBuildManifest(&Manifest);
+
+    printf("Compressed %d files, %llu bytes into %llu gzip bytes", Manifest.BuiltCount,
+           (unsigned long long)InputSize, (unsigned long long)GzipSize);
+
+    if (Brotli)
+    {
+        printf(" and %llu brotli bytes", (unsigned long long)BrotliSize);
+    }
+
+    printf(", up-to-date %d\n", Manifest.SkippedCount);
+
+    FreeJobSystem(JobSystem);
+    ryn_memory_FreeArena(Manifest.Arena);
+    ryn_memory_FreeArena(Arena);
+}
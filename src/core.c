@@ -109,3 +109,48 @@ s32 GetStringLength(u8 *String)
     while (String && String[++StringLength]);
     return StringLength;
 }
+
+u64 HashBytes(u8 *Bytes, u64 Size)
+{
+    /* NOTE: 64-bit FNV-1a, good enough for detecting changed file contents. */
+    u64 Hash = 0xcbf29ce484222325;
+
+    for (u64 I = 0; I < Size; ++I)
+    {
+        Hash ^= Bytes[I];
+        Hash *= 0x100000001b3;
+    }
+
+    return Hash;
+}
+
+/* NOTE: Integers in file formats, read a byte at a time so they don't need to be aligned. */
+internal u16 ReadU16LE(u8 *Data)
+{
+    u16 Result = (u16)(Data[0] | (Data[1] << 8));
+    return Result;
+}
+
+internal u32 ReadU32LE(u8 *Data)
+{
+    u32 Result = (u32)Data[0] | ((u32)Data[1] << 8) | ((u32)Data[2] << 16) | ((u32)Data[3] << 24);
+    return Result;
+}
+
+internal u16 ReadU16BE(u8 *Data)
+{
+    u16 Result = (u16)((Data[0] << 8) | Data[1]);
+    return Result;
+}
+
+internal s16 ReadS16BE(u8 *Data)
+{
+    s16 Result = (s16)ReadU16BE(Data);
+    return Result;
+}
+
+internal u32 ReadU32BE(u8 *Data)
+{
+    u32 Result = ((u32)Data[0] << 24) | ((u32)Data[1] << 16) | ((u32)Data[2] << 8) | (u32)Data[3];
+    return Result;
+}
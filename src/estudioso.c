@@ -43,8 +43,8 @@
 #include <emscripten/emscripten.h>
 #endif
 
-#include "../gen/roboto_regular.h"
-#include "../gen/sfx_correct.h"
+#include "asset_pack.h"
+#include "../gen/estudioso_pack.h"
 
 #if 0
 global_variable int Screen_Width = TARGET_SCREEN_WIDTH;
@@ -56,6 +56,7 @@ global_variable int Screen_Height = 600;
 
 #include "math.c"
 #include "raylib_helpers.h"
+#include "asset_loader.c"
 #include "ui.c"
 #include "sound.c"
 
@@ -1362,10 +1363,10 @@ int main(void)
     {
         InitAudioDevice();
 
-        Wave Correct = LoadWaveFromMemory(".wav", SfxCorrectData, sizeof(SfxCorrectData));
-        /* TODO: Generate data for wrong and win, then use LoadWaveFromMemory */
-        Wave Wrong = LoadWave("../assets/sfx_wrong.wav");
-        Wave Win = LoadWave("../assets/sfx_win.wav");
+        asset_pack_header *Pack = GetAssetPack(EstudiosoPack);
+        Wave Correct = LoadPackBankWave(Pack, "estudioso.sfx", "sfx_correct");
+        Wave Wrong = LoadPackBankWave(Pack, "estudioso.sfx", "sfx_wrong");
+        Wave Win = LoadPackBankWave(Pack, "estudioso.sfx", "sfx_win");
 
         if (IsWaveReady(Correct) && IsWaveReady(Wrong) && IsWaveReady(Win))
         {
@@ -1404,40 +1405,14 @@ int main(void)
 #endif
     SetTargetFPS(60);
 
-    int CodepointCount = 0;
-    int *Codepoints = 0;
-
     {
-        /* TODO: Pre-bake font bitmaps? */
-        char *TextWithAllCodepoints = (
-            "abcdefghijklmnopqrstuvwxyz"
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "0123450123456789"
-            "`~!@#$%^&*()-_=+"
-            "[]{}\\|;:'\",.<>/?¿¡"
-            "´˜áéíóúÁÉÍÓÚñÑ");
-
-        Codepoints = LoadCodepoints(TextWithAllCodepoints, &CodepointCount);
-
-#if PLATFORM_WEB
-        /* TODO: Fix loading font-data-files with LoadFontFromMemory for web,
-           somehow it doesn't work anymore :(
-        */
-        State.UI.Font = GetFontDefault();
-#else
-        u32 FontScale = 4;
-        State.UI.Font = LoadFontFromMemory(".ttf", FontData, ArrayCount(FontData), State.UI.FontSize*FontScale, Codepoints, CodepointCount);
-#endif
+        /* NOTE: Baked at 4 times State.UI.FontSize, with the Spanish letters, see assets/estudioso.font. */
+        State.UI.Font = LoadPackBakedFont(GetAssetPack(EstudiosoPack), "estudioso.font");
 
-        if (IsFontReady(State.UI.Font))
-        {
-            UnloadCodepoints(Codepoints);
-        }
-        else
+        if (!IsFontReady(State.UI.Font))
         {
             ShouldClose = 1;
         }
-
     }
 
     SetQuizMode(&State, quiz_mode_Typing);
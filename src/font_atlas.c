@@ -0,0 +1,1007 @@
+/*
+  Fonts baked at build time, described by a ../assets/<name>.font file:
+
+      # Comments start with a hash.
+      font Roboto-Regular.ttf
+      size 32
+      range 32 126
+
+  "range" lines list the codepoints to bake, first and last included, and "size" is the height in
+  pixels from the font's ascender to its descender, like raylib's LoadFontEx. The asset build reads
+  the TrueType file, rasterizes every glyph and packs them into an atlas with the skyline packer
+  from sprite_atlas.c. Asset pack definitions name the .font file to get a baked font entry (see
+  asset_font_glyph), which the game turns into a raylib Font without parsing or rasterizing a TTF.
+
+  Only TrueType outlines (the glyf table) are read, simple and composite glyphs both. Glyphs are
+  rasterized by summing up the signed area each outline edge covers in every pixel, and metrics are
+  rounded the way stb_truetype rounds them, so text lays out the way raylib's TTF loader had it.
+*/
+
+#define FONT_RANGE_MAX 16
+#define FONT_GLYPH_MAX SKYLINE_RECT_MAX
+#define FONT_ATLAS_SIZE_MAX 4096
+#define FONT_OUTLINE_POINT_MAX 4096
+#define FONT_OUTLINE_CONTOUR_MAX 512
+#define FONT_COMPONENT_DEPTH_MAX 8
+#define FONT_CURVE_SEGMENT_MAX 32
+#define FONT_FLATNESS 0.1f /* NOTE: How far, in pixels, a flattened curve may be from the real one. */
+#define FONT_ATLAS_VERSION 1 /* NOTE: Bump when parsing, rasterizing or packing changes, so cached fonts are rebuilt. */
+
+typedef struct
+{
+    u8 FontName[ASSET_PACK_NAME_MAX];
+    u32 Size;
+    u32 Ranges[FONT_RANGE_MAX][2];
+    u32 RangeCount;
+} font_spec;
+
+typedef struct
+{
+    u8 *Data;
+    u64 Size;
+    u32 Glyf, GlyfSize; /* NOTE: Table offsets and sizes in Data. */
+    u32 Loca;
+    u32 Hmtx;
+    u32 CharacterMap, CharacterMapEnd; /* NOTE: The cmap subtable we read, format 4 or 12. */
+    u32 CharacterMapFormat;
+    u32 GlyphCount;
+    u32 HorizontalMetricCount;
+    b32 LongOffsets; /* NOTE: loca has u32 offsets instead of u16 halves. */
+    s32 Ascent;
+    s32 Descent;
+} truetype_font;
+
+typedef struct
+{
+    f32 X, Y;
+    u8 Flags;
+} outline_point;
+
+typedef struct
+{
+    outline_point Points[FONT_OUTLINE_POINT_MAX]; /* NOTE: In font units, y up. */
+    u32 PointCount;
+    u32 ContourEnds[FONT_OUTLINE_CONTOUR_MAX]; /* NOTE: One past the last point of each contour. */
+    u32 ContourCount;
+} glyph_outline;
+
+typedef struct
+{
+    f32 *Area; /* NOTE: The coverage each pixel gets from the edges, summed left to right it's the coverage. */
+    u32 Width;
+    u32 Height;
+    u32 Stride; /* NOTE: Width + 2, edges touching the right side write just past it. */
+} glyph_raster;
+
+internal b32 ParseFontSpec(u8 *Path, u8 *Text, font_spec *Spec)
+{
+    s32 LineNumber = 1;
+    u8 *At = Text;
+
+    while (*At)
+    {
+        u8 Keyword[16] = {0};
+        u8 *LineStart = SkipSpriteSheetSpace(At);
+        u8 *Parsed = LineStart;
+        b32 IsBlank = *LineStart == '#' || *LineStart == '\n' || *LineStart == 0;
+
+        if (!IsBlank)
+        {
+            Parsed = ReadSpriteSheetWord(LineStart, Keyword, sizeof(Keyword));
+        }
+
+        if (IsBlank || !Parsed)
+        {
+            /* NOTE: Comment, blank line, or a keyword too long to be one. */
+        }
+        else if (StringsEqual(Keyword, (u8 *)"font"))
+        {
+            Parsed = ReadSpriteSheetWord(Parsed, Spec->FontName, sizeof(Spec->FontName));
+        }
+        else if (StringsEqual(Keyword, (u8 *)"size"))
+        {
+            Parsed = ReadSpriteSheetNumber(Parsed, &Spec->Size);
+        }
+        else if (StringsEqual(Keyword, (u8 *)"range") && Spec->RangeCount < FONT_RANGE_MAX)
+        {
+            u32 *Range = Spec->Ranges[Spec->RangeCount];
+            Parsed = ReadSpriteSheetNumber(Parsed, &Range[0]);
+            Parsed = Parsed ? ReadSpriteSheetNumber(Parsed, &Range[1]) : 0;
+            Spec->RangeCount += Parsed && Range[0] <= Range[1];
+        }
+        else
+        {
+            Parsed = 0;
+        }
+
+        if (Parsed)
+        {
+            Parsed = SkipSpriteSheetSpace(Parsed);
+        }
+
+        if (!Parsed || (*Parsed != '\n' && *Parsed != '#' && *Parsed != 0))
+        {
+            printf("Error in ParseFontSpec: %s line %d is not understood\n", Path, LineNumber);
+            return 0;
+        }
+
+        while (*At && *At != '\n')
+        {
+            At += 1;
+        }
+
+        if (*At == '\n')
+        {
+            At += 1;
+            LineNumber += 1;
+        }
+    }
+
+    if (!Spec->FontName[0] || !Spec->Size || !Spec->RangeCount)
+    {
+        printf("Error in ParseFontSpec: %s needs a font, a size and at least one range\n", Path);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* Parse the .font file and read the font file it names into Arena. */
+internal b32 ReadFontSpec(ryn_memory_arena *Arena, u8 *Path, u8 *Text, font_spec *Spec, u8 **FontData, u64 *FontSize)
+{
+    u8 FontPath[256];
+
+    if (!ParseFontSpec(Path, Text, Spec))
+    {
+        return 0;
+    }
+
+    snprintf((char *)FontPath, sizeof(FontPath), "../assets/%s", Spec->FontName);
+
+    if (!platform_GetFileInfo(FontPath).Exists)
+    {
+        printf("Error in ReadFontSpec: could not find \"%s\"\n", FontPath);
+        return 0;
+    }
+
+    u64 FontOffset = Arena->Offset;
+    u64 ReadSize = ReadFileIntoAllocator(Arena, FontPath);
+
+    if (!ReadSize)
+    {
+        printf("Error in ReadFontSpec: could not read \"%s\"\n", FontPath);
+        return 0;
+    }
+
+    *FontSize = ReadSize - 1; /* NOTE: Minus 1 for the null-terminator. */
+    *FontData = Arena->Data + FontOffset;
+
+    return 1;
+}
+
+/* NOTE: A baked font depends on its .font file and on the font file that names, this hashes the latter. */
+internal b32 HashFontSpecFont(ryn_memory_arena *Arena, u8 *Path, u8 *Text, u64 *Hash)
+{
+    font_spec Spec = {0};
+    u8 *FontData;
+    u64 FontSize;
+    u64 Offset = Arena->Offset;
+    b32 Read = ReadFontSpec(Arena, Path, Text, &Spec, &FontData, &FontSize);
+
+    if (Read)
+    {
+        *Hash = HashBytes(FontData, FontSize);
+    }
+
+    Arena->Offset = Offset;
+    return Read;
+}
+
+/* Returns the offset of the table called Tag, or 0 if the font doesn't have it. */
+internal u32 FindTrueTypeTable(u8 *Data, u64 Size, char *Tag, u32 *TableSize)
+{
+    u32 TableCount = ReadU16BE(Data + 4);
+
+    for (u32 I = 0; I < TableCount && 12 + 16 * (u64)(I + 1) <= Size; ++I)
+    {
+        u8 *Record = Data + 12 + 16 * I;
+
+        if (Record[0] == Tag[0] && Record[1] == Tag[1] && Record[2] == Tag[2] && Record[3] == Tag[3])
+        {
+            u32 Offset = ReadU32BE(Record + 8);
+            u32 Length = ReadU32BE(Record + 12);
+
+            if (Offset && (u64)Offset + Length <= Size)
+            {
+                *TableSize = Length;
+                return Offset;
+            }
+        }
+    }
+
+    return 0;
+}
+
+internal b32 InitTrueTypeFont(truetype_font *Font, u8 *Data, u64 Size)
+{
+    u32 HeadSize = 0, HheaSize = 0, MaxpSize = 0, CmapSize = 0, LocaSize = 0, HmtxSize = 0;
+
+    SetMemory((u8 *)Font, 0, sizeof(truetype_font));
+    Font->Data = Data;
+    Font->Size = Size;
+
+    /* NOTE: 0x00010000 and "true" have TrueType outlines, "OTTO" fonts have CFF ones, which we don't read. */
+    if (Size < 12 || (ReadU32BE(Data) != 0x00010000 && ReadU32BE(Data) != 0x74727565))
+    {
+        return 0;
+    }
+
+    u32 Head = FindTrueTypeTable(Data, Size, "head", &HeadSize);
+    u32 Hhea = FindTrueTypeTable(Data, Size, "hhea", &HheaSize);
+    u32 Maxp = FindTrueTypeTable(Data, Size, "maxp", &MaxpSize);
+    u32 Cmap = FindTrueTypeTable(Data, Size, "cmap", &CmapSize);
+    Font->Loca = FindTrueTypeTable(Data, Size, "loca", &LocaSize);
+    Font->Glyf = FindTrueTypeTable(Data, Size, "glyf", &Font->GlyfSize);
+    Font->Hmtx = FindTrueTypeTable(Data, Size, "hmtx", &HmtxSize);
+
+    if (!Head || HeadSize < 54 || !Hhea || HheaSize < 36 || !Maxp || MaxpSize < 6 || !Cmap || CmapSize < 4 ||
+        !Font->Loca || !Font->Glyf || !Font->Hmtx)
+    {
+        return 0;
+    }
+
+    Font->LongOffsets = ReadS16BE(Data + Head + 50) != 0;
+    Font->Ascent = ReadS16BE(Data + Hhea + 4);
+    Font->Descent = ReadS16BE(Data + Hhea + 6);
+    Font->HorizontalMetricCount = ReadU16BE(Data + Hhea + 34);
+    Font->GlyphCount = ReadU16BE(Data + Maxp + 4);
+
+    if ((u64)(Font->GlyphCount + 1) * (Font->LongOffsets ? 4 : 2) > LocaSize ||
+        !Font->HorizontalMetricCount || (u64)Font->HorizontalMetricCount * 4 > HmtxSize ||
+        Font->Ascent <= Font->Descent)
+    {
+        return 0;
+    }
+
+    { /* Pick a Unicode character map, format 12 covers everything and format 4 the BMP. */
+        u32 SubtableCount = ReadU16BE(Data + Cmap + 2);
+
+        for (u32 I = 0; I < SubtableCount && 4 + 8 * (I + 1) <= CmapSize; ++I)
+        {
+            u8 *Record = Data + Cmap + 4 + 8 * I;
+            u32 Platform = ReadU16BE(Record);
+            u32 Encoding = ReadU16BE(Record + 2);
+            u32 Offset = ReadU32BE(Record + 4);
+            b32 IsUnicode = Platform == 0 || (Platform == 3 && (Encoding == 1 || Encoding == 10));
+
+            if (!IsUnicode || (u64)Offset + 16 > CmapSize)
+            {
+                continue;
+            }
+
+            u32 Format = ReadU16BE(Data + Cmap + Offset);
+
+            if ((Format == 12 && Font->CharacterMapFormat != 12) || (Format == 4 && !Font->CharacterMapFormat))
+            {
+                Font->CharacterMap = Cmap + Offset;
+                Font->CharacterMapEnd = Cmap + CmapSize;
+                Font->CharacterMapFormat = Format;
+            }
+        }
+    }
+
+    return Font->CharacterMapFormat != 0;
+}
+
+/* NOTE: Codepoints the font doesn't have get glyph 0, the "missing glyph" box, like stb_truetype gives them. */
+internal u32 GetTrueTypeGlyph(truetype_font *Font, u32 Codepoint)
+{
+    u32 Glyph = 0;
+    u8 *Map = Font->Data + Font->CharacterMap;
+    u8 *MapEnd = Font->Data + Font->CharacterMapEnd;
+
+    if (Font->CharacterMapFormat == 4 && Codepoint <= 0xffff)
+    {
+        u32 SegmentCount = ReadU16BE(Map + 6) / 2;
+        u8 *Ends = Map + 14;
+        u8 *Starts = Ends + 2 * SegmentCount + 2;
+        u8 *Deltas = Starts + 2 * SegmentCount;
+        u8 *RangeOffsets = Deltas + 2 * SegmentCount;
+
+        if (RangeOffsets + 2 * SegmentCount > MapEnd)
+        {
+            return 0;
+        }
+
+        for (u32 I = 0; I < SegmentCount; ++I)
+        {
+            if (Codepoint <= ReadU16BE(Ends + 2 * I))
+            {
+                u32 Start = ReadU16BE(Starts + 2 * I);
+                u32 Delta = ReadU16BE(Deltas + 2 * I);
+                u32 RangeOffset = ReadU16BE(RangeOffsets + 2 * I);
+
+                if (Codepoint < Start)
+                {
+                    /* NOTE: Between segments. */
+                }
+                else if (!RangeOffset)
+                {
+                    Glyph = (Codepoint + Delta) & 0xffff;
+                }
+                else
+                {
+                    /* NOTE: The offset is from where it is stored, into the glyph id array after the offsets. */
+                    u8 *GlyphId = RangeOffsets + 2 * I + RangeOffset + 2 * (Codepoint - Start);
+
+                    if (GlyphId + 2 <= MapEnd && ReadU16BE(GlyphId))
+                    {
+                        Glyph = (ReadU16BE(GlyphId) + Delta) & 0xffff;
+                    }
+                }
+
+                break;
+            }
+        }
+    }
+    else if (Font->CharacterMapFormat == 12)
+    {
+        u32 GroupCount = ReadU32BE(Map + 12);
+
+        for (u32 I = 0; I < GroupCount && Map + 16 + 12 * (u64)(I + 1) <= MapEnd; ++I)
+        {
+            u8 *Group = Map + 16 + 12 * I;
+
+            if (Codepoint >= ReadU32BE(Group) && Codepoint <= ReadU32BE(Group + 4))
+            {
+                Glyph = ReadU32BE(Group + 8) + (Codepoint - ReadU32BE(Group));
+                break;
+            }
+        }
+    }
+
+    return Glyph < Font->GlyphCount ? Glyph : 0;
+}
+
+/* Find the glyph's data in the glyf table. Glyphs without an outline, like the space, have Start == End. */
+internal b32 GetTrueTypeGlyphData(truetype_font *Font, u32 Glyph, u32 *Start, u32 *End)
+{
+    u8 *Loca = Font->Data + Font->Loca;
+
+    if (Glyph >= Font->GlyphCount)
+    {
+        return 0;
+    }
+    else if (Font->LongOffsets)
+    {
+        *Start = ReadU32BE(Loca + 4 * Glyph);
+        *End = ReadU32BE(Loca + 4 * Glyph + 4);
+    }
+    else
+    {
+        *Start = 2 * (u32)ReadU16BE(Loca + 2 * Glyph);
+        *End = 2 * (u32)ReadU16BE(Loca + 2 * Glyph + 2);
+    }
+
+    b32 Valid = *Start <= *End && *End <= Font->GlyfSize && (*Start == *End || *End - *Start >= 10);
+    return Valid;
+}
+
+internal s32 GetTrueTypeAdvance(truetype_font *Font, u32 Glyph)
+{
+    u32 Metric = Glyph < Font->HorizontalMetricCount ? Glyph : Font->HorizontalMetricCount - 1;
+    s32 Advance = ReadU16BE(Font->Data + Font->Hmtx + 4 * Metric);
+    return Advance;
+}
+
+/*
+  Append the glyph's points to Outline, transformed by Transform (x' = a*x + c*y + e, y' = b*x + d*y
+  + f, in the order a, b, c, d, e, f). Composite glyphs, like most accented letters, are other
+  glyphs placed with a transform of their own.
+*/
+internal b32 LoadGlyphOutline(truetype_font *Font, u32 Glyph, f32 *Transform, glyph_outline *Outline, u32 Depth)
+{
+    u32 Start, End;
+
+    if (!GetTrueTypeGlyphData(Font, Glyph, &Start, &End))
+    {
+        return 0;
+    }
+    else if (Start == End)
+    {
+        return 1;
+    }
+
+    u8 *At = Font->Data + Font->Glyf + Start;
+    u8 *GlyphEnd = Font->Data + Font->Glyf + End;
+    s32 ContourCount = ReadS16BE(At);
+
+    if (ContourCount >= 0)
+    {
+        u8 *EndPoints = At + 10;
+
+        if (EndPoints + 2 * ContourCount + 2 > GlyphEnd ||
+            Outline->ContourCount + ContourCount > FONT_OUTLINE_CONTOUR_MAX)
+        {
+            return 0;
+        }
+
+        u32 PointCount = ContourCount ? ReadU16BE(EndPoints + 2 * (ContourCount - 1)) + 1 : 0;
+        u32 InstructionSize = ReadU16BE(EndPoints + 2 * ContourCount);
+        outline_point *Points = Outline->Points + Outline->PointCount;
+        At = EndPoints + 2 * ContourCount + 2 + InstructionSize;
+
+        if (Outline->PointCount + PointCount > FONT_OUTLINE_POINT_MAX)
+        {
+            return 0;
+        }
+
+        /* NOTE: A flag with bit 3 set is followed by how many more times it repeats. */
+        for (u32 I = 0; I < PointCount;)
+        {
+            u8 Flags;
+            u32 Repeat = 0;
+
+            if (At >= GlyphEnd)
+            {
+                return 0;
+            }
+
+            Flags = *At++;
+
+            if (Flags & 8)
+            {
+                if (At >= GlyphEnd)
+                {
+                    return 0;
+                }
+
+                Repeat = *At++;
+            }
+
+            for (u32 R = 0; R <= Repeat && I < PointCount; ++R)
+            {
+                Points[I++].Flags = Flags;
+            }
+        }
+
+        /*
+          NOTE: Coordinates are deltas from the previous point, all the x's and then all the y's. A
+          short delta is a byte with the sign in the flags, otherwise the "same" flag means a delta of 0.
+        */
+        for (u32 Axis = 0; Axis < 2; ++Axis)
+        {
+            u8 ShortFlag = Axis ? 4 : 2;
+            u8 SameFlag = Axis ? 32 : 16;
+            s32 Value = 0;
+
+            for (u32 I = 0; I < PointCount; ++I)
+            {
+                u8 Flags = Points[I].Flags;
+
+                if (Flags & ShortFlag)
+                {
+                    if (At + 1 > GlyphEnd)
+                    {
+                        return 0;
+                    }
+
+                    Value += (Flags & SameFlag) ? At[0] : -(s32)At[0];
+                    At += 1;
+                }
+                else if (!(Flags & SameFlag))
+                {
+                    if (At + 2 > GlyphEnd)
+                    {
+                        return 0;
+                    }
+
+                    Value += ReadS16BE(At);
+                    At += 2;
+                }
+
+                if (Axis)
+                {
+                    Points[I].Y = (f32)Value;
+                }
+                else
+                {
+                    Points[I].X = (f32)Value;
+                }
+            }
+        }
+
+        for (u32 I = 0; I < PointCount; ++I)
+        {
+            f32 X = Points[I].X;
+            f32 Y = Points[I].Y;
+            Points[I].X = Transform[0] * X + Transform[2] * Y + Transform[4];
+            Points[I].Y = Transform[1] * X + Transform[3] * Y + Transform[5];
+        }
+
+        for (s32 C = 0; C < ContourCount; ++C)
+        {
+            u32 ContourEnd = ReadU16BE(EndPoints + 2 * C) + 1;
+            u32 ContourStart = C ? ReadU16BE(EndPoints + 2 * (C - 1)) + 1 : 0;
+
+            if (ContourEnd <= ContourStart || ContourEnd > PointCount)
+            {
+                return 0;
+            }
+
+            Outline->ContourEnds[Outline->ContourCount++] = Outline->PointCount + ContourEnd;
+        }
+
+        Outline->PointCount += PointCount;
+    }
+    else
+    {
+        u32 ComponentFlags = 0;
+        At += 10;
+
+        do
+        {
+            f32 A = 1.0f, B = 0.0f, C = 0.0f, D = 1.0f;
+            f32 Dx, Dy;
+
+            if (At + 4 > GlyphEnd)
+            {
+                return 0;
+            }
+
+            ComponentFlags = ReadU16BE(At);
+            u32 Component = ReadU16BE(At + 2);
+            At += 4;
+
+            if (At + ((ComponentFlags & 1) ? 4 : 2) > GlyphEnd)
+            {
+                return 0;
+            }
+            else if (ComponentFlags & 1)
+            {
+                Dx = ReadS16BE(At);
+                Dy = ReadS16BE(At + 2);
+                At += 4;
+            }
+            else
+            {
+                Dx = (s8)At[0];
+                Dy = (s8)At[1];
+                At += 2;
+            }
+
+            /* NOTE: Without bit 1 the arguments are points to line up instead of an offset, nothing we bake uses that. */
+            if (!(ComponentFlags & 2) || Depth == FONT_COMPONENT_DEPTH_MAX)
+            {
+                return 0;
+            }
+
+            /* NOTE: The scales are F2Dot14 fixed point. */
+            if (ComponentFlags & 8)
+            {
+                if (At + 2 > GlyphEnd)
+                {
+                    return 0;
+                }
+
+                A = D = ReadS16BE(At) / 16384.0f;
+                At += 2;
+            }
+            else if (ComponentFlags & 0x40)
+            {
+                if (At + 4 > GlyphEnd)
+                {
+                    return 0;
+                }
+
+                A = ReadS16BE(At) / 16384.0f;
+                D = ReadS16BE(At + 2) / 16384.0f;
+                At += 4;
+            }
+            else if (ComponentFlags & 0x80)
+            {
+                if (At + 8 > GlyphEnd)
+                {
+                    return 0;
+                }
+
+                A = ReadS16BE(At) / 16384.0f;
+                B = ReadS16BE(At + 2) / 16384.0f;
+                C = ReadS16BE(At + 4) / 16384.0f;
+                D = ReadS16BE(At + 6) / 16384.0f;
+                At += 8;
+            }
+
+            /* NOTE: The component's transform first, then ours. */
+            f32 ComponentTransform[6] = {
+                Transform[0] * A + Transform[2] * B,
+                Transform[1] * A + Transform[3] * B,
+                Transform[0] * C + Transform[2] * D,
+                Transform[1] * C + Transform[3] * D,
+                Transform[0] * Dx + Transform[2] * Dy + Transform[4],
+                Transform[1] * Dx + Transform[3] * Dy + Transform[5],
+            };
+
+            if (!LoadGlyphOutline(Font, Component, ComponentTransform, Outline, Depth + 1))
+            {
+                return 0;
+            }
+        } while (ComponentFlags & 0x20);
+    }
+
+    return 1;
+}
+
+/*
+  Add the signed area the edge covers to the pixels it crosses, row by row. Within a row the edge's
+  area splits between the pixels its x range touches, and everything right of it is covered
+  entirely, which the left to right sum in RasterizeGlyph takes care of.
+*/
+internal void RasterizeLine(glyph_raster *Raster, f32 X0, f32 Y0, f32 X1, f32 Y1)
+{
+    f32 Direction = 1.0f;
+
+    if (Y0 == Y1)
+    {
+        return;
+    }
+    else if (Y0 > Y1)
+    {
+        f32 Swap;
+        Swap = X0; X0 = X1; X1 = Swap;
+        Swap = Y0; Y0 = Y1; Y1 = Swap;
+        Direction = -1.0f;
+    }
+
+    f32 Dxdy = (X1 - X0) / (Y1 - Y0);
+    f32 X = X0;
+    s32 RowEnd = (s32)ceilf(Y1);
+    RowEnd = RowEnd < (s32)Raster->Height ? RowEnd : (s32)Raster->Height;
+
+    for (s32 Row = (s32)Y0; Row < RowEnd; ++Row)
+    {
+        f32 *Area = Raster->Area + Row * Raster->Stride;
+        f32 Dy = ((f32)(Row + 1) < Y1 ? (f32)(Row + 1) : Y1) - ((f32)Row > Y0 ? (f32)Row : Y0);
+        f32 XNext = X + Dxdy * Dy;
+        f32 D = Dy * Direction;
+        f32 Left = X < XNext ? X : XNext;
+        f32 Right = X < XNext ? XNext : X;
+        f32 LeftFloor = floorf(Left);
+        f32 RightCeil = ceilf(Right);
+        s32 LeftIndex = (s32)LeftFloor;
+        s32 RightIndex = (s32)RightCeil;
+
+        if (RightIndex <= LeftIndex + 1)
+        {
+            /* NOTE: Within one pixel, split by where the edge is on average. */
+            f32 Middle = 0.5f * (X + XNext) - LeftFloor;
+            Area[LeftIndex] += D - D * Middle;
+            Area[LeftIndex + 1] += D * Middle;
+        }
+        else
+        {
+            f32 InverseWidth = 1.0f / (Right - Left);
+            f32 LeftFraction = Left - LeftFloor;
+            f32 LeftArea = 0.5f * InverseWidth * (1.0f - LeftFraction) * (1.0f - LeftFraction);
+            f32 RightFraction = Right - RightCeil + 1.0f;
+            f32 RightArea = 0.5f * InverseWidth * RightFraction * RightFraction;
+
+            Area[LeftIndex] += D * LeftArea;
+
+            if (RightIndex == LeftIndex + 2)
+            {
+                Area[LeftIndex + 1] += D * (1.0f - LeftArea - RightArea);
+            }
+            else
+            {
+                f32 SecondArea = InverseWidth * (1.5f - LeftFraction);
+                Area[LeftIndex + 1] += D * (SecondArea - LeftArea);
+
+                for (s32 I = LeftIndex + 2; I < RightIndex - 1; ++I)
+                {
+                    Area[I] += D * InverseWidth;
+                }
+
+                f32 LastArea = SecondArea + (f32)(RightIndex - LeftIndex - 3) * InverseWidth;
+                Area[RightIndex - 1] += D * (1.0f - LastArea - RightArea);
+            }
+
+            Area[RightIndex] += D * RightArea;
+        }
+
+        X = XNext;
+    }
+}
+
+/* NOTE: Split into as many lines as it takes to stay within FONT_FLATNESS of the curve. */
+internal void RasterizeQuadratic(glyph_raster *Raster, f32 X0, f32 Y0, f32 X1, f32 Y1, f32 X2, f32 Y2)
+{
+    f32 Ddx = X0 - 2.0f * X1 + X2;
+    f32 Ddy = Y0 - 2.0f * Y1 + Y2;
+    f32 Deviation = sqrtf(Ddx * Ddx + Ddy * Ddy);
+    s32 SegmentCount = (s32)ceilf(sqrtf(Deviation / (8.0f * FONT_FLATNESS)));
+    SegmentCount = SegmentCount < 1 ? 1 : (SegmentCount > FONT_CURVE_SEGMENT_MAX ? FONT_CURVE_SEGMENT_MAX : SegmentCount);
+
+    f32 X = X0;
+    f32 Y = Y0;
+
+    for (s32 I = 1; I <= SegmentCount; ++I)
+    {
+        f32 T = (f32)I / (f32)SegmentCount;
+        f32 U = 1.0f - T;
+        f32 NextX = U * U * X0 + 2.0f * U * T * X1 + T * T * X2;
+        f32 NextY = U * U * Y0 + 2.0f * U * T * Y1 + T * T * Y2;
+        RasterizeLine(Raster, X, Y, NextX, NextY);
+        X = NextX;
+        Y = NextY;
+    }
+}
+
+/*
+  Rasterize the outline into Coverage, a byte per pixel with Pitch bytes to a row. Scale and the
+  offset take font units to pixels, with y flipped to go down.
+*/
+internal void RasterizeGlyph(glyph_raster *Raster, glyph_outline *Outline, f32 Scale, f32 OffsetX, f32 OffsetY,
+                             u8 *Coverage, u32 Pitch)
+{
+    u32 ContourStart = 0;
+
+    SetMemory((u8 *)Raster->Area, 0, Raster->Stride * Raster->Height * sizeof(f32));
+
+    /* NOTE: Take the points to pixels, the bounding box holds them all but rounding can put them just outside it. */
+    for (u32 I = 0; I < Outline->PointCount; ++I)
+    {
+        f32 X = Outline->Points[I].X * Scale - OffsetX;
+        f32 Y = -Outline->Points[I].Y * Scale - OffsetY;
+        Outline->Points[I].X = X < 0.0f ? 0.0f : (X > (f32)Raster->Width ? (f32)Raster->Width : X);
+        Outline->Points[I].Y = Y < 0.0f ? 0.0f : (Y > (f32)Raster->Height ? (f32)Raster->Height : Y);
+    }
+
+    for (u32 C = 0; C < Outline->ContourCount; ++C)
+    {
+        outline_point *Points = Outline->Points + ContourStart;
+        u32 Count = Outline->ContourEnds[C] - ContourStart;
+        u32 FirstOnCurve = 0;
+        ContourStart = Outline->ContourEnds[C];
+
+        while (FirstOnCurve < Count && !(Points[FirstOnCurve].Flags & 1))
+        {
+            FirstOnCurve += 1;
+        }
+
+        /*
+          NOTE: Off-curve points are the controls of quadratic curves between on-curve points, and
+          two off-curve points in a row have an implied on-curve point halfway between them. A
+          contour without any on-curve points starts on such an implied point.
+        */
+        f32 StartX, StartY;
+        u32 Begin, StepCount;
+
+        if (FirstOnCurve < Count)
+        {
+            StartX = Points[FirstOnCurve].X;
+            StartY = Points[FirstOnCurve].Y;
+            Begin = FirstOnCurve + 1;
+            StepCount = Count - 1;
+        }
+        else
+        {
+            StartX = 0.5f * (Points[Count - 1].X + Points[0].X);
+            StartY = 0.5f * (Points[Count - 1].Y + Points[0].Y);
+            Begin = 0;
+            StepCount = Count;
+        }
+
+        f32 X = StartX, Y = StartY;
+        f32 ControlX = 0.0f, ControlY = 0.0f;
+        b32 HasControl = 0;
+
+        for (u32 Step = 0; Step < StepCount; ++Step)
+        {
+            outline_point *Point = &Points[(Begin + Step) % Count];
+
+            if (Point->Flags & 1)
+            {
+                if (HasControl)
+                {
+                    RasterizeQuadratic(Raster, X, Y, ControlX, ControlY, Point->X, Point->Y);
+                }
+                else
+                {
+                    RasterizeLine(Raster, X, Y, Point->X, Point->Y);
+                }
+
+                X = Point->X;
+                Y = Point->Y;
+                HasControl = 0;
+            }
+            else
+            {
+                if (HasControl)
+                {
+                    f32 MiddleX = 0.5f * (ControlX + Point->X);
+                    f32 MiddleY = 0.5f * (ControlY + Point->Y);
+                    RasterizeQuadratic(Raster, X, Y, ControlX, ControlY, MiddleX, MiddleY);
+                    X = MiddleX;
+                    Y = MiddleY;
+                }
+
+                ControlX = Point->X;
+                ControlY = Point->Y;
+                HasControl = 1;
+            }
+        }
+
+        if (HasControl)
+        {
+            RasterizeQuadratic(Raster, X, Y, ControlX, ControlY, StartX, StartY);
+        }
+        else
+        {
+            RasterizeLine(Raster, X, Y, StartX, StartY);
+        }
+    }
+
+    /* NOTE: Overlapping contours add up past full coverage, and opposite windings go negative. */
+    for (u32 Y = 0; Y < Raster->Height; ++Y)
+    {
+        f32 *Area = Raster->Area + Y * Raster->Stride;
+        u8 *Out = Coverage + Y * Pitch;
+        f32 Sum = 0.0f;
+
+        for (u32 X = 0; X < Raster->Width; ++X)
+        {
+            Sum += Area[X];
+            f32 Value = fabsf(Sum);
+            Out[X] = (u8)((Value < 1.0f ? Value : 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
+/*
+  Bake the font a .font file describes. Data gets the baked font entry's data (see
+  asset_font_glyph) and Parameters its parameters. Allocates from Arena.
+*/
+internal b32 BakeFont(ryn_memory_arena *Arena, u8 *Path, u8 *Text, u8 **Data, u64 *DataSize, u32 *Parameters)
+{
+    font_spec Spec = {0};
+    truetype_font Font;
+    u8 *FontData;
+    u64 FontSize;
+    u32 GlyphCount = 0;
+
+    if (!ReadFontSpec(Arena, Path, Text, &Spec, &FontData, &FontSize))
+    {
+        return 0;
+    }
+    else if (!InitTrueTypeFont(&Font, FontData, FontSize))
+    {
+        printf("Error in BakeFont: %s is not a TrueType font we can read\n", Spec.FontName);
+        return 0;
+    }
+
+    for (u32 R = 0; R < Spec.RangeCount; ++R)
+    {
+        GlyphCount += Spec.Ranges[R][1] - Spec.Ranges[R][0] + 1;
+    }
+
+    if (GlyphCount > FONT_GLYPH_MAX)
+    {
+        printf("Error in BakeFont: %s has more than %d glyphs\n", Path, FONT_GLYPH_MAX);
+        return 0;
+    }
+
+    asset_font_glyph Glyphs[FONT_GLYPH_MAX];
+    skyline_rect Rects[FONT_GLYPH_MAX];
+    u32 GlyphIds[FONT_GLYPH_MAX];
+    f32 Scale = (f32)Spec.Size / (f32)(Font.Ascent - Font.Descent);
+    u32 RasterSizeMax = 0;
+    u32 GlyphIndex = 0;
+
+    /* NOTE: Offsets and advances are rounded like stb_truetype's bitmap box and raylib's LoadFontData round them. */
+    for (u32 R = 0; R < Spec.RangeCount; ++R)
+    {
+        for (u32 Codepoint = Spec.Ranges[R][0]; Codepoint <= Spec.Ranges[R][1]; ++Codepoint)
+        {
+            asset_font_glyph *Glyph = &Glyphs[GlyphIndex];
+            u32 GlyphId = GetTrueTypeGlyph(&Font, Codepoint);
+            u32 Start, End;
+            s32 Left = 0, Top = 0, Right = 0, Bottom = 0;
+
+            if (!GetTrueTypeGlyphData(&Font, GlyphId, &Start, &End))
+            {
+                printf("Error in BakeFont: glyph %u of %s is broken\n", GlyphId, Spec.FontName);
+                return 0;
+            }
+            else if (Start != End)
+            {
+                u8 *Header = Font.Data + Font.Glyf + Start;
+                Left = (s32)floorf(ReadS16BE(Header + 2) * Scale);
+                Top = (s32)floorf(-ReadS16BE(Header + 8) * Scale);
+                Right = (s32)ceilf(ReadS16BE(Header + 6) * Scale);
+                Bottom = (s32)ceilf(-ReadS16BE(Header + 4) * Scale);
+            }
+
+            Glyph->Codepoint = (s32)Codepoint;
+            Glyph->OffsetX = Left;
+            Glyph->OffsetY = Top + (s32)(Font.Ascent * Scale);
+            Glyph->AdvanceX = (s32)(GetTrueTypeAdvance(&Font, GlyphId) * Scale);
+            Glyph->Width = Right > Left ? (u32)(Right - Left) : 0;
+            Glyph->Height = Bottom > Top ? (u32)(Bottom - Top) : 0;
+            GlyphIds[GlyphIndex] = GlyphId;
+
+            /* NOTE: Empty glyphs get packed too, so drawing one samples empty atlas pixels. */
+            Rects[GlyphIndex].Width = Glyph->Width + 2 * ASSET_FONT_GLYPH_PADDING;
+            Rects[GlyphIndex].Height = Glyph->Height + 2 * ASSET_FONT_GLYPH_PADDING;
+
+            u32 RasterSize = (Glyph->Width + 2) * Glyph->Height;
+            RasterSizeMax = RasterSize > RasterSizeMax ? RasterSize : RasterSizeMax;
+            GlyphIndex += 1;
+        }
+    }
+
+    u32 AtlasWidth, AtlasHeight;
+
+    if (!PackSkylineAtlas(Rects, GlyphCount, FONT_ATLAS_SIZE_MAX, &AtlasWidth, &AtlasHeight))
+    {
+        printf("Error in BakeFont: the glyphs of %s don't fit in a %dx%d atlas\n", Path, FONT_ATLAS_SIZE_MAX, FONT_ATLAS_SIZE_MAX);
+        return 0;
+    }
+
+    u64 GlyphsSize = GlyphCount * sizeof(asset_font_glyph);
+    u64 AtlasSize = (u64)AtlasWidth * (u64)AtlasHeight;
+    u8 *Baked = ryn_memory_PushSize(Arena, GlyphsSize + AtlasSize);
+    glyph_outline *Outline = ryn_memory_PushSize(Arena, sizeof(glyph_outline));
+    glyph_raster Raster = {0};
+    Raster.Area = ryn_memory_PushSize(Arena, RasterSizeMax * sizeof(f32));
+
+    if (!Baked || !Outline || !Raster.Area)
+    {
+        LogError("allocating baked font");
+        return 0;
+    }
+
+    SetMemory(Baked, 0, GlyphsSize + AtlasSize);
+
+    for (u32 I = 0; I < GlyphCount; ++I)
+    {
+        asset_font_glyph *Glyph = &Glyphs[I];
+        f32 Identity[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+
+        Glyph->X = Rects[I].X + ASSET_FONT_GLYPH_PADDING;
+        Glyph->Y = Rects[I].Y + ASSET_FONT_GLYPH_PADDING;
+
+        if (!Glyph->Width || !Glyph->Height)
+        {
+            continue;
+        }
+
+        Outline->PointCount = 0;
+        Outline->ContourCount = 0;
+
+        if (!LoadGlyphOutline(&Font, GlyphIds[I], Identity, Outline, 0))
+        {
+            printf("Error in BakeFont: could not read the outline of glyph %u in %s\n", GlyphIds[I], Spec.FontName);
+            return 0;
+        }
+
+        Raster.Width = Glyph->Width;
+        Raster.Height = Glyph->Height;
+        Raster.Stride = Glyph->Width + 2;
+
+        /* NOTE: Undo the ascent that OffsetY includes, the outline's origin is on the baseline. */
+        RasterizeGlyph(&Raster, Outline, Scale, (f32)Glyph->OffsetX, (f32)(Glyph->OffsetY - (s32)(Font.Ascent * Scale)),
+                       Baked + GlyphsSize + Glyph->Y * AtlasWidth + Glyph->X, AtlasWidth);
+    }
+
+    core_CopyMemory((u8 *)Glyphs, Baked, GlyphsSize);
+
+    *Data = Baked;
+    *DataSize = GlyphsSize + AtlasSize;
+    Parameters[0] = Spec.Size;
+    Parameters[1] = GlyphCount;
+    Parameters[2] = AtlasWidth;
+    Parameters[3] = AtlasHeight;
+
+    return 1;
+}
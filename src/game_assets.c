@@ -0,0 +1,796 @@
+/*
+  The game asset build, run with "main.out game_assets". Each game gets an asset pack (see
+  asset_pack.h) made from files in ../assets, written to ../gen/<name>.pak along with the headers
+  the game includes to embed it:
+
+      ../gen/<name>_pack.h       embeds the pack with .incbin, or includes the array on the web
+      ../gen/<name>_pack_data.h  the pack as a C array, for emscripten
+
+      ../gen/<sheet>_sprites.h   sprite ids and atlas rectangles, for every .sprites file
+
+  Assets are decoded here rather than in the game, so the game only has to decompress them. Small
+  images aren't even compressed: the game hands their RGBA8 pixels to the GPU without touching them.
+  Images over ASSET_RAW_IMAGE_SIZE_MAX, e.g. sprite atlases baked at 4x, are LZ4 compressed and
+  unpacked once at load, since raw they would bloat the pack and the web build's embedded array.
+  Sprite sheets are packed into atlases before any pack is written (see sprite_atlas.c), .font
+  files are rasterized into glyph atlases (see font_atlas.c), and .sfx files resample their WAVs
+  into one sound bank (see sound_bank.c).
+*/
+
+#define ASSET_PACK_DEFINITION_ASSET_MAX 8
+#define ASSET_PACK_ENTRY_MAX 32
+#define ASSET_JOB_MAX 32
+#define ASSET_JOB_ARENA_SIZE Megabytes(512)
+#define ASSET_CONVERTER_VERSION 2 /* NOTE: Bump when conversion or compression changes, so cached assets are rebuilt. */
+#define ASSET_RAW_IMAGE_SIZE_MAX Kilobytes(512)
+#define GAME_ASSETS_MANIFEST_PATH "../gen/game_assets_manifest.txt"
+#define GAME_ASSETS_GENERATOR_VERSION 2 /* NOTE: Bump when the generated headers or packs change for the same inputs. */
+
+#define BYTE_ARRAY_LINE_BYTES 16
+#define BYTE_ARRAY_BYTE_TEXT_SIZE 5 /* NOTE: "0xNN," */
+#define BYTE_ARRAY_CHUNK_SIZE Megabytes(1)
+#define BYTE_ARRAY_ALIGNMENT 16 /* NOTE: Matches ASSET_PACK_ALIGNMENT, so pack data can be used in place. */
+
+#define LZ4_HASH_BITS 16
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5     /* NOTE: The block has to end with at least this many literals. */
+#define LZ4_MATCH_START_LIMIT 12 /* NOTE: The last match has to start at least this far from the end. */
+#define LZ4_MAX_OFFSET 65535
+
+typedef struct
+{
+    u8 *Name; /* NOTE: Names the files in ../gen. */
+    u8 *SymbolName; /* NOTE: Names the embedded array in the game. */
+    u8 *AssetNames[ASSET_PACK_DEFINITION_ASSET_MAX]; /* NOTE: Files in ../assets, a .sprites file adds its atlases. */
+} asset_pack_definition;
+
+global_variable asset_pack_definition AssetPackDefinitions[] = {
+    {(u8 *)"scuba", (u8 *)"ScubaPack", {(u8 *)"scuba.sprites", (u8 *)"scuba.font"}},
+    {(u8 *)"estudioso", (u8 *)"EstudiosoPack", {(u8 *)"estudioso.font", (u8 *)"estudioso.sfx"}},
+    {(u8 *)"influence", (u8 *)"InfluencePack", {(u8 *)"influence.sprites"}},
+};
+
+typedef struct
+{
+    asset_type Type;
+    u8 *Data;
+    u64 Size;
+    u32 Parameters[4];
+} converted_asset;
+
+/* NOTE: An asset the way a pack stores it. The asset cache keeps these too, so there are no pointers. */
+typedef struct
+{
+    u32 Type;
+    u32 Codec;
+    u64 Size;
+    u64 PackedSize;
+    u32 Parameters[4];
+} packed_asset_info;
+
+typedef struct
+{
+    u8 *Name;
+    packed_asset_info Info;
+    u8 *Data; /* NOTE: PackedSize bytes. */
+} pack_item;
+
+typedef struct
+{
+    u8 *Name;
+    ryn_memory_arena Arena; /* NOTE: Owns the packed data until the packs are written. */
+    pack_item Item;
+    u64 CacheKey;
+    b32 Cached;
+    b32 Converted;
+} asset_job;
+
+internal u64 Lz4CompressCapacity(u64 Size)
+{
+    u64 Capacity = Size + Size / 255 + 16;
+    return Capacity;
+}
+
+internal u8 *Lz4WriteLength(u8 *Out, u64 Length)
+{
+    while (Length >= 255)
+    {
+        *Out++ = 255;
+        Length -= 255;
+    }
+
+    *Out++ = (u8)Length;
+
+    return Out;
+}
+
+internal u8 *Lz4WriteSequence(u8 *Out, u8 *Literals, u64 LiteralLength, u64 Offset, u64 MatchLength)
+{
+    u64 MatchCode = MatchLength ? MatchLength - LZ4_MIN_MATCH : 0;
+    u8 Token = (u8)(((LiteralLength < 15 ? LiteralLength : 15) << 4) | (MatchCode < 15 ? MatchCode : 15));
+
+    *Out++ = Token;
+
+    if (LiteralLength >= 15)
+    {
+        Out = Lz4WriteLength(Out, LiteralLength - 15);
+    }
+
+    core_CopyMemory(Literals, Out, LiteralLength);
+    Out += LiteralLength;
+
+    if (MatchLength)
+    {
+        *Out++ = (u8)(Offset & 0xff);
+        *Out++ = (u8)(Offset >> 8);
+
+        if (MatchCode >= 15)
+        {
+            Out = Lz4WriteLength(Out, MatchCode - 15);
+        }
+    }
+
+    return Out;
+}
+
+/* Greedy LZ4 block compression with a single-entry hash table. Destination must hold Lz4CompressCapacity(Size) bytes. */
+internal u64 Lz4Compress(ryn_memory_arena *Arena, u8 *Source, u64 Size, u8 *Destination)
+{
+    u64 ArenaOffset = Arena->Offset;
+    u32 *Table = ryn_memory_PushSize(Arena, sizeof(u32) << LZ4_HASH_BITS);
+    u8 *Out = Destination;
+    u64 Anchor = 0;
+    u64 I = 0;
+    u64 MatchStartLimit = Size > LZ4_MATCH_START_LIMIT ? Size - LZ4_MATCH_START_LIMIT : 0;
+    u64 MatchEndLimit = Size - LZ4_LAST_LITERALS;
+
+    if (!Table)
+    {
+        return 0;
+    }
+
+    SetMemory((u8 *)Table, 0, sizeof(u32) << LZ4_HASH_BITS);
+
+    while (I < MatchStartLimit)
+    {
+        u32 Sequence = ReadU32LE(Source + I);
+        u32 Hash = (Sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+        u64 Candidate = Table[Hash];
+        Table[Hash] = (u32)I;
+
+        if (Candidate < I && I - Candidate <= LZ4_MAX_OFFSET && ReadU32LE(Source + Candidate) == Sequence)
+        {
+            u64 MatchLength = LZ4_MIN_MATCH;
+
+            while (I + MatchLength < MatchEndLimit && Source[Candidate + MatchLength] == Source[I + MatchLength])
+            {
+                MatchLength += 1;
+            }
+
+            Out = Lz4WriteSequence(Out, Source + Anchor, I - Anchor, I - Candidate, MatchLength);
+            I += MatchLength;
+            Anchor = I;
+        }
+        else
+        {
+            /* NOTE: Step faster through data that isn't matching, like LZ4's acceleration. */
+            I += 1 + ((I - Anchor) >> 6);
+        }
+    }
+
+    Out = Lz4WriteSequence(Out, Source + Anchor, Size - Anchor, 0, 0);
+    Arena->Offset = ArenaOffset;
+
+    return (u64)(Out - Destination);
+}
+
+internal asset_type GetAssetType(u8 *Name)
+{
+    asset_type Type = asset_type_Undefined;
+    s32 Length = GetStringLength(Name);
+    u8 *Extension = Length >= 4 ? Name + Length - 4 : Name;
+
+    if (StringsEqual(Extension, (u8 *)".png"))
+    {
+        Type = asset_type_Image;
+    }
+    else if (StringsEqual(Extension, (u8 *)".wav"))
+    {
+        Type = asset_type_Wave;
+    }
+    else if (StringsEqual(Extension, (u8 *)".ttf"))
+    {
+        Type = asset_type_Font;
+    }
+    else if (HasExtension(Name, ".font"))
+    {
+        Type = asset_type_BakedFont;
+    }
+    else if (HasExtension(Name, ".sfx"))
+    {
+        Type = asset_type_SoundBank;
+    }
+
+    return Type;
+}
+
+/*
+  Decode an asset file, already read into FileData, into the form it is stored in the pack. FileData
+  has to be null-terminated, for the text formats. Allocates from Arena.
+*/
+internal b32 ConvertAsset(ryn_memory_arena *Arena, u8 *Path, u8 *FileData, u64 FileSize, converted_asset *Asset)
+{
+    b32 Converted = 0;
+
+    Asset->Type = GetAssetType(Path);
+
+    switch (Asset->Type)
+    {
+    case asset_type_Image:
+    {
+        s32 Width, Height, ChannelCount;
+        /* NOTE: Always ask for 4 channels, so every image comes out as RGBA8. */
+        u8 *Pixels = stbi_load_from_memory(FileData, (int)FileSize, &Width, &Height, &ChannelCount, 4);
+
+        if (Pixels)
+        {
+            Asset->Size = (u64)Width * (u64)Height * 4;
+            Asset->Data = ryn_memory_PushSize(Arena, Asset->Size);
+
+            if (Asset->Data)
+            {
+                core_CopyMemory(Pixels, Asset->Data, Asset->Size);
+                Asset->Parameters[0] = (u32)Width;
+                Asset->Parameters[1] = (u32)Height;
+                Converted = 1;
+            }
+
+            stbi_image_free(Pixels);
+        }
+    } break;
+    case asset_type_Wave:
+    {
+        wave_file Wave = ParseWaveFile(FileData, FileSize);
+
+        if (Wave.Valid)
+        {
+            u32 FrameSize = Wave.Channels * (Wave.BitsPerSample / 8);
+
+            Asset->Data = Wave.Samples;
+            Asset->Size = Wave.SamplesSize - Wave.SamplesSize % FrameSize;
+            Asset->Parameters[0] = (u32)(Asset->Size / FrameSize);
+            Asset->Parameters[1] = Wave.SampleRate;
+            Asset->Parameters[2] = Wave.BitsPerSample;
+            Asset->Parameters[3] = Wave.Channels;
+            Converted = 1;
+        }
+    } break;
+    case asset_type_Font:
+    {
+        Asset->Data = FileData;
+        Asset->Size = FileSize;
+        Converted = 1;
+    } break;
+    case asset_type_BakedFont:
+    {
+        Converted = BakeFont(Arena, Path, FileData, &Asset->Data, &Asset->Size, Asset->Parameters);
+    } break;
+    case asset_type_SoundBank:
+    {
+        Converted = BuildSoundBank(Arena, Path, FileData, &Asset->Data, &Asset->Size, Asset->Parameters);
+    } break;
+    default:
+        printf("Error in ConvertAsset: unknown asset type for \"%s\"\n", Path);
+        break;
+    }
+
+    return Converted;
+}
+
+/*
+  Sound banks are stored as-is so the game's Waves can point at their samples, and so are images up
+  to ASSET_RAW_IMAGE_SIZE_MAX, so the game can upload them to the GPU straight out of the pack.
+*/
+internal b32 IsAssetStoredRaw(u32 Type, u64 Size)
+{
+    b32 Result = Type == asset_type_SoundBank || (Type == asset_type_Image && Size <= ASSET_RAW_IMAGE_SIZE_MAX);
+    return Result;
+}
+
+/* Point Item at Data, Item->Info.Size bytes, LZ4 compressed unless it's stored raw or compressing doesn't make it smaller. */
+internal b32 SetPackItemData(ryn_memory_arena *Arena, pack_item *Item, u8 *Data)
+{
+    u64 Size = Item->Info.Size;
+    Item->Info.Codec = asset_codec_None;
+    Item->Info.PackedSize = Size;
+    Item->Data = Data;
+
+    if (!IsAssetStoredRaw(Item->Info.Type, Size))
+    {
+        u8 *PackedData = ryn_memory_PushSize(Arena, Lz4CompressCapacity(Size));
+
+        if (!PackedData)
+        {
+            LogError("allocating compressed asset");
+            return 0;
+        }
+
+        u64 PackedSize = Lz4Compress(Arena, Data, Size, PackedData);
+
+        if (PackedSize && PackedSize < Size)
+        {
+            Item->Info.Codec = asset_codec_Lz4;
+            Item->Info.PackedSize = PackedSize;
+            Item->Data = PackedData;
+        }
+    }
+
+    return 1;
+}
+
+internal b32 PackConvertedAsset(ryn_memory_arena *Arena, converted_asset *Asset, pack_item *Item)
+{
+    Item->Info.Type = Asset->Type;
+    Item->Info.Size = Asset->Size;
+    core_CopyMemory((u8 *)Asset->Parameters, (u8 *)Item->Info.Parameters, sizeof(Item->Info.Parameters));
+
+    return SetPackItemData(Arena, Item, Asset->Data);
+}
+
+/*
+  Assets built from a description file also depend on the files it names, and are cached under the
+  name and version of what builds them.
+*/
+internal b32 GetAssetJobCacheKey(ryn_memory_arena *Arena, u8 *Path, u8 *FileData, u64 FileSize, u64 *Key)
+{
+    u64 InputHashes[2] = {HashBytes(FileData, FileSize)};
+    b32 Hashed = 1;
+
+    switch (GetAssetType(Path))
+    {
+    case asset_type_BakedFont:
+    {
+        Hashed = HashFontSpecFont(Arena, Path, FileData, &InputHashes[1]);
+        *Key = GetAssetCacheKey("font", FONT_ATLAS_VERSION, InputHashes, 2);
+    } break;
+    case asset_type_SoundBank:
+    {
+        Hashed = HashSoundBankSounds(Arena, Path, FileData, &InputHashes[1]);
+        *Key = GetAssetCacheKey("sound bank", SOUND_BANK_VERSION, InputHashes, 2);
+    } break;
+    default:
+        *Key = GetAssetCacheKey("asset", ASSET_CONVERTER_VERSION, InputHashes, 1);
+        break;
+    }
+
+    return Hashed;
+}
+
+/* Convert and compress one file from ../assets, or load the result from the asset cache. */
+internal void ConvertAssetJob(void *Data, s32 WorkerIndex)
+{
+    asset_job *Job = Data;
+    ryn_memory_arena *Arena = &Job->Arena;
+    u8 Path[256];
+    snprintf((char *)Path, sizeof(Path), "../assets/%s", Job->Name);
+
+    if (!platform_GetFileInfo(Path).Exists)
+    {
+        printf("Error in ConvertAssetJob: could not find \"%s\"\n", Path);
+        return;
+    }
+
+    *Arena = ryn_memory_CreateArena(ASSET_JOB_ARENA_SIZE);
+
+    if (!Arena->Data)
+    {
+        LogError("allocating asset job arena");
+        return;
+    }
+
+    u64 FileOffset = Arena->Offset;
+    u64 ReadSize = ReadFileIntoAllocator(Arena, Path);
+    u64 FileSize = ReadSize ? ReadSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator. */
+    u8 *FileData = Arena->Data + FileOffset;
+    u64 CachedSize;
+
+    if (!ReadSize)
+    {
+        printf("Error in ConvertAssetJob: could not read \"%s\"\n", Path);
+        return;
+    }
+
+    Job->Item.Name = Job->Name;
+
+    if (!GetAssetJobCacheKey(Arena, Path, FileData, FileSize, &Job->CacheKey))
+    {
+        return;
+    }
+
+    if (ReadAssetCache(Arena, Job->CacheKey, &Job->Item.Info, sizeof(Job->Item.Info), &Job->Item.Data, &CachedSize) &&
+        CachedSize == Job->Item.Info.PackedSize)
+    {
+        Job->Cached = 1;
+        Job->Converted = 1;
+    }
+    else
+    {
+        converted_asset Asset = {0};
+        Job->Converted = (ConvertAsset(Arena, Path, FileData, FileSize, &Asset) &&
+                          PackConvertedAsset(Arena, &Asset, &Job->Item));
+
+        if (Job->Converted)
+        {
+            WriteAssetCache(Job->CacheKey, &Job->Item.Info, sizeof(Job->Item.Info), Job->Item.Data, Job->Item.Info.PackedSize);
+        }
+        else
+        {
+            printf("Error in ConvertAssetJob: could not convert \"%s\"\n", Path);
+        }
+    }
+}
+
+/* Queue a ConvertAssetJob for every file the pack definitions use, once per file. Returns the number of jobs. */
+internal u32 PushAssetJobs(job_system *JobSystem, asset_job *Jobs, u32 JobMax)
+{
+    u32 JobCount = 0;
+
+    for (u32 D = 0; D < ArrayCount(AssetPackDefinitions); ++D)
+    {
+        asset_pack_definition *Definition = &AssetPackDefinitions[D];
+
+        for (u32 I = 0; I < ASSET_PACK_DEFINITION_ASSET_MAX && Definition->AssetNames[I]; ++I)
+        {
+            u8 *Name = Definition->AssetNames[I];
+            b32 IsQueued = HasExtension(Name, ".sprites");
+
+            for (u32 J = 0; !IsQueued && J < JobCount; ++J)
+            {
+                IsQueued = StringsEqual(Jobs[J].Name, Name);
+            }
+
+            if (IsQueued)
+            {
+                continue;
+            }
+            else if (JobCount == JobMax)
+            {
+                printf("Error in PushAssetJobs: more than %u assets\n", JobMax);
+                return JobCount;
+            }
+
+            asset_job *Job = &Jobs[JobCount++];
+            SetMemory((u8 *)Job, 0, sizeof(asset_job));
+            Job->Name = Name;
+            PushJob(JobSystem, ConvertAssetJob, Job);
+        }
+    }
+
+    return JobCount;
+}
+
+/* NOTE: "0xNN," for every byte value, so formatting a byte is a 5 byte copy. */
+global_variable u8 HexByteStrings[256][BYTE_ARRAY_BYTE_TEXT_SIZE];
+global_variable b32 HexByteStringsReady;
+
+internal void SetupHexByteStrings(void)
+{
+    u8 *Digits = (u8 *)"0123456789abcdef";
+
+    for (s32 Byte = 0; Byte < 256; ++Byte)
+    {
+        HexByteStrings[Byte][0] = '0';
+        HexByteStrings[Byte][1] = 'x';
+        HexByteStrings[Byte][2] = Digits[Byte >> 4];
+        HexByteStrings[Byte][3] = Digits[Byte & 0xf];
+        HexByteStrings[Byte][4] = ',';
+    }
+
+    HexByteStringsReady = 1;
+}
+
+/* Write ByteArray as a C array called ByteArrayName, BYTE_ARRAY_LINE_BYTES bytes to a line. The
+   text is built in a BYTE_ARRAY_CHUNK_SIZE buffer that is written out whenever it fills up. */
+internal void GenerateByteArray(ryn_memory_arena *TempArena, u8 *DestinationPath, u8 *ByteArrayName, u8 *ByteArray, size Size)
+{
+    u64 LineTextSize = BYTE_ARRAY_LINE_BYTES * BYTE_ARRAY_BYTE_TEXT_SIZE + 1;
+    file File = platform_OpenFile(DestinationPath);
+
+    if (!File.File)
+    {
+        printf("Error in GenerateByteArray: Destination file not found '%s'\n", DestinationPath);
+        return;
+    }
+
+    if (!HexByteStringsReady)
+    {
+        SetupHexByteStrings();
+    }
+
+    ryn_memory_ArenaStackPush(TempArena);
+
+    u8 *Chunk = ryn_memory_PushSize(TempArena, BYTE_ARRAY_CHUNK_SIZE);
+    u64 ChunkSize = 0;
+
+    if (!Chunk)
+    {
+        LogError("allocating byte array chunk");
+        ryn_memory_ArenaStackPop(TempArena);
+        CloseFile(File);
+        return;
+    }
+
+    ChunkSize += snprintf((char *)Chunk, BYTE_ARRAY_CHUNK_SIZE, "u8 %s[] __attribute__((aligned(%d))) = {\n", ByteArrayName, BYTE_ARRAY_ALIGNMENT);
+
+    for (u64 LineStart = 0; LineStart < Size; LineStart += BYTE_ARRAY_LINE_BYTES)
+    {
+        u64 LineEnd = LineStart + BYTE_ARRAY_LINE_BYTES < Size ? LineStart + BYTE_ARRAY_LINE_BYTES : Size;
+
+        if (ChunkSize + LineTextSize > BYTE_ARRAY_CHUNK_SIZE)
+        {
+            platform_WriteFile(File, Chunk, ChunkSize);
+            ChunkSize = 0;
+        }
+
+        u8 *Out = Chunk + ChunkSize;
+
+        /* NOTE: C allows a trailing comma in an initializer, so the last byte needs no special case. */
+        for (u64 I = LineStart; I < LineEnd; ++I)
+        {
+            memcpy(Out, HexByteStrings[ByteArray[I]], BYTE_ARRAY_BYTE_TEXT_SIZE);
+            Out += BYTE_ARRAY_BYTE_TEXT_SIZE;
+        }
+
+        *Out++ = '\n';
+        ChunkSize = Out - Chunk;
+    }
+
+    u8 *FileEndString = (u8 *)"};\n";
+    u64 FileEndSize = GetStringLength(FileEndString);
+
+    if (ChunkSize + FileEndSize > BYTE_ARRAY_CHUNK_SIZE)
+    {
+        platform_WriteFile(File, Chunk, ChunkSize);
+        ChunkSize = 0;
+    }
+
+    core_CopyMemory(FileEndString, Chunk + ChunkSize, FileEndSize);
+    ChunkSize += FileEndSize;
+    platform_WriteFile(File, Chunk, ChunkSize);
+
+    ryn_memory_ArenaStackPop(TempArena);
+    CloseFile(File);
+}
+
+/* Lay out a pack from the converted assets and write it, skipping files that came out the same as last time. */
+internal void WriteAssetPack(ryn_memory_arena *TempArena, build_manifest *Manifest, asset_pack_definition *Definition,
+                             sprite_sheet_job *SheetJobs, u32 SheetJobCount, asset_job *AssetJobs, u32 AssetJobCount)
+{
+    pack_item Items[ASSET_PACK_ENTRY_MAX] = {0};
+    u32 AssetCount = 0;
+    u64 RawSize = 0;
+
+    ryn_memory_ArenaStackPush(TempArena);
+
+    for (u32 I = 0; I < ASSET_PACK_DEFINITION_ASSET_MAX && Definition->AssetNames[I]; ++I)
+    {
+        u8 *Name = Definition->AssetNames[I];
+
+        if (HasExtension(Name, ".sprites"))
+        {
+            sprite_sheet *Sheet = FindSpriteSheet(SheetJobs, SheetJobCount, Name);
+
+            if (!Sheet || AssetCount + Sheet->ScaleCount > ASSET_PACK_ENTRY_MAX)
+            {
+                printf("Error in WriteAssetPack: no sprite atlases for \"%s\"\n", Name);
+                ryn_memory_ArenaStackPop(TempArena);
+                return;
+            }
+
+            for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+            {
+                sprite_atlas *Atlas = &Sheet->Atlases[S];
+                pack_item *Item = &Items[AssetCount++];
+                Item->Name = Atlas->Name;
+                Item->Info.Type = asset_type_Image;
+                Item->Info.Size = (u64)Atlas->Width * (u64)Atlas->Height * 4;
+                Item->Info.Parameters[0] = Atlas->Width;
+                Item->Info.Parameters[1] = Atlas->Height;
+
+                if (!SetPackItemData(TempArena, Item, Atlas->Pixels))
+                {
+                    ryn_memory_ArenaStackPop(TempArena);
+                    return;
+                }
+            }
+        }
+        else
+        {
+            asset_job *Job = 0;
+
+            for (u32 J = 0; !Job && J < AssetJobCount; ++J)
+            {
+                Job = StringsEqual(AssetJobs[J].Name, Name) ? &AssetJobs[J] : 0;
+            }
+
+            if (!Job || !Job->Converted || GetStringLength(Name) >= ASSET_PACK_NAME_MAX || AssetCount == ASSET_PACK_ENTRY_MAX)
+            {
+                printf("Error in WriteAssetPack: could not add \"%s\" to %s\n", Name, Definition->Name);
+                ryn_memory_ArenaStackPop(TempArena);
+                return;
+            }
+
+            Items[AssetCount++] = Job->Item;
+        }
+    }
+
+    u64 HeaderSize = sizeof(asset_pack_header) + AssetCount * sizeof(asset_pack_entry);
+    u64 PackCapacity = HeaderSize;
+
+    for (u32 I = 0; I < AssetCount; ++I)
+    {
+        RawSize += Items[I].Info.Size;
+        PackCapacity += Items[I].Info.PackedSize + ASSET_PACK_ALIGNMENT;
+    }
+
+    u8 *Pack = ryn_memory_PushSize(TempArena, PackCapacity);
+
+    if (!Pack)
+    {
+        LogError("allocating asset pack");
+        ryn_memory_ArenaStackPop(TempArena);
+        return;
+    }
+
+    SetMemory(Pack, 0, PackCapacity);
+
+    asset_pack_header *Header = (asset_pack_header *)Pack;
+    asset_pack_entry *Entries = (asset_pack_entry *)(Header + 1);
+    u64 Offset = HeaderSize;
+
+    for (u32 I = 0; I < AssetCount; ++I)
+    {
+        asset_pack_entry *Entry = &Entries[I];
+        pack_item *Item = &Items[I];
+
+        Offset = (Offset + ASSET_PACK_ALIGNMENT - 1) & ~(u64)(ASSET_PACK_ALIGNMENT - 1);
+
+        core_CopyMemory(Item->Name, Entry->Name, GetStringLength(Item->Name));
+        Entry->Type = Item->Info.Type;
+        Entry->Codec = Item->Info.Codec;
+        Entry->Offset = Offset;
+        Entry->PackedSize = Item->Info.PackedSize;
+        Entry->Size = Item->Info.Size;
+        core_CopyMemory((u8 *)Item->Info.Parameters, (u8 *)Entry->Parameters, sizeof(Entry->Parameters));
+        core_CopyMemory(Item->Data, Pack + Offset, Item->Info.PackedSize);
+
+        Offset += Entry->PackedSize;
+    }
+
+    Header->Magic = ASSET_PACK_MAGIC;
+    Header->Version = ASSET_PACK_VERSION;
+    Header->EntryCount = AssetCount;
+    Header->Size = Offset;
+
+    u8 PackPath[256], HeaderPath[256], DataHeaderName[256];
+    u8 DataHeaderPath[sizeof("../gen/") + sizeof(DataHeaderName)];
+    b32 PathsFit = (snprintf((char *)PackPath, sizeof(PackPath), "../gen/%s.pak", Definition->Name) < (s32)sizeof(PackPath) &&
+                    snprintf((char *)HeaderPath, sizeof(HeaderPath), "../gen/%s_pack.h", Definition->Name) < (s32)sizeof(HeaderPath) &&
+                    snprintf((char *)DataHeaderName, sizeof(DataHeaderName), "%s_pack_data.h", Definition->Name) < (s32)sizeof(DataHeaderName) &&
+                    snprintf((char *)DataHeaderPath, sizeof(DataHeaderPath), "../gen/%s", DataHeaderName) < (s32)sizeof(DataHeaderPath));
+
+    if (!PathsFit)
+    {
+        printf("Error in WriteAssetPack: the name \"%s\" is too long for a path\n", Definition->Name);
+    }
+    else
+    { /* Write the pack, and the headers that embed it. */
+
+        /* NOTE: The array is only rewritten with the pack, it's slow to compile and the web build depends on it. */
+        if (WriteOutputIfChanged(Manifest, PackPath, Pack, Header->Size) || !platform_GetFileInfo(DataHeaderPath).Exists)
+        {
+            GenerateByteArray(TempArena, DataHeaderPath, Definition->SymbolName, Pack, Header->Size);
+        }
+
+        u8 *HeaderText = ryn_memory_GetArenaWriteLocation(TempArena);
+        u64 HeaderTextOffset = TempArena->Offset;
+        PushString(TempArena, (u8 *)"/* NOTE: Generated by \"main.out game_assets\", don't edit. */\n");
+        PushString(TempArena, (u8 *)"#if defined(PLATFORM_WEB)\n#include \"");
+        PushString(TempArena, DataHeaderName);
+        PushString(TempArena, (u8 *)"\"\n#else\nASSET_PACK_INCBIN(");
+        PushString(TempArena, Definition->SymbolName);
+        PushString(TempArena, (u8 *)", \"gen/");
+        PushString(TempArena, Definition->Name);
+        PushString(TempArena, (u8 *)".pak\");\n#endif\n");
+        WriteOutputIfChanged(Manifest, HeaderPath, HeaderText, TempArena->Offset - HeaderTextOffset);
+
+        printf("Asset pack %s: %u assets, %llu bytes packed from %llu\n", PackPath, AssetCount,
+               (unsigned long long)Header->Size, (unsigned long long)RawSize);
+    }
+
+    ryn_memory_ArenaStackPop(TempArena);
+}
+
+/*
+  Convert every asset and sprite sheet on the job system, then write the packs on the main thread.
+  Conversions come from the asset cache when their inputs haven't changed (see asset_cache.c), and
+  outputs are only written when their contents changed (see WriteOutputIfChanged).
+*/
+internal void GenerateGameAssets(ryn_memory_arena TempString)
+{
+    EnsureDirectoryExists((u8 *)"../gen");
+    EnsureDirectoryExists((u8 *)ASSET_CACHE_DIRECTORY);
+
+    u64 GeneratorVersions[2] = {GAME_ASSETS_GENERATOR_VERSION, ASSET_CONVERTER_VERSION};
+    build_manifest Manifest = LoadBuildManifest((u8 *)GAME_ASSETS_MANIFEST_PATH, HashBytes((u8 *)GeneratorVersions, sizeof(GeneratorVersions)));
+    asset_cache_usage CacheUsage = {0};
+    sprite_sheet_job *SheetJobs = ryn_memory_PushSize(&TempString, SPRITE_SHEET_MAX * sizeof(sprite_sheet_job));
+    asset_job *AssetJobs = ryn_memory_PushSize(&TempString, ASSET_JOB_MAX * sizeof(asset_job));
+
+    if (!SheetJobs || !AssetJobs)
+    {
+        LogError("allocating asset jobs");
+        ryn_memory_FreeArena(Manifest.Arena);
+        return;
+    }
+
+    job_system *JobSystem = CreateJobSystem(0);
+    u32 SheetJobCount = PushSpriteSheetJobs(&TempString, JobSystem, (u8 *)"../assets", SheetJobs, SPRITE_SHEET_MAX);
+    u32 AssetJobCount = PushAssetJobs(JobSystem, AssetJobs, ASSET_JOB_MAX);
+    RunJobs(JobSystem);
+    FreeJobSystem(JobSystem);
+
+    for (u32 I = 0; I < SheetJobCount; ++I)
+    {
+        sprite_sheet_job *Job = &SheetJobs[I];
+        sprite_sheet *Sheet = &Job->Sheet;
+
+        if (Job->Built)
+        {
+            ryn_memory_ArenaStackPush(&TempString);
+            WriteSpriteHeader(&TempString, &Manifest, Sheet);
+            ryn_memory_ArenaStackPop(&TempString);
+            UseAssetCacheKey(&CacheUsage, Job->CacheKey, Job->Cached);
+
+            printf("Sprite sheet %s: %u sprites in a %ux%u atlas, baked at %u scale(s)%s\n", Sheet->Name, Sheet->SpriteCount,
+                   Sheet->AtlasWidth, Sheet->AtlasHeight, Sheet->ScaleCount, Job->Cached ? ", cached" : "");
+        }
+    }
+
+    for (u32 I = 0; I < AssetJobCount; ++I)
+    {
+        if (AssetJobs[I].Converted)
+        {
+            UseAssetCacheKey(&CacheUsage, AssetJobs[I].CacheKey, AssetJobs[I].Cached);
+        }
+    }
+
+    for (u32 I = 0; I < ArrayCount(AssetPackDefinitions); ++I)
+    {
+        WriteAssetPack(&TempString, &Manifest, &AssetPackDefinitions[I], SheetJobs, SheetJobCount, AssetJobs, AssetJobCount);
+    }
+
+    WriteBuildManifest(&Manifest);
+    PruneAssetCache(&TempString, &CacheUsage);
+
+    printf("Game assets: %u converted, %u from the cache, outputs written %d, up-to-date %d\n",
+           CacheUsage.MissCount, CacheUsage.HitCount, Manifest.BuiltCount, Manifest.SkippedCount);
+
+    for (u32 I = 0; I < SheetJobCount; ++I)
+    {
+        if (SheetJobs[I].Arena.Data)
+        {
+            ryn_memory_FreeArena(SheetJobs[I].Arena);
+        }
+    }
+
+    for (u32 I = 0; I < AssetJobCount; ++I)
+    {
+        if (AssetJobs[I].Arena.Data)
+        {
+            ryn_memory_FreeArena(AssetJobs[I].Arena);
+        }
+    }
+
+    ryn_memory_FreeArena(Manifest.Arena);
+}
@@ -0,0 +1,1686 @@
+/*
+  The idi tokenizer: a table-driven C tokenizer. TokenizerTable maps (state, char) to the next state,
+  and a token is finished when the table says Done. Keywords are found with a perfect hash on identifiers.
+
+  SetupTokenizerTable is the readable definition of the tokenizer, but it isn't what runs. The
+  "tokenizer_tables" command of main.out shrinks it into idi_tokenizer_tables.h: chars that every
+  state treats the same way become one class, states that can't be told apart are merged, and the
+  result is a table small enough to stay in L1. The keyword and directive hashes are generated there
+  too. Re-run it whenever SetupTokenizerTable or the keyword lists change.
+
+  This file is shared by idi.c and by the site generator, which uses it to highlight code pages.
+  Both include job_system.c first, for TokenizeParallel.
+*/
+
+/**************************************/
+/* Types/Tables */
+
+#define End_Of_Source_Char 0
+
+#define SingleCharTokenList\
+    X(OpenParenthesis,   OpenParenthesis,   '(')\
+    X(CloseParenthesis,  CloseParenthesis,  ')')\
+    X(OpenBracket,       OpenBracket,       '{')\
+    X(CloseBracket,      CloseBracket,      '}')\
+    X(OpenSquare,        OpenSquare,        '[')\
+    X(CloseSquare,       CloseSquare,       ']')\
+    X(Carrot,            Carrot,            '^')\
+    X(Star,              Star,              '*')\
+    X(Cross,             Cross,             '+')\
+    X(Comma,             Comma,             ',')\
+    X(Colon,             Colon,             ':')\
+    X(Semicolon,         Semicolon,         ';')\
+    X(Ampersand,         Ampersand,         '&')\
+    X(Pipe,              Pipe,              '|')\
+    X(Question,          Question,          '?')\
+    X(Dot,               Dot,               '.')
+
+#define tokenizer_state_Accepting_XList\
+    SingleCharTokenList\
+    X(Space,               Space,               0)\
+    X(Digit,               Digit,               0)\
+    X(BinaryDigitValue,    BinaryDigit,         0)\
+    X(HexDigitValue,       HexDigit,            0)\
+    X(IdentifierStart,     Identifier,          0)\
+    X(IdentifierRest,      Identifier,          0)\
+    X(StringEnd,           String,              0)\
+    X(CharLiteralEnd,      CharLiteral,         0)\
+    X(Directive,           Directive,           0)\
+    X(Equal,               Equal,               0)\
+    X(LessThan,            LessThan,            0)\
+    X(LessThanOrEqual,     LessThanOrEqual,     0)\
+    X(GreaterThan,         GreaterThan,         0)\
+    X(GreaterThanOrEqual,  GreaterThanOrEqual,  0)\
+    X(Not,                 Not,                 0)\
+    X(DoubleEqual,         DoubleEqual,         0)\
+    X(ForwardSlash,        ForwardSlash,        0)\
+    X(BaseDigit,           Digit,               0)\
+    X(NewlineEscape,       NewlineEscape,       0)\
+    X(Arrow,               Arrow,               0)\
+    X(NotEqual,            NotEqual,            0)\
+    X(Comment,             Comment,             0)\
+    X(LineComment,         Comment,             0)\
+    X(Dash,                Dash,                0)\
+    X(Newline,             Newline,             0)
+
+#define tokenizer_state_Simple_Delimited_XList\
+    X(String,       String,       0)\
+    X(CharLiteral,  CharLiteral,  0)
+
+#define tokenizer_state_Delimited_XList\
+    tokenizer_state_Simple_Delimited_XList\
+    X(CommentBody, CommentBody, 0)
+
+#define tokenizer_state_NonError_XList\
+    X(Begin,              Begin,              0)\
+    tokenizer_state_Accepting_XList\
+    tokenizer_state_Delimited_XList\
+    X(StringEscape,       StringEscape,       0)\
+    X(CharLiteralEscape,  CharLiteralEscape,  0)\
+    X(CommentBodyCheck,   CommentBodyCheck,   0)\
+    X(TopLevelEscape,     TopLevelEscape,     0)\
+    X(DirectiveEscape,    DirectiveEscape,    0)\
+    X(Done,               Done,               0)
+
+#define tokenizer_state_XList\
+    X(_Error, _Error, 0)\
+    tokenizer_state_NonError_XList
+
+typedef enum
+{
+#define X(name, _typename, _literal)\
+    tokenizer_state_##name,
+    tokenizer_state_XList
+#undef X
+
+    tokenizer_state__Count
+} tokenizer_state;
+
+typedef enum
+{
+    parser_state__Error,
+    parser_state_Top,
+    parser_state_MacroStart,
+    parser_state_MacroDefinition,
+    parser_state__Count
+} parser_state;
+
+#define NonNewlineSpaceCharList\
+    X(Space,   ' ')\
+    X(Tab,     '\t')\
+    X(Return,  '\r')
+
+#define SpaceCharList\
+    NonNewlineSpaceCharList\
+    X(Newline, '\n')
+
+#define escape_character_XList\
+    X(Alert,              'a')\
+    X(Backspace,          'b')\
+    X(EscapeCharacter,    'e')\
+    X(FormfeedPageBreak,  'f')\
+    X(Newline,            'n')\
+    X(CarriageReturn,     'r')\
+    X(HorizontalTab,      't')\
+    X(VerticalTab,        'v')\
+    X(Backslash,          '\\')\
+    X(Apostrophe,         '\'')\
+    X(Double,             '"')\
+    X(Question,           '?')
+    /* TODO: Add the following features to escape-character xlist. */
+    /* 'nnn'  The byte whose numerical value is given by nnn interpreted as an octal number */
+    /* 'xhh'  The byte whose numerical value is given by hh… interpreted as a hexadecimal number */
+    /* 'u'  Unicode code point below 10000 hexadecimal (added in C99)[1]: 26  */
+    /* 'U'  Unicode code point where h is a hexadecimal digit */
+
+/*
+  Here is a list of keywords recognized by ANSI C89:
+  auto break case char const continue default do double else enum extern
+  float for goto if int long register return short signed sizeof static
+  struct switch typedef union unsigned void volatile while
+
+  ISO C99 adds the following keywords:
+  inline _Bool _Complex _Imaginary
+
+  and GNU extensions add these keywords:
+  __FUNCTION__ __PRETTY_FUNCTION__ __alignof __alignof__ __asm
+  __asm__ __attribute __attribute__ __builtin_offsetof __builtin_va_arg
+  __complex __complex__ __const __extension__ __func__ __imag __imag__
+  __inline __inline__ __label__ __null __real __real__
+  __restrict __restrict__ __signed __signed__ __thread __typeof
+  __volatile __volatile__
+
+  In both ISO C99 and C89 with GNU extensions, the following is also recognized as a keyword:
+  restrict
+*/
+#define Keywords_XList\
+    X(_auto,      Auto,     256)\
+    X(_break,     Break,    257)\
+    X(_case,      Case,     258)\
+    X(_char,      Char,     259)\
+    X(_const,     Const,    260)\
+    X(_continue,  Continue, 261)\
+    X(_default,   Default,  262)\
+    X(_do,        Do,       263)\
+    X(_double,    Double,   264)\
+    X(_else,      Else,     265)\
+    X(_enum,      Enum,     266)\
+    X(_extern,    Extern,   267)\
+    X(_float,     Float,    268)\
+    X(_for,       For,      269)\
+    X(_goto,      Goto,     270)\
+    X(_if,        If,       271)\
+    X(_int,       Int,      272)\
+    X(_long,      Long,     273)\
+    X(_register,  Register, 274)\
+    X(_return,    Return,   275)\
+    X(_short,     Short,    276)\
+    X(_signed,    Signed,   277)\
+    X(_sizeof,    Sizeof,   278)\
+    X(_static,    Static,   279)\
+    X(_struct,    Struct,   280)\
+    X(_switch,    Switch,   281)\
+    X(_typedef,   Typedef,  282)\
+    X(_union,     Union,    283)\
+    X(_unsigned,  Unsigned, 284)\
+    X(_void,      Void,     285)\
+    X(_volatile,  Volatile, 286)\
+    X(_while,     While,    287)
+
+/* Unimplemented preprocessor directives...
+     assert Obsolete Features
+     pragma endregion {tokens}... Pragmas
+     pragma GCC dependency Pragmas
+     pragma GCC error Pragmas
+     pragma GCC poison Pragmas
+     pragma GCC system_header System Headers
+     pragma GCC system_header Pragmas
+     pragma GCC warning Pragmas
+     pragma once Pragmas
+     pragma region {tokens}... Pragmas
+     unassert Obsolete Features
+*/
+#define Directives_XList\
+    X(_define,        Define,       0)\
+    X(_elif,          Elif,         0)\
+    X(_else,          Else,         0)\
+    X(_endif,         Endif,        0)\
+    X(_error,         Error,        0)\
+    X(_ident,         Ident,        0)\
+    X(_if,            If,           0)\
+    X(_ifdef,         Ifdef,        0)\
+    X(_ifndef,        Ifndef,       0)\
+    X(_import,        Import,       0)\
+    X(_include,       Include,      0)\
+    X(_include_next,  IncludeNext,  0)\
+    X(_line,          Line,         0)\
+    X(_sccs,          Sccs,         0)\
+    X(_undef,         Undef,        0)\
+    X(_warning,       Warning,      0)
+
+
+#define token_type_Valid_XList\
+    SingleCharTokenList\
+    Keywords_XList\
+    X(Space,               Space,               288)\
+    X(Digit,               Digit,               289)\
+    X(BinaryDigit,         BinaryDigit,         290)\
+    X(HexDigit,            HexDigit,            291)\
+    X(Identifier,          Identifier,          292)\
+    X(String,              String,              293)\
+    X(CharLiteral,         CharLiteral,         294)\
+    X(Equal,               Equal,               295)\
+    X(DoubleEqual,         DoubleEqual,         296)\
+    X(Comment,             Comment,             297)\
+    X(ForwardSlash,        ForwardSlash,        298)\
+    X(NewlineEscape,       NewlineEscape,       299) /* TODO: delete newline-escape if we aren't going to use it.... */\
+    X(LessThan,            LessThan,            300)\
+    X(LessThanOrEqual,     LessThanOrEqual,     301)\
+    X(GreaterThan,         GreaterThan,         302)\
+    X(GreaterThanOrEqual,  GreaterThanOrEqual,  303)\
+    X(NotEqual,            NotEqual,            304)\
+    X(Arrow,               Arrow,               305)\
+    X(Not,                 Not,                 306)\
+    X(Dash,                Dash,                307)\
+    X(Newline,             Newline,             308)\
+    X(Directive,           Directive,           309)
+
+#define token_type_MaxValue 500 /* TODO: This number can be way less now... */
+
+#define token_type_All_XList\
+    X(_Null, _Null, 0)\
+    token_type_Valid_XList\
+    X(__Error, __Error, token_type_MaxValue)
+
+typedef enum
+{
+#define X(_name, typename, _literal)\
+    token_type_##typename,
+    token_type_All_XList
+#undef X
+    token_type__Count
+} token_type;
+
+typedef enum
+{
+    directive_type__Error,
+#define X(_name, typename, _literal)\
+    directive_type_##typename,
+    Directives_XList
+#undef X
+    directive_type__Count
+} directive_type;
+
+global_variable b32 SingleTokenCharTable[token_type_MaxValue] = {
+#define X(_name, _typename, literal)\
+    [literal] = 1,
+    SingleCharTokenList
+#undef X
+};
+
+typedef struct
+{
+    token_type Type;
+    union
+    {
+        u32 Digit;
+        ryn_string String;
+    };
+} token;
+
+/*
+  The tokens of one source, as parallel arrays: a pass that only looks at types reads two bytes a
+  token, and a token's text is Source.Bytes + Offsets[I] for Sizes[I] bytes.
+*/
+typedef struct
+{
+    u16 *Types; /* NOTE: token_type */
+    u32 *Offsets;
+    u32 *Sizes;
+    u64 Count;
+    ryn_string Source;
+    b32 Error; /* NOTE: Set when tokenizing stopped at a char it couldn't handle. The tokens before that char are kept. */
+    u64 ErrorIndex; /* NOTE: The char it stopped at, when Error is set. */
+} token_stream;
+
+/* NOTE: Where a TokenizeRun stopped, which is enough to pick the tokenizer back up from there. */
+typedef struct
+{
+    u64 Count;
+    u64 Next; /* NOTE: Where the next token starts. */
+    u8 State; /* NOTE: The state the next token starts in. */
+    b32 Finished; /* NOTE: Reached the end of the source or an error, so there is no next token. */
+    u64 ErrorIndex;
+} tokenizer_run;
+
+typedef struct
+{
+    token *FirstToken;
+    token *LastToken;
+
+    ryn_string Source;
+    u64 SourceIndex;
+} tokenizer;
+
+global_variable token_type StateToTypeTable[tokenizer_state__Count] = {
+#define X(name, typename, _literal)\
+    [tokenizer_state_##name] = token_type_##typename,
+    tokenizer_state_Accepting_XList
+#undef X
+};
+
+global_variable tokenizer_state TokenDoneTable[tokenizer_state__Count] = {
+    #define X(name, _typename, _literal)\
+    [tokenizer_state_##name] = tokenizer_state_Begin,
+    tokenizer_state_Accepting_XList
+#undef X
+};
+
+typedef struct
+{
+    u8 CharClass[256];
+    u8 ClassChar[256]; /* NOTE: The first char of each class, which stands in for the whole class. */
+    s32 ClassCount;
+} equivalent_char_result;
+
+#define TOKENIZER_SKIP_RANGE_MAX 4
+
+/* NOTE: A tokenizer table with a column per char class and a row per minimized state. */
+typedef struct
+{
+    equivalent_char_result Chars;
+    u8 StateMap[tokenizer_state__Count]; /* NOTE: The minimized state of each tokenizer_state. */
+    u8 Table[tokenizer_state__Count][256];
+    token_type StateType[tokenizer_state__Count];
+    u8 StateDone[tokenizer_state__Count];
+    u8 SkipRanges[tokenizer_state__Count][TOKENIZER_SKIP_RANGE_MAX][2]; /* NOTE: See FindTokenizerSkipRanges. */
+    u8 SkipRangeCount[tokenizer_state__Count];
+    s32 StateCount;
+} minimized_tokenizer_table;
+
+ref_struct(lookup_node)
+{
+    lookup_node *Child;
+    lookup_node *Sibling;
+    u8 Char;
+    b32 IsTerminal;
+    u32 Type; /* TODO: Consider a more type-safe option here... */
+};
+
+global_variable tokenizer_state AcceptingStates[] = {
+#define X(name, _typename, _literal)\
+    tokenizer_state_##name,
+    tokenizer_state_Accepting_XList
+#undef X
+};
+
+global_variable tokenizer_state DelimitedStates[] = {
+#define X(name, _typename, _literal)\
+    tokenizer_state_##name,
+    tokenizer_state_Delimited_XList
+#undef X
+};
+
+typedef struct
+{
+    char *CString;
+    ryn_string String;
+    u64 Type; /* TODO: u64 so we can store either an enum or a pointer. */
+} keyword;
+
+/* NOTE: A slot of a generated keyword table, see LookupPerfectHash. */
+typedef struct
+{
+    char *Name;
+    u8 Size;
+    u16 Type;
+} perfect_hash_entry;
+
+#define PERFECT_HASH_SIZE_MAX 256
+
+/* NOTE: A perfect hash while it's being searched for, before it's written out as a perfect_hash_entry table. */
+typedef struct
+{
+    u8 Values[256];
+    u8 Slots[PERFECT_HASH_SIZE_MAX]; /* NOTE: One more than the index of the keyword in each slot, 0 for empty slots. */
+    u32 Size;
+} perfect_hash;
+
+
+/**************************************/
+/* Globals */
+
+global_variable u8 TokenizerTable[tokenizer_state__Count][256];
+
+#include "idi_tokenizer_tables.h"
+
+#define Max_Keywords 100 /* TODO: Please get rid of Max_Keywords :( */
+/* From GNU C manual */
+global_variable keyword GlobalHackedUpKeywords[] = {
+#define X(name, typename, _value)\
+    {#name,{},token_type_##typename},
+    Keywords_XList
+#undef X
+};
+
+keyword GlobalKeywordStrings[Max_Keywords] = {};
+
+global_variable keyword GlobalHackedUpDirectives[] = {
+#define X(name, typename, _value)\
+    {#name,{},directive_type_##typename},
+    Directives_XList
+#undef X
+};
+
+/**************************************/
+/* Functions */
+
+internal b32 AddToLookup(ryn_memory_arena *Arena, lookup_node *Lookup, keyword Keyword)
+{
+    b32 KeywordAlreadyExists = 0;
+    ryn_string KeywordString = Keyword.String;
+
+    /* TODO: This control flow for this loop feels off, especially with the mutliple places where we check if we need to set "IsTerminal". */
+    for (u32 StringIndex = 0; StringIndex < KeywordString.Size; ++StringIndex)
+    {
+        u8 Char = KeywordString.Bytes[StringIndex];
+
+        if (Lookup->Char)
+        {
+            for (;;)
+            {
+                if (Lookup->Char == Char)
+                {
+                    if (StringIndex == KeywordString.Size - 1)
+                    {
+                        KeywordAlreadyExists = Lookup->IsTerminal;
+                        Lookup->IsTerminal = 1;
+                    }
+                    else if (Lookup->Child)
+                    {
+                        Lookup = Lookup->Child;
+                    }
+                    else
+                    {
+                        Lookup->Child = ryn_memory_PushZeroStruct(Arena, lookup_node);
+                        Lookup = Lookup->Child;
+                    }
+
+                    break;
+                }
+                else if (Lookup->Sibling == 0)
+                {
+                    Lookup->Sibling = ryn_memory_PushZeroStruct(Arena, lookup_node);
+                    Lookup->Sibling->Char = Char;
+                    Lookup = Lookup->Sibling;
+                    Lookup->Type = Keyword.Type;
+
+                    if (StringIndex == KeywordString.Size - 1)
+                    {
+                        KeywordAlreadyExists = Lookup->IsTerminal;
+                        Lookup->IsTerminal = 1;
+                    }
+
+                    Lookup->Child = ryn_memory_PushZeroStruct(Arena, lookup_node);
+                    Lookup = Lookup->Child;
+                    break;
+                }
+                else
+                {
+                    Lookup = Lookup->Sibling;
+                }
+            }
+        }
+        else
+        {
+            Assert(Lookup->Child == 0);
+            Lookup->Char = Char;
+            Lookup->Type = Keyword.Type;
+
+            if (StringIndex == KeywordString.Size - 1)
+            {
+                KeywordAlreadyExists = Lookup->IsTerminal;
+                Lookup->IsTerminal = 1;
+            }
+
+            Lookup->Child = ryn_memory_PushZeroStruct(Arena, lookup_node);
+            Lookup = Lookup->Child;
+        }
+    }
+
+    return KeywordAlreadyExists;
+}
+
+internal lookup_node *BuildLookup(ryn_memory_arena *Arena, keyword *Keywords, u32 KeywordCount)
+{
+    lookup_node *RootLookup = ryn_memory_PushZeroStruct(Arena, lookup_node);
+
+    for (u32 I = 0; I < KeywordCount; ++I)
+    {
+        GlobalKeywordStrings[I].String = ryn_string_CreateString(Keywords[I].CString);
+        GlobalKeywordStrings[I].String.Bytes = GlobalKeywordStrings[I].String.Bytes + 1;
+        GlobalKeywordStrings[I].String.Size -= 2; /* NOTE: Subtract 2 to ignore hacked prepended underscore and the null-terminator. */
+        GlobalKeywordStrings[I].Type = Keywords[I].Type;
+    }
+
+    RootLookup->Char = GlobalKeywordStrings[0].String.Bytes[0];
+
+    for (u32 KeywordIndex = 0; KeywordIndex < KeywordCount; ++KeywordIndex)
+    {
+        keyword Keyword = GlobalKeywordStrings[KeywordIndex];
+        AddToLookup(Arena, RootLookup, Keyword);
+    }
+
+    return RootLookup;
+}
+
+internal lookup_node LookupString(lookup_node *Lookup, ryn_string String)
+{
+    lookup_node Result = {};
+    lookup_node *CurrentLookup = Lookup;
+    u64 Size = String.Size;
+
+    if (String.Bytes && String.Bytes[Size - 1] == 0)
+    {
+        Size -= 1;
+    }
+
+    for (u32 I = 0; I < Size; ++I)
+    {
+        u8 Char = String.Bytes[I];
+        b32 ShouldBreak = 0;
+
+        while (CurrentLookup)
+        {
+            if (Char == CurrentLookup->Char)
+            {
+                if (I == Size - 1)
+                {
+                    ShouldBreak = 1;
+                }
+                else
+                {
+                    CurrentLookup = CurrentLookup->Child;
+                }
+                break;
+            }
+            else
+            {
+                CurrentLookup = CurrentLookup->Sibling;
+            }
+        }
+
+        if (ShouldBreak)
+        {
+            break;
+        }
+    }
+
+    if (CurrentLookup)
+    {
+        Result = *CurrentLookup;
+    }
+
+    return Result;
+}
+
+/*
+  Keywords and directives are found with a perfect hash, the way gperf makes them: the hash of a
+  string is its size plus a value for its first char and a value for its last char, and no two
+  keywords hash to the same slot. So a lookup is one hash, one size check and one memcmp. The
+  values and tables are generated into idi_tokenizer_tables.h by WriteTokenizerTables.
+*/
+internal u32 LookupPerfectHash(const perfect_hash_entry *Table, const u8 *Values, u32 Mask, ryn_string String)
+{
+    u32 Result = 0;
+
+    if (String.Size > 0 && String.Size < 256)
+    {
+        u32 Hash = ((u32)String.Size + Values[String.Bytes[0]] + Values[String.Bytes[String.Size - 1]]) & Mask;
+        const perfect_hash_entry *Entry = &Table[Hash];
+
+        if (Entry->Size == String.Size && memcmp(Entry->Name, String.Bytes, String.Size) == 0)
+        {
+            Result = Entry->Type;
+        }
+    }
+
+    return Result;
+}
+
+/* NOTE: Returns the keyword's token_type, or 0 if String isn't a keyword. */
+internal token_type LookupKeyword(ryn_string String)
+{
+    token_type Result = LookupPerfectHash(KeywordHashTable, KeywordHashValues, KEYWORD_HASH_SIZE - 1, String);
+    return Result;
+}
+
+internal directive_type LookupDirective(ryn_string String)
+{
+    directive_type Result = LookupPerfectHash(DirectiveHashTable, DirectiveHashValues, DIRECTIVE_HASH_SIZE - 1, String);
+    return Result;
+}
+
+/* NOTE: The keyword CStrings start with an underscore, so they don't collide with C's own keywords in X-macros. */
+internal ryn_string GetKeywordName(keyword *Keyword)
+{
+    ryn_string Result = ryn_string_CreateString(Keyword->CString + 1);
+    Result.Size -= 1; /* NOTE: Minus 1 for the null-terminator. */
+    return Result;
+}
+
+/*
+  Search for values that give every keyword its own slot, in the smallest power-of-two table that
+  has a solution. The search is random, but always starts from the same seed, so the generated
+  tables only change when the keywords do.
+*/
+internal b32 FindPerfectHash(keyword *Keywords, u32 KeywordCount, perfect_hash *Result)
+{
+    b32 Found = 0;
+    u32 Random = 0x2545f491;
+    b32 IsEndChar[256] = {0};
+
+    for (u32 I = 0; I < KeywordCount; ++I)
+    {
+        ryn_string Name = GetKeywordName(&Keywords[I]);
+        IsEndChar[Name.Bytes[0]] = 1;
+        IsEndChar[Name.Bytes[Name.Size - 1]] = 1;
+    }
+
+    for (u32 Size = 1; !Found && Size <= PERFECT_HASH_SIZE_MAX; Size *= 2)
+    {
+        for (u32 Try = 0; !Found && Size >= KeywordCount && Try < 65536; ++Try)
+        {
+            *Result = (perfect_hash){0};
+            Result->Size = Size;
+            Found = 1;
+
+            for (u32 C = 0; C < 256; ++C)
+            {
+                if (IsEndChar[C])
+                {
+                    Random = Random * 1664525 + 1013904223;
+                    Result->Values[C] = (Random >> 16) & (Size - 1);
+                }
+            }
+
+            for (u32 I = 0; Found && I < KeywordCount; ++I)
+            {
+                ryn_string Name = GetKeywordName(&Keywords[I]);
+                u32 Hash = ((u32)Name.Size + Result->Values[Name.Bytes[0]] + Result->Values[Name.Bytes[Name.Size - 1]]) & (Size - 1);
+
+                if (Result->Slots[Hash])
+                {
+                    Found = 0;
+                }
+                else
+                {
+                    Result->Slots[Hash] = I + 1;
+                }
+            }
+        }
+    }
+
+    return Found;
+}
+
+internal void SetupTokenizerTable(void)
+{
+#define X(name, _typename, _literal)\
+    tokenizer_state name = tokenizer_state_##name;
+    tokenizer_state_NonError_XList;
+#undef X
+
+    for (s32 I = 0; I < 256; ++I)
+    {
+        for (u32 AcceptIndex = 0; AcceptIndex < ArrayCount(AcceptingStates); ++AcceptIndex)
+        {
+            tokenizer_state AcceptingState = AcceptingStates[AcceptIndex];
+            TokenizerTable[AcceptingState][I] = Done;
+        }
+
+        for (u32 DelimitedIndex = 0; DelimitedIndex < ArrayCount(DelimitedStates); ++DelimitedIndex)
+        {
+            tokenizer_state DelimitedState = DelimitedStates[DelimitedIndex];
+            TokenizerTable[DelimitedState][I] = DelimitedState;
+        }
+        TokenizerTable[Directive][I] = Directive;
+        TokenizerTable[DirectiveEscape][I] = Directive;
+        TokenizerTable[LineComment][I] = LineComment;
+
+        TokenizerTable[CommentBodyCheck][I] = CommentBody;
+    }
+
+    for (s32 I = Begin; I < tokenizer_state__Count; ++I)
+    {
+        TokenizerTable[I][End_Of_Source_Char] = Done;
+    }
+
+#define X(_name, typename, literal)\
+    TokenizerTable[Begin][literal] = typename;
+    SingleCharTokenList;
+#undef X
+
+#define X(_name, value)\
+    TokenizerTable[Begin][value] = Space;\
+    TokenizerTable[Space][value] = Space;
+    NonNewlineSpaceCharList;
+#undef X
+
+    for (s32 I = 'a'; I <= 'z'; ++I)
+    {
+        TokenizerTable[Begin][I] = IdentifierStart;
+        TokenizerTable[Begin][I-32] = IdentifierStart;
+
+        TokenizerTable[IdentifierStart][I] = IdentifierRest;
+        TokenizerTable[IdentifierStart][I-32] = IdentifierRest;
+
+        TokenizerTable[IdentifierRest][I] = IdentifierRest;
+        TokenizerTable[IdentifierRest][I-32] = IdentifierRest;
+    }
+
+    for (s32 I = '0'; I <= '9'; ++I)
+    {
+        TokenizerTable[Begin][I] = Digit;
+        TokenizerTable[Digit][I] = Digit;
+
+        TokenizerTable[IdentifierRest][I] = IdentifierRest;
+        TokenizerTable[IdentifierStart][I] = IdentifierRest;
+
+        TokenizerTable[HexDigitValue][I] = HexDigitValue;
+    }
+
+    for (s32 I = 'a'; I <= 'f'; ++I)
+    {
+        TokenizerTable[HexDigitValue][I] = HexDigitValue;
+    }
+
+    TokenizerTable[Begin]['_'] = IdentifierStart;
+    TokenizerTable[IdentifierStart]['_'] = IdentifierRest;
+    TokenizerTable[IdentifierRest]['_'] = IdentifierRest;
+
+    TokenizerTable[Begin]['0'] = BaseDigit;
+
+    TokenizerTable[BaseDigit]['b'] = BinaryDigitValue;
+    TokenizerTable[BaseDigit]['x'] = HexDigitValue;
+
+    TokenizerTable[BinaryDigitValue]['0'] = BinaryDigitValue;
+    TokenizerTable[BinaryDigitValue]['1'] = BinaryDigitValue;
+
+    { /* Delimited strings */
+        TokenizerTable[Begin]['"'] = String;
+        TokenizerTable[String]['\\'] = StringEscape;
+        TokenizerTable[String]['"'] = StringEnd;
+
+        TokenizerTable[Begin]['\''] = CharLiteral;
+        TokenizerTable[CharLiteral]['\\'] = CharLiteralEscape;
+        TokenizerTable[CharLiteral]['\''] = CharLiteralEnd;
+
+        TokenizerTable[Begin]['#'] = Directive;
+        TokenizerTable[Directive]['\n'] = Done;
+        TokenizerTable[Directive]['\\'] = DirectiveEscape;
+    }
+
+#define X(_name, value)\
+    TokenizerTable[StringEscape][value] = String;\
+    TokenizerTable[CharLiteralEscape][value] = CharLiteral;
+    escape_character_XList;
+#undef X
+
+    TokenizerTable[Begin]['='] = Equal;
+    TokenizerTable[Equal]['='] = DoubleEqual;
+    TokenizerTable[LessThan]['='] = LessThanOrEqual;
+    TokenizerTable[GreaterThan]['='] = GreaterThanOrEqual;
+    TokenizerTable[Begin]['<'] = LessThan;
+    TokenizerTable[Begin]['>'] = GreaterThan;
+    TokenizerTable[Begin]['!'] = Not;
+    TokenizerTable[Not]['='] = NotEqual;
+    TokenizerTable[Begin]['-'] = Dash;
+    TokenizerTable[Dash]['>'] = Arrow;
+
+    TokenizerTable[Begin]['/'] = ForwardSlash;
+    TokenizerTable[ForwardSlash]['*'] = CommentBody;
+    TokenizerTable[CommentBody]['*'] = CommentBodyCheck;
+    TokenizerTable[CommentBodyCheck]['/'] = Comment;
+    TokenizerTable[ForwardSlash]['/'] = LineComment;
+    TokenizerTable[LineComment]['\n'] = Done;
+    TokenizerTable[CommentBodyCheck]['*'] = CommentBodyCheck; /* NOTE: Stay in the check state on repeated stars, so a comment can end with several stars. */
+
+    TokenizerTable[Begin]['\\'] = TopLevelEscape;
+    TokenizerTable[TopLevelEscape]['\n'] = NewlineEscape; /* TODO: Handle CRLF */
+    TokenizerTable[Begin]['\n'] = Newline;
+}
+
+/* TODO: Rename rows/columns to something related to chars and tokenizer-states. */
+/* NOTE: Two chars are in the same class when every row of the table has the same entry in their columns. */
+internal equivalent_char_result GetEquivalentChars(u8 *Table, s32 Rows, s32 Columns)
+{
+    equivalent_char_result Result = {0};
+    Assert(Columns <= 256);
+
+    for (s32 C = 0; C < Columns; ++C)
+    {
+        s32 Class = 0;
+
+        for (; Class < Result.ClassCount; ++Class)
+        {
+            s32 TestC = Result.ClassChar[Class];
+            b32 Match = 1;
+
+            for (s32 R = 0; R < Rows; ++R)
+            {
+                if (Table[C + Columns * R] != Table[TestC + Columns * R])
+                {
+                    Match = 0;
+                    break;
+                }
+            }
+
+            if (Match)
+            {
+                break;
+            }
+        }
+
+        if (Class == Result.ClassCount)
+        {
+            Result.ClassChar[Class] = C;
+            Result.ClassCount += 1;
+        }
+
+        Result.CharClass[C] = Class;
+    }
+
+    return Result;
+}
+
+/*
+  States can only be merged when Tokenize and HighlightCode would treat them the same, so states
+  start out apart when their token type or their state after Done differ. Done and _Error are
+  checked for by name, and so are the escape states HighlightCode recovers from, so they stay alone.
+*/
+internal u32 GetTokenizerStateKey(tokenizer_state State)
+{
+    u32 Key = ((u32)StateToTypeTable[State] << 8) | (u32)TokenDoneTable[State];
+
+    if (State == tokenizer_state_Done ||
+        State == tokenizer_state__Error ||
+        State == tokenizer_state_StringEscape ||
+        State == tokenizer_state_CharLiteralEscape)
+    {
+        Key = 0x80000000 | State;
+    }
+
+    return Key;
+}
+
+/*
+  Hopcroft's algorithm on TokenizerTable, over its char classes. Blocks of states are split until
+  every state in a block goes to the same block on every char class, then each block becomes one
+  state. Blocks are numbered by their lowest tokenizer_state, so _Error stays 0 and Begin stays 1.
+*/
+internal void MinimizeTokenizerTable(minimized_tokenizer_table *Result)
+{
+    s32 StateCount = tokenizer_state__Count;
+    u32 BlockKeys[tokenizer_state__Count];
+    u8 Block[tokenizer_state__Count];
+    s32 BlockSize[tokenizer_state__Count] = {0};
+    s32 BlockCount = 0;
+    u8 Splitters[tokenizer_state__Count];
+    b32 IsSplitter[tokenizer_state__Count] = {0};
+    s32 SplitterCount = 0;
+
+    *Result = (minimized_tokenizer_table){0};
+    Result->Chars = GetEquivalentChars((u8 *)TokenizerTable, tokenizer_state__Count, 256);
+
+    for (s32 S = 0; S < StateCount; ++S)
+    {
+        u32 Key = GetTokenizerStateKey(S);
+        s32 B = 0;
+
+        while (B < BlockCount && BlockKeys[B] != Key)
+        {
+            B += 1;
+        }
+
+        if (B == BlockCount)
+        {
+            BlockKeys[BlockCount++] = Key;
+        }
+
+        Block[S] = B;
+        BlockSize[B] += 1;
+    }
+
+    /* NOTE: Hopcroft can leave one of the first blocks out, but with this few states it isn't worth the bookkeeping. */
+    for (s32 B = 0; B < BlockCount; ++B)
+    {
+        Splitters[SplitterCount++] = B;
+        IsSplitter[B] = 1;
+    }
+
+    while (SplitterCount > 0)
+    {
+        u8 Splitter = Splitters[--SplitterCount];
+        b32 InSplitter[tokenizer_state__Count];
+        IsSplitter[Splitter] = 0;
+
+        for (s32 S = 0; S < StateCount; ++S)
+        {
+            InSplitter[S] = Block[S] == Splitter;
+        }
+
+        for (s32 Class = 0; Class < Result->Chars.ClassCount; ++Class)
+        {
+            u8 Char = Result->Chars.ClassChar[Class];
+            b32 Marked[tokenizer_state__Count];
+            s32 MarkedCount[tokenizer_state__Count] = {0};
+            s32 OldBlockCount = BlockCount;
+
+            for (s32 S = 0; S < StateCount; ++S)
+            {
+                Marked[S] = InSplitter[TokenizerTable[S][Char]];
+                MarkedCount[Block[S]] += Marked[S] != 0;
+            }
+
+            for (s32 B = 0; B < OldBlockCount; ++B)
+            {
+                if (MarkedCount[B] > 0 && MarkedCount[B] < BlockSize[B])
+                {
+                    u8 NewBlock = BlockCount++;
+
+                    for (s32 S = 0; S < StateCount; ++S)
+                    {
+                        if (Block[S] == B && Marked[S])
+                        {
+                            Block[S] = NewBlock;
+                        }
+                    }
+
+                    BlockSize[NewBlock] = MarkedCount[B];
+                    BlockSize[B] -= MarkedCount[B];
+
+                    /* NOTE: If B still has to split others then both halves do, otherwise the smaller half is enough. */
+                    u8 NextSplitter = (IsSplitter[B] || BlockSize[NewBlock] < BlockSize[B]) ? NewBlock : B;
+
+                    if (!IsSplitter[NextSplitter])
+                    {
+                        Splitters[SplitterCount++] = NextSplitter;
+                        IsSplitter[NextSplitter] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    { /* Number the blocks and fill in a row for each of them. */
+        s32 BlockState[tokenizer_state__Count];
+
+        for (s32 B = 0; B < BlockCount; ++B)
+        {
+            BlockState[B] = -1;
+        }
+
+        for (s32 S = 0; S < StateCount; ++S)
+        {
+            if (BlockState[Block[S]] < 0)
+            {
+                BlockState[Block[S]] = Result->StateCount++;
+            }
+
+            Result->StateMap[S] = BlockState[Block[S]];
+        }
+
+        for (s32 S = 0; S < StateCount; ++S)
+        {
+            u8 Min = Result->StateMap[S];
+
+            for (s32 Class = 0; Class < Result->Chars.ClassCount; ++Class)
+            {
+                u8 Char = Result->Chars.ClassChar[Class];
+                Result->Table[Min][Class] = Result->StateMap[TokenizerTable[S][Char]];
+            }
+
+            Result->StateType[Min] = StateToTypeTable[S];
+            Result->StateDone[Min] = Result->StateMap[TokenDoneTable[S]];
+        }
+    }
+}
+
+/*
+  Find the bytes that keep each minimized state in itself, as inclusive ranges, so SkipTokenizerState
+  can test for them with a compare per range. States whose bytes don't fit in TOKENIZER_SKIP_RANGE_MAX
+  ranges, or that never stay put, get no ranges and are stepped through the table a byte at a time.
+  Unused ranges repeat the first one, so the skip loop can always test all of them.
+*/
+internal void FindTokenizerSkipRanges(minimized_tokenizer_table *Tables)
+{
+    u8 ErrorState = Tables->StateMap[tokenizer_state__Error];
+
+    for (s32 Min = 0; Min < Tables->StateCount; ++Min)
+    {
+        u8 Ranges[TOKENIZER_SKIP_RANGE_MAX][2];
+        s32 RangeCount = 0;
+        b32 InRange = 0;
+
+        /* NOTE: The end of source char is left out, a skip always has to stop on it. */
+        for (s32 C = End_Of_Source_Char + 1; C < 256 && RangeCount <= TOKENIZER_SKIP_RANGE_MAX; ++C)
+        {
+            b32 Stays = Tables->Table[Min][Tables->Chars.CharClass[C]] == Min;
+
+            if (Stays && !InRange)
+            {
+                if (RangeCount < TOKENIZER_SKIP_RANGE_MAX)
+                {
+                    Ranges[RangeCount][0] = (u8)C;
+                }
+
+                RangeCount += 1;
+            }
+
+            if (!Stays && InRange && RangeCount <= TOKENIZER_SKIP_RANGE_MAX)
+            {
+                Ranges[RangeCount - 1][1] = (u8)(C - 1);
+            }
+
+            InRange = Stays;
+        }
+
+        if (InRange && RangeCount <= TOKENIZER_SKIP_RANGE_MAX)
+        {
+            Ranges[RangeCount - 1][1] = 255;
+        }
+
+        if (Min == ErrorState || RangeCount > TOKENIZER_SKIP_RANGE_MAX)
+        {
+            RangeCount = 0;
+        }
+
+        Tables->SkipRangeCount[Min] = (u8)RangeCount;
+
+        for (s32 R = 0; R < TOKENIZER_SKIP_RANGE_MAX; ++R)
+        {
+            s32 From = R < RangeCount ? R : 0;
+            Tables->SkipRanges[Min][R][0] = RangeCount ? Ranges[From][0] : 0;
+            Tables->SkipRanges[Min][R][1] = RangeCount ? Ranges[From][1] : 0;
+        }
+    }
+}
+
+internal u64 HashKeywords(keyword *Keywords, u32 KeywordCount)
+{
+    u64 Hash = 0;
+
+    for (u32 I = 0; I < KeywordCount; ++I)
+    {
+        ryn_string Name = GetKeywordName(&Keywords[I]);
+        u64 Hashes[3] = {Hash, HashBytes(Name.Bytes, Name.Size), Keywords[I].Type};
+        Hash = HashBytes((u8 *)Hashes, sizeof(Hashes));
+    }
+
+    return Hash;
+}
+
+internal u64 GetTokenizerTableHash(void)
+{
+    u64 Hashes[5] = {
+        HashBytes((u8 *)TokenizerTable, sizeof(TokenizerTable)),
+        HashBytes((u8 *)StateToTypeTable, sizeof(StateToTypeTable)),
+        HashBytes((u8 *)TokenDoneTable, sizeof(TokenDoneTable)),
+        HashKeywords(GlobalHackedUpKeywords, ArrayCount(GlobalHackedUpKeywords)),
+        HashKeywords(GlobalHackedUpDirectives, ArrayCount(GlobalHackedUpDirectives)),
+    };
+
+    u64 Hash = HashBytes((u8 *)Hashes, sizeof(Hashes));
+    return Hash;
+}
+
+/* NOTE: Appends the values and slots of a perfect hash found by FindPerfectHash to Text, named <Name>HashValues and <Name>HashTable. */
+internal u64 WritePerfectHash(u8 *Text, u64 Capacity, char *Name, char *MacroName, keyword *Keywords, perfect_hash *Hash)
+{
+    u64 Size = 0;
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "\n#define %s_HASH_SIZE %u\n\n"
+                     "global_variable const u8 %sHashValues[256] = {", MacroName, Hash->Size, Name);
+
+    for (s32 C = 0; C < 256; ++C)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "%s%3d,", (C % 16) ? " " : "\n    ", Hash->Values[C]);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "\n};\n\nglobal_variable const perfect_hash_entry %sHashTable[%s_HASH_SIZE] = {\n", Name, MacroName);
+
+    for (u32 Slot = 0; Slot < Hash->Size; ++Slot)
+    {
+        if (Hash->Slots[Slot])
+        {
+            keyword *Keyword = &Keywords[Hash->Slots[Slot] - 1];
+            ryn_string KeywordName = GetKeywordName(Keyword);
+            Size += snprintf((char *)Text + Size, Capacity - Size, "    {\"%s\", %llu, %llu},\n", KeywordName.Bytes,
+                             (unsigned long long)KeywordName.Size, (unsigned long long)Keyword->Type);
+        }
+        else
+        {
+            Size += snprintf((char *)Text + Size, Capacity - Size, "    {0, 0, 0},\n");
+        }
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size, "};\n");
+
+    return Size;
+}
+
+#define TOKENIZER_TABLES_TEXT_MAX Kilobytes(64)
+
+/*
+  Write the minimized table as idi_tokenizer_tables.h. Run SetupTokenizerTable first. Returns 1 if
+  the file changed, in which case whatever includes idi_tokenizer.c has to be rebuilt.
+*/
+internal b32 WriteTokenizerTables(ryn_memory_arena *Arena, u8 *Path)
+{
+    b32 Changed = 0;
+    char *StateNames[] = {
+#define X(name, _typename, _literal)\
+        #name,
+        tokenizer_state_XList
+#undef X
+    };
+    minimized_tokenizer_table *Tables = ryn_memory_PushZeroStruct(Arena, minimized_tokenizer_table);
+    u8 *Text = ryn_memory_PushSize(Arena, TOKENIZER_TABLES_TEXT_MAX);
+    u64 Size = 0;
+    u64 Capacity = TOKENIZER_TABLES_TEXT_MAX;
+    perfect_hash KeywordHash = {0};
+    perfect_hash DirectiveHash = {0};
+
+    if (!Tables || !Text)
+    {
+        LogError("allocating tokenizer tables");
+        return 0;
+    }
+
+    if (!FindPerfectHash(GlobalHackedUpKeywords, ArrayCount(GlobalHackedUpKeywords), &KeywordHash))
+    {
+        printf("Error in WriteTokenizerTables: no perfect hash found for the keywords\n");
+        return 0;
+    }
+
+    if (!FindPerfectHash(GlobalHackedUpDirectives, ArrayCount(GlobalHackedUpDirectives), &DirectiveHash))
+    {
+        printf("Error in WriteTokenizerTables: no perfect hash found for the directives\n");
+        return 0;
+    }
+
+    MinimizeTokenizerTable(Tables);
+    FindTokenizerSkipRanges(Tables);
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "/* NOTE: Generated by \"main.out tokenizer_tables\" from SetupTokenizerTable in idi_tokenizer.c, don't edit. */\n"
+                     "#define TOKENIZER_TABLE_HASH 0x%016llxull\n"
+                     "#define TOKENIZER_CLASS_COUNT %d\n"
+                     "#define TOKENIZER_STATE_COUNT %d\n\n"
+                     "global_variable const u8 TokenizerCharClass[256] = {",
+                     (unsigned long long)GetTokenizerTableHash(), Tables->Chars.ClassCount, Tables->StateCount);
+
+    for (s32 C = 0; C < 256; ++C)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "%s%2d,", (C % 16) ? " " : "\n    ", Tables->Chars.CharClass[C]);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "\n};\n\n/* NOTE: The minimized state of each tokenizer_state. */\n"
+                     "global_variable const u8 TokenizerStateMap[tokenizer_state__Count] = {\n");
+
+    for (s32 S = 0; S < tokenizer_state__Count; ++S)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "    %2d, /* %s */\n", Tables->StateMap[S], StateNames[S]);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "};\n\nglobal_variable const u8 TokenizerClassTable[TOKENIZER_STATE_COUNT][TOKENIZER_CLASS_COUNT] = {\n");
+
+    for (s32 Min = 0; Min < Tables->StateCount; ++Min)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "    {");
+
+        for (s32 Class = 0; Class < Tables->Chars.ClassCount; ++Class)
+        {
+            Size += snprintf((char *)Text + Size, Capacity - Size, "%s%2d", Class ? "," : "", Tables->Table[Min][Class]);
+        }
+
+        Size += snprintf((char *)Text + Size, Capacity - Size, "}, /* %d */\n", Min);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "};\n\n/* NOTE: The token type a state finishes, and the state it goes to once it has. */\n"
+                     "global_variable const u16 TokenizerStateType[TOKENIZER_STATE_COUNT] = {");
+
+    for (s32 Min = 0; Min < Tables->StateCount; ++Min)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "%s%d", Min ? ", " : "", Tables->StateType[Min]);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "};\nglobal_variable const u8 TokenizerStateDone[TOKENIZER_STATE_COUNT] = {");
+
+    for (s32 Min = 0; Min < Tables->StateCount; ++Min)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "%s%d", Min ? ", " : "", Tables->StateDone[Min]);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "};\n\n/* NOTE: The bytes that keep a state in itself, see SkipTokenizerState. */\n"
+                     "global_variable const u8 TokenizerSkipRangeCount[TOKENIZER_STATE_COUNT] = {");
+
+    for (s32 Min = 0; Min < Tables->StateCount; ++Min)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "%s%d", Min ? ", " : "", Tables->SkipRangeCount[Min]);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "};\nglobal_variable const u8 TokenizerSkipRanges[TOKENIZER_STATE_COUNT][TOKENIZER_SKIP_RANGE_MAX][2] = {\n");
+
+    for (s32 Min = 0; Min < Tables->StateCount; ++Min)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "    {");
+
+        for (s32 R = 0; R < TOKENIZER_SKIP_RANGE_MAX; ++R)
+        {
+            Size += snprintf((char *)Text + Size, Capacity - Size, "%s{%3d,%3d}", R ? ", " : "",
+                             Tables->SkipRanges[Min][R][0], Tables->SkipRanges[Min][R][1]);
+        }
+
+        Size += snprintf((char *)Text + Size, Capacity - Size, "}, /* %d */\n", Min);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size, "};\n");
+
+    if (Size < Capacity)
+    {
+        Size += WritePerfectHash(Text + Size, Capacity - Size, "Keyword", "KEYWORD", GlobalHackedUpKeywords, &KeywordHash);
+    }
+
+    if (Size < Capacity)
+    {
+        Size += WritePerfectHash(Text + Size, Capacity - Size, "Directive", "DIRECTIVE", GlobalHackedUpDirectives, &DirectiveHash);
+    }
+
+    if (Size >= Capacity)
+    {
+        printf("Error in WriteTokenizerTables: the tables are too big\n");
+        return 0;
+    }
+
+    { /* Only write the header when it changed, so the builds that include it stay up to date. */
+        u64 OldOffset = Arena->Offset;
+        u64 OldSize = 0;
+        u8 *OldText = ryn_memory_GetArenaWriteLocation(Arena);
+
+        if (platform_GetFileInfo(Path).Exists)
+        {
+            OldSize = ReadFileIntoAllocator(Arena, Path);
+            OldSize = OldSize ? OldSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator. */
+        }
+
+        Changed = OldSize != Size || memcmp(OldText, Text, Size) != 0;
+        Arena->Offset = OldOffset;
+    }
+
+    if (Changed)
+    {
+        WriteFileWithPath(Path, Text, Size);
+    }
+
+    printf("Tokenizer tables: %d states into %d, 256 chars into %d classes, %s\n", tokenizer_state__Count,
+           Tables->StateCount, Tables->Chars.ClassCount, Changed ? "written" : "up to date");
+
+    return Changed;
+}
+
+internal ryn_string GetTokenString(token_stream *Tokens, u64 Index)
+{
+    ryn_string Result = {Tokens->Source.Bytes + Tokens->Offsets[Index], Tokens->Sizes[Index]};
+    return Result;
+}
+
+/*
+  Return the index of the first byte at or after I that would take State out of itself, looking at
+  32 bytes at a time, so long runs of space, identifier chars, comment and string bodies don't go
+  through the table byte by byte. Only whole chunks are looked at, so it can stop short of the end
+  and the table finishes the run. The skip ranges never have the end of source char in them, so
+  it stops on a null just like the table does.
+*/
+internal u64 SkipTokenizerState(u8 State, u8 *Bytes, u64 I, u64 Size)
+{
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    /* NOTE: Most runs are short, so the next byte is checked with the table before the vectors are set up. */
+    if (TokenizerSkipRangeCount[State] && I < Size &&
+        TokenizerClassTable[State][TokenizerCharClass[Bytes[I]]] == State)
+    {
+        const u8 (*Ranges)[2] = TokenizerSkipRanges[State];
+
+#if defined(__SSE2__)
+        /* NOTE: A byte is in a range when subtracting the start leaves at most its width, unsigned. */
+        __m128i Starts[TOKENIZER_SKIP_RANGE_MAX];
+        __m128i Widths[TOKENIZER_SKIP_RANGE_MAX];
+        __m128i Zero = _mm_setzero_si128();
+
+        for (s32 R = 0; R < TOKENIZER_SKIP_RANGE_MAX; ++R)
+        {
+            Starts[R] = _mm_set1_epi8((char)Ranges[R][0]);
+            Widths[R] = _mm_set1_epi8((char)(Ranges[R][1] - Ranges[R][0]));
+        }
+
+        for (; I + 32 <= Size; I += 32)
+        {
+            __m128i Low = _mm_loadu_si128((__m128i *)(Bytes + I));
+            __m128i High = _mm_loadu_si128((__m128i *)(Bytes + I + 16));
+            __m128i LowStays = Zero;
+            __m128i HighStays = Zero;
+
+            for (s32 R = 0; R < TOKENIZER_SKIP_RANGE_MAX; ++R)
+            {
+                LowStays = _mm_or_si128(LowStays, _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(Low, Starts[R]), Widths[R]), Zero));
+                HighStays = _mm_or_si128(HighStays, _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(High, Starts[R]), Widths[R]), Zero));
+            }
+
+            u32 Leaves = ~((u32)_mm_movemask_epi8(LowStays) | ((u32)_mm_movemask_epi8(HighStays) << 16));
+
+            if (Leaves)
+            {
+                I += __builtin_ctz(Leaves);
+                break;
+            }
+        }
+#else
+        uint8x16_t Starts[TOKENIZER_SKIP_RANGE_MAX];
+        uint8x16_t Widths[TOKENIZER_SKIP_RANGE_MAX];
+
+        for (s32 R = 0; R < TOKENIZER_SKIP_RANGE_MAX; ++R)
+        {
+            Starts[R] = vdupq_n_u8(Ranges[R][0]);
+            Widths[R] = vdupq_n_u8(Ranges[R][1] - Ranges[R][0]);
+        }
+
+        for (; I + 32 <= Size; I += 32)
+        {
+            uint8x16_t Low = vld1q_u8(Bytes + I);
+            uint8x16_t High = vld1q_u8(Bytes + I + 16);
+            uint8x16_t LowStays = vdupq_n_u8(0);
+            uint8x16_t HighStays = vdupq_n_u8(0);
+
+            for (s32 R = 0; R < TOKENIZER_SKIP_RANGE_MAX; ++R)
+            {
+                LowStays = vorrq_u8(LowStays, vcleq_u8(vsubq_u8(Low, Starts[R]), Widths[R]));
+                HighStays = vorrq_u8(HighStays, vcleq_u8(vsubq_u8(High, Starts[R]), Widths[R]));
+            }
+
+            /* NOTE: Narrow each byte of the compare to 4 bits, so each half fits in one 64-bit mask. */
+            u64 LowLeaves = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(LowStays), 4)), 0);
+            u64 HighLeaves = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(HighStays), 4)), 0);
+
+            if (LowLeaves)
+            {
+                I += __builtin_ctzll(LowLeaves) >> 2;
+                break;
+            }
+            else if (HighLeaves)
+            {
+                I += 16 + (__builtin_ctzll(HighLeaves) >> 2);
+                break;
+            }
+        }
+#endif
+    }
+#endif
+
+    return I;
+}
+
+/*
+  Run the tokenizer from I in State, writing tokens from Index on. It stops once a token ends at or
+  after End, so a run can be picked up again where it stopped, or at the end of the source or an
+  error. Every token it writes starts before End.
+*/
+internal tokenizer_run TokenizeRun(token_stream *Tokens, u64 Index, u64 Capacity, u64 I, u8 State, u64 End)
+{
+    tokenizer_run Run = {0};
+    ryn_string Source = Tokens->Source;
+    u8 BeginState = TokenizerStateMap[tokenizer_state_Begin];
+    u8 DoneState = TokenizerStateMap[tokenizer_state_Done];
+    u8 ErrorState = TokenizerStateMap[tokenizer_state__Error];
+    u64 StartOfToken = I;
+    u8 PreviousChar = Source.Bytes[I];
+    b32 EndOfSource = 0;
+
+    do
+    {
+        EndOfSource = (I == Source.Size) || (Source.Bytes[I] == 0);
+        u8 Char;
+
+        if (EndOfSource)
+        {
+            Char = End_Of_Source_Char;
+        }
+        else
+        {
+            Char = Source.Bytes[I];
+        }
+
+        u8 NextState = TokenizerClassTable[State][TokenizerCharClass[Char]];
+
+        if (NextState == DoneState)
+        {
+            token_type Type = TokenizerStateType[State];
+            u32 Size = (u32)(I - StartOfToken);
+
+            if (Type == token_type_Identifier)
+            {
+                ryn_string String = {Source.Bytes + StartOfToken, Size};
+                token_type KeywordType = LookupKeyword(String);
+
+                if (KeywordType)
+                {
+                    Type = KeywordType;
+                }
+            }
+
+            Assert(Run.Count < Capacity);
+            Tokens->Types[Index + Run.Count] = Type;
+            Tokens->Offsets[Index + Run.Count] = (u32)StartOfToken;
+            Tokens->Sizes[Index + Run.Count] = Size;
+            Run.Count += 1;
+            StartOfToken = I;
+
+            if (SingleTokenCharTable[PreviousChar])
+            {
+                NextState = BeginState;
+            }
+            else
+            {
+                NextState = TokenizerStateDone[State];
+            }
+
+            if (I >= End && !EndOfSource && NextState != ErrorState)
+            {
+                Run.Next = I;
+                Run.State = NextState;
+                return Run;
+            }
+        }
+        else
+        {
+            ++I;
+
+            if (NextState == State)
+            {
+                /* NOTE: The state stayed put, so it's likely in a long run that can be skipped without the table. */
+                u64 SkipTo = SkipTokenizerState(State, Source.Bytes, I, Source.Size);
+
+                if (SkipTo != I)
+                {
+                    I = SkipTo;
+                    Char = Source.Bytes[I - 1];
+                }
+            }
+        }
+
+        if (NextState == ErrorState)
+        {
+            Run.ErrorIndex = I;
+        }
+
+        State = NextState;
+        PreviousChar = Char;
+    } while (!EndOfSource &&
+             State != ErrorState);
+
+    Run.Next = I;
+    Run.State = State;
+    Run.Finished = 1;
+
+    return Run;
+}
+
+/* NOTE: Set the error, and move the sizes and types down to the end of the used offsets, then give back the rest. */
+internal void FinishTokenStream(ryn_memory_arena *Arena, token_stream *Tokens, tokenizer_run *LastRun)
+{
+    Tokens->Error = LastRun->State == TokenizerStateMap[tokenizer_state__Error];
+    Tokens->ErrorIndex = Tokens->Error ? LastRun->ErrorIndex : 0;
+
+    u32 *Sizes = Tokens->Offsets + Tokens->Count;
+    u16 *Types = (u16 *)(Sizes + Tokens->Count);
+
+    memmove(Sizes, Tokens->Sizes, Tokens->Count * sizeof(u32));
+    memmove(Types, Tokens->Types, Tokens->Count * sizeof(u16));
+    Tokens->Sizes = Sizes;
+    Tokens->Types = Types;
+    Arena->Offset = (u8 *)(Types + Tokens->Count) - Arena->Data;
+}
+
+/*
+  Every token takes at least one char, except for the last one, so the arrays are pushed at their
+  largest possible size and the unused ends are given back to the arena once the count is known.
+*/
+internal token_stream Tokenize(ryn_memory_arena *Arena, ryn_string Source)
+{
+    token_stream Tokens = {0};
+    u64 Capacity = Source.Size + 1;
+    u64 ArenaOffset = Arena->Offset;
+
+    Assert(Source.Size < 0xffffffff);
+    Tokens.Source = Source;
+    Arena->Offset = (Arena->Offset + 3) & ~(u64)3;
+    Tokens.Offsets = ryn_memory_PushSize(Arena, Capacity * sizeof(u32));
+    Tokens.Sizes = ryn_memory_PushSize(Arena, Capacity * sizeof(u32));
+    Tokens.Types = ryn_memory_PushSize(Arena, Capacity * sizeof(u16));
+
+    if (!Tokens.Offsets || !Tokens.Sizes || !Tokens.Types)
+    {
+        LogError("allocating tokens");
+        Arena->Offset = ArenaOffset;
+        Tokens = (token_stream){0};
+        Tokens.Source = Source;
+        Tokens.Error = 1;
+        return Tokens;
+    }
+
+    tokenizer_run Run = TokenizeRun(&Tokens, 0, Capacity, 0, TokenizerStateMap[tokenizer_state_Begin], Source.Size + 1);
+    Tokens.Count = Run.Count;
+    FinishTokenStream(Arena, &Tokens, &Run);
+
+    return Tokens;
+}
+
+#define TOKENIZE_CHUNK_SIZE_MIN Kilobytes(64)
+#define TOKENIZE_CHUNK_MAX 256
+
+typedef struct
+{
+    token_stream *Tokens;
+    u64 Index; /* NOTE: Where the chunk writes its tokens, see TokenizeParallel. */
+    u64 Start;
+    u64 End;
+    tokenizer_run Run;
+} tokenize_chunk_job;
+
+internal void TokenizeChunkJob(void *Data, s32 WorkerIndex)
+{
+    tokenize_chunk_job *Job = Data;
+    u64 Capacity = Job->End - Job->Start + 2;
+    Job->Run = TokenizeRun(Job->Tokens, Job->Index, Capacity, Job->Start, TokenizerStateMap[tokenizer_state_Begin], Job->End);
+}
+
+/*
+  Tokenize big sources on every core, with the same result as Tokenize. The source is split into
+  chunks just after newlines and each chunk is tokenized from the Begin state, on the guess that no
+  token runs over the newline. Then the chunks are checked in order: a chunk is kept when the one
+  before it stopped exactly at its start, in the Begin state. Otherwise it began inside a comment,
+  string or directive that goes on from an earlier line, so it is tokenized again from where the
+  earlier chunk really stopped. Chunks that the earlier ones have covered entirely are dropped.
+
+  Every token but the last one is at least a char long and starts before the end of its chunk, so
+  a chunk never has more tokens than chars before its end. Writing chunk K's tokens from its start
+  plus 2*K keeps them ahead of all of the tokens before it, so the chunks can be stitched together
+  by moving each one down in place.
+*/
+internal token_stream TokenizeParallel(ryn_memory_arena *Arena, job_system *JobSystem, ryn_string Source)
+{
+    u64 ChunkCount = Source.Size / TOKENIZE_CHUNK_SIZE_MIN;
+    u64 ChunkMax = (JobSystem && JobSystem->ThreadCount > 1) ? 4 * JobSystem->ThreadCount : 0;
+
+    ChunkCount = ChunkCount > ChunkMax ? ChunkMax : ChunkCount;
+    ChunkCount = ChunkCount > TOKENIZE_CHUNK_MAX ? TOKENIZE_CHUNK_MAX : ChunkCount;
+
+    if (ChunkCount < 2)
+    {
+        return Tokenize(Arena, Source);
+    }
+
+    token_stream Tokens = {0};
+    u64 Capacity = Source.Size + 1 + 2 * ChunkCount;
+    u64 ArenaOffset = Arena->Offset;
+
+    Assert(Source.Size < 0xffffffff);
+    Tokens.Source = Source;
+    Arena->Offset = (Arena->Offset + 3) & ~(u64)3;
+    Tokens.Offsets = ryn_memory_PushSize(Arena, Capacity * sizeof(u32));
+    Tokens.Sizes = ryn_memory_PushSize(Arena, Capacity * sizeof(u32));
+    Tokens.Types = ryn_memory_PushSize(Arena, Capacity * sizeof(u16));
+    Arena->Offset = (Arena->Offset + 7) & ~(u64)7;
+    tokenize_chunk_job *Jobs = ryn_memory_PushSize(Arena, ChunkCount * sizeof(tokenize_chunk_job));
+
+    if (!Tokens.Offsets || !Tokens.Sizes || !Tokens.Types || !Jobs)
+    {
+        LogError("allocating tokens");
+        Arena->Offset = ArenaOffset;
+        Tokens = (token_stream){0};
+        Tokens.Source = Source;
+        Tokens.Error = 1;
+        return Tokens;
+    }
+
+    u64 JobCount = 0;
+
+    for (u64 Start = 0; Start < Source.Size && JobCount < ChunkCount;)
+    {
+        tokenize_chunk_job *Job = &Jobs[JobCount];
+        u64 End = (JobCount + 1) * Source.Size / ChunkCount;
+
+        if (End <= Start)
+        {
+            End = Start + 1;
+        }
+
+        /* NOTE: Move the split to just after the next newline, the last chunk goes past the end to get the final token. */
+        while (End < Source.Size && Source.Bytes[End - 1] != '\n')
+        {
+            End += 1;
+        }
+
+        if (End >= Source.Size || JobCount + 1 == ChunkCount)
+        {
+            End = Source.Size + 1;
+        }
+
+        Job->Tokens = &Tokens;
+        Job->Index = Start + 2 * JobCount;
+        Job->Start = Start;
+        Job->End = End;
+        PushJob(JobSystem, TokenizeChunkJob, Job);
+
+        JobCount += 1;
+        Start = End;
+    }
+
+    RunJobs(JobSystem);
+
+    tokenizer_run Run = {0};
+    Run.State = TokenizerStateMap[tokenizer_state_Begin];
+
+    for (u64 I = 0; I < JobCount && !Run.Finished; ++I)
+    {
+        tokenize_chunk_job *Job = &Jobs[I];
+
+        if (Run.Next >= Job->End)
+        {
+            continue;
+        }
+
+        if (Run.Next != Job->Start || Run.State != TokenizerStateMap[tokenizer_state_Begin])
+        {
+            Job->Run = TokenizeRun(&Tokens, Job->Index, Job->End - Run.Next + 1, Run.Next, Run.State, Job->End);
+        }
+
+        memmove(Tokens.Types + Tokens.Count, Tokens.Types + Job->Index, Job->Run.Count * sizeof(u16));
+        memmove(Tokens.Offsets + Tokens.Count, Tokens.Offsets + Job->Index, Job->Run.Count * sizeof(u32));
+        memmove(Tokens.Sizes + Tokens.Count, Tokens.Sizes + Job->Index, Job->Run.Count * sizeof(u32));
+        Tokens.Count += Job->Run.Count;
+        Run = Job->Run;
+    }
+
+    FinishTokenStream(Arena, &Tokens, &Run);
+
+    return Tokens;
+}
@@ -0,0 +1,321 @@
+/* NOTE: Generated by "main.out tokenizer_tables" from SetupTokenizerTable in idi_tokenizer.c, don't edit. */
+#define TOKENIZER_TABLE_HASH 0x2c3ba627800c788aull
+#define TOKENIZER_CLASS_COUNT 39
+#define TOKENIZER_STATE_COUNT 51
+
+global_variable const u8 TokenizerCharClass[256] = {
+     0,  1,  1,  1,  1,  1,  1,  1,  1,  2,  3,  1,  1,  2,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     2,  4,  5,  6,  1,  1,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16,
+    17, 18, 19, 19, 19, 19, 19, 19, 19, 19, 20, 21, 22, 23, 24, 25,
+     1, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+    26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 27, 28, 29, 30, 26,
+     1, 31, 32, 33, 33, 31, 31, 26, 26, 26, 26, 26, 26, 26, 34, 26,
+    26, 26, 34, 26, 34, 26, 34, 26, 35, 26, 26, 36, 37, 38,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+     1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+};
+
+/* NOTE: The minimized state of each tokenizer_state. */
+global_variable const u8 TokenizerStateMap[tokenizer_state__Count] = {
+     0, /* _Error */
+     1, /* Begin */
+     2, /* OpenParenthesis */
+     3, /* CloseParenthesis */
+     4, /* OpenBracket */
+     5, /* CloseBracket */
+     6, /* OpenSquare */
+     7, /* CloseSquare */
+     8, /* Carrot */
+     9, /* Star */
+    10, /* Cross */
+    11, /* Comma */
+    12, /* Colon */
+    13, /* Semicolon */
+    14, /* Ampersand */
+    15, /* Pipe */
+    16, /* Question */
+    17, /* Dot */
+    18, /* Space */
+    19, /* Digit */
+    20, /* BinaryDigitValue */
+    21, /* HexDigitValue */
+    22, /* IdentifierStart */
+    22, /* IdentifierRest */
+    23, /* StringEnd */
+    24, /* CharLiteralEnd */
+    25, /* Directive */
+    26, /* Equal */
+    27, /* LessThan */
+    28, /* LessThanOrEqual */
+    29, /* GreaterThan */
+    30, /* GreaterThanOrEqual */
+    31, /* Not */
+    32, /* DoubleEqual */
+    33, /* ForwardSlash */
+    34, /* BaseDigit */
+    35, /* NewlineEscape */
+    36, /* Arrow */
+    37, /* NotEqual */
+    38, /* Comment */
+    39, /* LineComment */
+    40, /* Dash */
+    41, /* Newline */
+    42, /* String */
+    43, /* CharLiteral */
+    44, /* CommentBody */
+    45, /* StringEscape */
+    46, /* CharLiteralEscape */
+    47, /* CommentBodyCheck */
+    48, /* TopLevelEscape */
+    49, /* DirectiveEscape */
+    50, /* Done */
+};
+
+global_variable const u8 TokenizerClassTable[TOKENIZER_STATE_COUNT][TOKENIZER_CLASS_COUNT] = {
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 0 */
+    {50, 0,18,41,31,42,25,14,43, 2, 3, 9,10,11,40,17,33,34,19,19,12,13,27,26,29,16,22, 6,48, 7, 8,22,22,22,22,22, 4,15, 5}, /* 1 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 2 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 3 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 4 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 5 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 6 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 7 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 8 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 9 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 10 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 11 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 12 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 13 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 14 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 15 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 16 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 17 */
+    {50,50,18,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 18 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,19,19,19,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 19 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,20,20,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 20 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,21,21,21,50,50,50,50,50,50,50,50,50,50,50,21,21,21,50,50,50,50,50}, /* 21 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,22,22,22,50,50,50,50,50,50,22,50,50,50,50,22,22,22,22,22,50,50,50}, /* 22 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 23 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 24 */
+    {50,25,25,50,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,49,25,25,25,25,25,25,25,25,25,25}, /* 25 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,32,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 26 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,28,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 27 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 28 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,30,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 29 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 30 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,37,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 31 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 32 */
+    {50,50,50,50,50,50,50,50,50,50,50,44,50,50,50,50,39,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 33 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,20,50,50,21,50,50,50}, /* 34 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 35 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 36 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 37 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 38 */
+    {50,39,39,50,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39,39}, /* 39 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,36,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 40 */
+    {50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50,50}, /* 41 */
+    {50,42,42,42,42,23,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,42,45,42,42,42,42,42,42,42,42,42,42}, /* 42 */
+    {50,43,43,43,43,43,43,43,24,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,43,46,43,43,43,43,43,43,43,43,43,43}, /* 43 */
+    {50,44,44,44,44,44,44,44,44,44,44,47,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44}, /* 44 */
+    {50, 0, 0, 0, 0,42, 0, 0,42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,42, 0, 0,42, 0, 0,42,42, 0,42, 0, 0, 0, 0}, /* 45 */
+    {50, 0, 0, 0, 0,43, 0, 0,43, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,43, 0, 0,43, 0, 0,43,43, 0,43, 0, 0, 0, 0}, /* 46 */
+    {50,44,44,44,44,44,44,44,44,44,44,47,44,44,44,44,38,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44,44}, /* 47 */
+    {50, 0, 0,35, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 48 */
+    {50,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25,25}, /* 49 */
+    {50, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 50 */
+};
+
+/* NOTE: The token type a state finishes, and the state it goes to once it has. */
+global_variable const u16 TokenizerStateType[TOKENIZER_STATE_COUNT] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 49, 50, 51, 52, 53, 54, 55, 70, 56, 61, 62, 63, 64, 67, 57, 59, 50, 60, 66, 65, 58, 58, 68, 69, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+global_variable const u8 TokenizerStateDone[TOKENIZER_STATE_COUNT] = {0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/* NOTE: The bytes that keep a state in itself, see SkipTokenizerState. */
+global_variable const u8 TokenizerSkipRangeCount[TOKENIZER_STATE_COUNT] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 1, 1, 2, 4, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 3, 3, 2, 0, 0, 1, 0, 0, 0};
+global_variable const u8 TokenizerSkipRanges[TOKENIZER_STATE_COUNT][TOKENIZER_SKIP_RANGE_MAX][2] = {
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 0 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 1 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 2 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 3 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 4 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 5 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 6 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 7 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 8 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 9 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 10 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 11 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 12 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 13 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 14 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 15 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 16 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 17 */
+    {{  9,  9}, { 13, 13}, { 32, 32}, {  9,  9}}, /* 18 */
+    {{ 48, 57}, { 48, 57}, { 48, 57}, { 48, 57}}, /* 19 */
+    {{ 48, 49}, { 48, 49}, { 48, 49}, { 48, 49}}, /* 20 */
+    {{ 48, 57}, { 97,102}, { 48, 57}, { 48, 57}}, /* 21 */
+    {{ 48, 57}, { 65, 90}, { 95, 95}, { 97,122}}, /* 22 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 23 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 24 */
+    {{  1,  9}, { 11, 91}, { 93,255}, {  1,  9}}, /* 25 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 26 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 27 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 28 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 29 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 30 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 31 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 32 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 33 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 34 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 35 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 36 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 37 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 38 */
+    {{  1,  9}, { 11,255}, {  1,  9}, {  1,  9}}, /* 39 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 40 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 41 */
+    {{  1, 33}, { 35, 91}, { 93,255}, {  1, 33}}, /* 42 */
+    {{  1, 38}, { 40, 91}, { 93,255}, {  1, 38}}, /* 43 */
+    {{  1, 41}, { 43,255}, {  1, 41}, {  1, 41}}, /* 44 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 45 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 46 */
+    {{ 42, 42}, { 42, 42}, { 42, 42}, { 42, 42}}, /* 47 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 48 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 49 */
+    {{  0,  0}, {  0,  0}, {  0,  0}, {  0,  0}}, /* 50 */
+};
+
+#define KEYWORD_HASH_SIZE 64
+
+global_variable const u8 KeywordHashValues[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,  44,  29,  38,  30,  40,  50,  30,  20,  51,   0,  45,  38,  34,  60,  35,
+      0,   0,  24,  24,  62,  20,  14,  62,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+global_variable const perfect_hash_entry KeywordHashTable[KEYWORD_HASH_SIZE] = {
+    {0, 0, 0},
+    {0, 0, 0},
+    {"char", 4, 20},
+    {"do", 2, 24},
+    {"static", 6, 40},
+    {"goto", 4, 31},
+    {0, 0, 0},
+    {0, 0, 0},
+    {"long", 4, 34},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {"double", 6, 25},
+    {"for", 3, 30},
+    {"enum", 4, 27},
+    {"break", 5, 18},
+    {"sizeof", 6, 39},
+    {0, 0, 0},
+    {"case", 4, 19},
+    {"auto", 4, 17},
+    {"else", 4, 26},
+    {"union", 5, 44},
+    {"continue", 8, 22},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {"return", 6, 36},
+    {"short", 5, 37},
+    {"struct", 6, 41},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {"default", 7, 23},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {"if", 2, 32},
+    {0, 0, 0},
+    {"const", 5, 21},
+    {"extern", 6, 28},
+    {"while", 5, 48},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {0, 0, 0},
+    {"void", 4, 46},
+    {0, 0, 0},
+    {"switch", 6, 42},
+    {0, 0, 0},
+    {"int", 3, 33},
+    {"float", 5, 29},
+    {0, 0, 0},
+    {"typedef", 7, 43},
+    {"register", 8, 35},
+    {0, 0, 0},
+    {"unsigned", 8, 45},
+    {0, 0, 0},
+    {"signed", 6, 38},
+    {0, 0, 0},
+    {"volatile", 8, 47},
+    {0, 0, 0},
+};
+
+#define DIRECTIVE_HASH_SIZE 16
+
+global_variable const u8 DirectiveHashValues[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   6,  10,  13,  13,   0,   1,   0,   0,   3,   0,   0,   0,
+      0,   0,  14,   3,   8,   7,   0,   3,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+global_variable const perfect_hash_entry DirectiveHashTable[DIRECTIVE_HASH_SIZE] = {
+    {"if", 2, 7},
+    {"line", 4, 13},
+    {"include", 7, 11},
+    {"ifdef", 5, 8},
+    {"ifndef", 6, 9},
+    {"include_next", 12, 12},
+    {"define", 6, 1},
+    {"warning", 7, 16},
+    {"else", 4, 3},
+    {"undef", 5, 15},
+    {"sccs", 4, 14},
+    {"elif", 4, 2},
+    {"endif", 5, 4},
+    {"error", 5, 5},
+    {"ident", 5, 6},
+    {"import", 6, 10},
+};
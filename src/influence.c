@@ -29,8 +29,12 @@
 
 #include "../src/types.h"
 #include "../src/core.c"
+#include "../src/asset_pack.h"
+#include "../gen/influence_pack.h"
+#include "../gen/influence_sprites.h"
 #include "../src/math.c"
 #include "../src/raylib_helpers.h"
+#include "../src/asset_loader.c"
 #include "../src/ui.c"
 
 #define Kilobyte (1024)
@@ -370,13 +374,13 @@ internal void DrawEntity(game *Game, entity_id EntityId)
     if (IsTextureReady(World->AssetTexture))
     {
         entity *Entity = GetEntity(World, EntityId);
-        Rectangle Source = {0.0f, 0.0f, 100.0f, 200.0f};
+        Rectangle Source = InfluenceSpriteRects[INFLUENCE_SPRITE_SCALE_INDEX_1][influence_sprite_Person];
         b32 ShouldDraw = 1;
 
         switch (EntityId)
         {
         case entity_id_Player: break;
-        case entity_id_Somebody: Source.x = 0; break;
+        case entity_id_Somebody: break;
         default: ShouldDraw = 0; break;
         }
 
@@ -485,49 +489,13 @@ internal void DrawWorld(game *Game)
 internal b32 LoadAssetTexture(world *World)
 {
     b32 Error = 0;
-#if 0
-    s32 AssetSize = ArrayCount(AssetData);
+    World->AssetTexture = LoadPackTexture(GetAssetPack(InfluencePack), InfluenceSpriteAtlasNames[INFLUENCE_SPRITE_SCALE_INDEX_1]);
 
-    if (AssetSize > 2)
+    if (!IsTextureReady(World->AssetTexture))
     {
-        u32 AssetWidth = AssetData[0];
-        u32 AssetHeight = AssetData[1];
-        u64 PixelCount = AssetWidth * AssetHeight;
-
-        Image Image = GenImageColor(AssetWidth, AssetHeight, (Color){255,0,255,255});
-
-        for (u64 I = 2; I < PixelCount + 2; ++I)
-        {
-            u32 X = (I - 2) % AssetWidth;
-            u32 Y = (I - 2) / AssetWidth;
-            if (X < AssetWidth && X >= 0 && Y < AssetHeight && Y >= 0)
-            {
-                /* NOTE: We could pack our colors and just cast the u32,
-                 * but for now we break the color components out and re-write them. */
-                u8 R = (AssetData[I] >> 24) & 0xff;
-                u8 G = (AssetData[I] >> 16) & 0xff;
-                u8 B = (AssetData[I] >>  8) & 0xff;
-                u8 A = (AssetData[I]      ) & 0xff;
-                Color PixelColor = (Color){R, G, B, A};
-
-                ImageDrawPixel(&Image, X, Y, PixelColor);
-            }
-            else
-            {
-                printf("[Error] Out of bounds asset access.");
-                break;
-            }
-        }
-
-        World->AssetTexture = LoadTextureFromImage(Image);
-    }
-    else
-    {
-        printf("[Error] Asset is too small to be useful, there was likely an error generating game assets.");
+        printf("[Error] Influence asset pack has no usable image, there was likely an error generating game assets.");
+        Error = 1;
     }
-#else
-    World->AssetTexture = LoadTexture("../assets/influence.png");
-#endif
 
     return Error;
 }
@@ -0,0 +1,271 @@
+/*
+  A small job system for fanning independent work out across cores.
+
+  Jobs are pushed from the main thread, then RunJobs wakes the workers and the main thread joins in.
+  Every participant has its own queue and claims jobs from it with an atomic increment. When its own
+  queue is empty it steals from the other queues the same way. RunJobs returns once every
+  participant has run out of work, so all jobs are finished and the queues can be reused.
+
+  Jobs must not push more jobs. On platforms without threads every job runs on the main thread.
+
+  A job is passed the index of the participant running it, from 0 (the main thread) up to
+  ThreadCount - 1. No two jobs run on the same participant at once, so jobs can use it to pick
+  per-worker state, e.g. a scratch arena, without locking.
+*/
+
+#define JOB_QUEUE_MAX 1024
+#define JOB_THREAD_MAX 32
+
+typedef void job_proc(void *Data, s32 WorkerIndex);
+
+typedef struct
+{
+    job_proc *Proc;
+    void *Data;
+} job;
+
+typedef struct
+{
+    job Jobs[JOB_QUEUE_MAX];
+    u32 Count;
+    volatile u32 Next;
+} job_queue;
+
+typedef struct
+{
+    volatile u32 Ticket;
+    volatile u32 Serving;
+} ticket_mutex;
+
+typedef struct job_system job_system;
+
+typedef struct
+{
+    job_system *System;
+    s32 Index;
+} job_worker;
+
+struct job_system
+{
+    s32 ThreadCount; /* NOTE: Includes the main thread, which always uses queue 0. */
+    s32 JobCount;
+    job_queue Queues[JOB_THREAD_MAX];
+    job_worker Workers[JOB_THREAD_MAX];
+
+#if ryn_memory_Mac
+    pthread_t Threads[JOB_THREAD_MAX];
+    pthread_mutex_t Mutex;
+    pthread_cond_t WakeUp;
+    u32 Generation;
+    volatile u32 ActiveCount;
+    b32 Quit;
+#endif
+};
+
+internal u32 AtomicIncrementU32(volatile u32 *Value)
+{
+    /* NOTE: Returns the value before the increment. */
+#if ryn_memory_Mac
+    return __atomic_fetch_add(Value, 1, __ATOMIC_SEQ_CST);
+#else
+    u32 Result = *Value;
+    *Value += 1;
+    return Result;
+#endif
+}
+
+internal u32 AtomicLoadU32(volatile u32 *Value)
+{
+#if ryn_memory_Mac
+    return __atomic_load_n(Value, __ATOMIC_SEQ_CST);
+#else
+    return *Value;
+#endif
+}
+
+internal void BeginTicketMutex(ticket_mutex *Mutex)
+{
+    u32 Ticket = AtomicIncrementU32(&Mutex->Ticket);
+
+#if ryn_memory_Mac
+    while (Ticket != AtomicLoadU32(&Mutex->Serving))
+    {
+        /* NOTE: Spin, the lock is only held for short stretches. */
+    }
+#else
+    Assert(Ticket == Mutex->Serving);
+#endif
+}
+
+internal void EndTicketMutex(ticket_mutex *Mutex)
+{
+    AtomicIncrementU32(&Mutex->Serving);
+}
+
+internal void DoJobs(job_system *System, s32 ParticipantIndex)
+{
+    for (s32 I = 0; I < System->ThreadCount; ++I)
+    {
+        /* NOTE: Start with our own queue, then steal from the others. */
+        job_queue *Queue = &System->Queues[(ParticipantIndex + I) % System->ThreadCount];
+
+        while (AtomicLoadU32(&Queue->Next) < Queue->Count)
+        {
+            u32 JobIndex = AtomicIncrementU32(&Queue->Next);
+
+            if (JobIndex < Queue->Count)
+            {
+                job *Job = &Queue->Jobs[JobIndex];
+                Job->Proc(Job->Data, ParticipantIndex);
+            }
+        }
+    }
+}
+
+#if ryn_memory_Mac
+internal void *JobWorkerThread(void *Data)
+{
+    job_worker *Worker = Data;
+    job_system *System = Worker->System;
+    u32 Generation = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&System->Mutex);
+
+        while (System->Generation == Generation && !System->Quit)
+        {
+            pthread_cond_wait(&System->WakeUp, &System->Mutex);
+        }
+
+        b32 Quit = System->Quit;
+        Generation = System->Generation;
+        pthread_mutex_unlock(&System->Mutex);
+
+        if (Quit)
+        {
+            break;
+        }
+
+        DoJobs(System, Worker->Index);
+
+        __atomic_fetch_sub(&System->ActiveCount, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return 0;
+}
+#endif
+
+/* Pass 0 for ThreadCount to use one thread per core. */
+internal job_system *CreateJobSystem(s32 ThreadCount)
+{
+    job_system *System = AllocateMemory(sizeof(job_system));
+
+    if (!System)
+    {
+        LogError("allocating job system");
+        return System;
+    }
+
+    SetMemory((u8 *)System, 0, sizeof(job_system));
+
+#if ryn_memory_Mac
+    if (ThreadCount <= 0)
+    {
+        ThreadCount = (s32)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    ThreadCount = ThreadCount < 1 ? 1 : ThreadCount;
+    ThreadCount = ThreadCount > JOB_THREAD_MAX ? JOB_THREAD_MAX : ThreadCount;
+    System->ThreadCount = ThreadCount;
+
+    pthread_mutex_init(&System->Mutex, 0);
+    pthread_cond_init(&System->WakeUp, 0);
+
+    for (s32 I = 1; I < System->ThreadCount; ++I)
+    {
+        job_worker *Worker = &System->Workers[I];
+        Worker->System = System;
+        Worker->Index = I;
+
+        if (pthread_create(&System->Threads[I], 0, JobWorkerThread, Worker) != 0)
+        {
+            LogError("creating job thread");
+            System->ThreadCount = I;
+            break;
+        }
+    }
+#else
+    System->ThreadCount = 1;
+#endif
+
+    return System;
+}
+
+internal void FreeJobSystem(job_system *System)
+{
+#if ryn_memory_Mac
+    pthread_mutex_lock(&System->Mutex);
+    System->Quit = 1;
+    pthread_cond_broadcast(&System->WakeUp);
+    pthread_mutex_unlock(&System->Mutex);
+
+    for (s32 I = 1; I < System->ThreadCount; ++I)
+    {
+        pthread_join(System->Threads[I], 0);
+    }
+
+    pthread_cond_destroy(&System->WakeUp);
+    pthread_mutex_destroy(&System->Mutex);
+#endif
+
+    FreeMemory(System);
+}
+
+/* Queue a job for the next RunJobs. Must only be called from the main thread. */
+internal void PushJob(job_system *System, job_proc *Proc, void *Data)
+{
+    job_queue *Queue = &System->Queues[System->JobCount % System->ThreadCount];
+
+    if (Queue->Count < JOB_QUEUE_MAX)
+    {
+        Queue->Jobs[Queue->Count].Proc = Proc;
+        Queue->Jobs[Queue->Count].Data = Data;
+        Queue->Count += 1;
+        System->JobCount += 1;
+    }
+    else
+    {
+        /* NOTE: The queues are full, so just do the work right away, on the main thread. */
+        Proc(Data, 0);
+    }
+}
+
+/* Run every pushed job and wait for all of them to finish. */
+internal void RunJobs(job_system *System)
+{
+#if ryn_memory_Mac
+    pthread_mutex_lock(&System->Mutex);
+    System->ActiveCount = System->ThreadCount - 1;
+    System->Generation += 1;
+    pthread_cond_broadcast(&System->WakeUp);
+    pthread_mutex_unlock(&System->Mutex);
+#endif
+
+    DoJobs(System, 0);
+
+#if ryn_memory_Mac
+    while (AtomicLoadU32(&System->ActiveCount) > 0)
+    {
+        sched_yield();
+    }
+#endif
+
+    for (s32 I = 0; I < System->ThreadCount; ++I)
+    {
+        System->Queues[I].Count = 0;
+        System->Queues[I].Next = 0;
+    }
+
+    System->JobCount = 0;
+}
@@ -6,7 +6,15 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
+#include <math.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "../lib/ryn_macro.h"
 #include "types.h"
 #include "core.c"
 
@@ -16,12 +24,29 @@
 #include "../lib/ryn_prof.h"
 
 #include "platform.h"
+#include "job_system.c"
+#include "build_manifest.c"
+#include "site_report.c"
+#include "idi_tokenizer.c"
 #include "preprocess.c"
+#include "compress.c"
+#include "asset_pack.h"
+#include "asset_cache.c"
+#include "sprite_atlas.c"
+#include "font_atlas.c"
+#include "sound_bank.c"
+#include "game_assets.c"
+#include "server.c"
 
 typedef enum
 {
     timed_block_UNDEFINED,
     timed_block_Main,
+    timed_block_EscapeHtmlScalar,
+    timed_block_EscapeHtml,
+    timed_block_HighlightCode,
+    timed_block_CompileBlog,
+    timed_block_GenerateByteArray,
     timed_block_Count,
 } timed_block;
 
@@ -30,6 +55,11 @@ typedef enum
     command_line_arg_type_Undefined,
     command_line_arg_type_Preprocess,
     command_line_arg_type_GameAssets,
+    command_line_arg_type_Benchmark,
+    command_line_arg_type_Compress,
+    command_line_arg_type_Watch,
+    command_line_arg_type_Serve,
+    command_line_arg_type_TokenizerTables,
     command_line_arg_type_Count,
 } command_line_arg_type;
 
@@ -37,6 +67,7 @@ typedef struct
 {
     b32 Valid;
     command_line_arg_type Type;
+    b32 Compress; /* NOTE: Set by "--compress", to also write precompressed copies of the site. */
 } command_line_args;
 
 typedef struct
@@ -48,14 +79,19 @@ typedef struct
 global_variable command_line_command CommandLineCommands[] = {
     {command_line_arg_type_Preprocess,(u8 *)"preprocess"},
     {command_line_arg_type_GameAssets,(u8 *)"game_assets"},
+    {command_line_arg_type_Benchmark,(u8 *)"benchmark"},
+    {command_line_arg_type_Compress,(u8 *)"compress"},
+    {command_line_arg_type_Watch,(u8 *)"watch"},
+    {command_line_arg_type_Serve,(u8 *)"serve"},
+    {command_line_arg_type_TokenizerTables,(u8 *)"tokenizer_tables"},
 };
 
-internal command_line_arg_type ParseCommandLineArgs(s32 ArgCount, char **Args)
+internal command_line_args ParseCommandLineArgs(s32 ArgCount, char **Args)
 {
-    command_line_arg_type CommandLineArgs = 0;
+    command_line_args CommandLineArgs = {0};
     s32 CommandCount = ArrayCount(CommandLineCommands);
 
-    if (ArgCount < 2 || ArgCount > 2)
+    if (ArgCount < 2)
     {
         printf("Expecting a single argument to be passed... we really should print out usage here...\n");
     }
@@ -69,202 +105,236 @@ internal command_line_arg_type ParseCommandLineArgs(s32 ArgCount, char **Args)
 
             if (StringsEqual(FirstArg, Command.Name))
             {
-                CommandLineArgs = Command.Type;
+                CommandLineArgs.Type = Command.Type;
             }
         }
 
-        if (CommandLineArgs == 0)
+        CommandLineArgs.Valid = CommandLineArgs.Type != 0;
+
+        if (!CommandLineArgs.Valid)
         {
             printf("Command line parse error: unexpected command \"%s\"\n", FirstArg);
         }
+
+        for (s32 I = 2; I < ArgCount; ++I)
+        {
+            if (StringsEqual((u8 *)Args[I], (u8 *)"--compress"))
+            {
+                CommandLineArgs.Compress = 1;
+            }
+            else
+            {
+                printf("Command line parse error: unexpected option \"%s\"\n", Args[I]);
+                CommandLineArgs.Valid = 0;
+            }
+        }
     }
 
     return CommandLineArgs;
 }
 
-internal void GenerateByteArray(ryn_memory_arena *TempArena, u8 *DestinationPath, u8 *ByteArrayName, u8 *ByteArray, size Size)
+/* Escape a large generated source, made by repeating every file in ../src and ../lib, with the scalar and the SIMD escaper. */
+internal void BenchmarkHtmlEscape(ryn_memory_arena *TempArena)
 {
-    /* TODO: Compress the data. */
-    u8 HexData[16];
-
-    file File = platform_OpenFile(DestinationPath);
-
-    if (!File.File)
-    {
-        printf("Error in GenerateByteArray: Destination file not found '%s'\n", DestinationPath);
-        return;
-    }
+    u64 SourceSizeMin = Megabytes(64);
+    s32 RunCount = 8;
+    u8 *Directories[] = {(u8 *)"../src", (u8 *)"../lib"};
 
     ryn_memory_ArenaStackPush(TempArena);
-    ryn_memory_arena ChunkArena = ryn_memory_CreateSubArena(TempArena, 1024);
-    PushString(&ChunkArena, (u8 *)"u8 ");
-    PushString(&ChunkArena, ByteArrayName);
-    PushString(&ChunkArena, (u8 *)"[] = {");
 
-    for (u64 I = 0; I < Size; ++I)
+    u8 *Source = ryn_memory_GetArenaWriteLocation(TempArena);
+    u64 SourceSize = 0;
+
+    while (SourceSize < SourceSizeMin)
     {
-        b32 IsLastByte = I == Size - 1;
+        u64 PassSize = 0;
 
-        char *FormatString = IsLastByte ? "0x%02x" : "0x%02x,";
+        for (u32 I = 0; I < ArrayCount(Directories); ++I)
+        {
+            ryn_memory_arena FileArena = ryn_memory_CreateArena(Megabytes(16));
 
-        b32 IsEndOfLine = I != 0 && I % 15 == 0;
+            for (file_list *File = WalkDirectory(&FileArena, Directories[I]); File; File = File->Next)
+            {
+                u64 FileSize = ReadFileIntoAllocator(TempArena, File->Name.Bytes);
 
-        sprintf((char *)HexData, FormatString, ByteArray[I]);
+                if (FileSize)
+                {
+                    TempArena->Offset -= 1; /* NOTE: Drop the null-terminator. */
+                    PassSize += FileSize - 1;
+                }
+            }
 
-        u64 StringLength = GetStringLength(HexData);
-        if (IsEndOfLine)
-        {
-            StringLength += 1;
+            ryn_memory_FreeArena(FileArena);
         }
 
-        if (StringLength > ryn_memory_GetArenaFreeSpace(&ChunkArena))
+        if (PassSize == 0)
         {
-            WriteFile(File, ChunkArena.Data, ChunkArena.Offset);
-            ChunkArena.Offset = 0;
+            LogError("no benchmark sources found");
+            ryn_memory_ArenaStackPop(TempArena);
+            return;
         }
 
-        PushString(&ChunkArena, HexData);
+        SourceSize += PassSize;
+    }
 
-        if (IsEndOfLine)
-        {
-            PushString(&ChunkArena, (u8 *)"\n");
-        }
+    u8 *ScalarOutput = ryn_memory_PushSize(TempArena, EscapeHtmlCapacity(SourceSize));
+    u8 *SimdOutput = ryn_memory_PushSize(TempArena, EscapeHtmlCapacity(SourceSize));
+    u64 ScalarSize = 0;
+    u64 SimdSize = 0;
+
+    if (!ScalarOutput || !SimdOutput)
+    {
+        LogError("allocating benchmark output");
+        ryn_memory_ArenaStackPop(TempArena);
+        return;
     }
 
-    if (ChunkArena.Offset > 0)
+    for (s32 Run = 0; Run < RunCount; ++Run)
     {
-        WriteFile(File, ChunkArena.Data, ChunkArena.Offset);
+        {
+            ryn_BEGIN_BANDWIDTH_BLOCK(timed_block_EscapeHtmlScalar, SourceSize);
+            ScalarSize = EscapeHtmlScalar(ScalarOutput, Source, SourceSize);
+            ryn_END_TIMED_BLOCK(timed_block_EscapeHtmlScalar);
+        }
+        {
+            ryn_BEGIN_BANDWIDTH_BLOCK(timed_block_EscapeHtml, SourceSize);
+            SimdSize = EscapeHtml(SimdOutput, Source, SourceSize);
+            ryn_END_TIMED_BLOCK(timed_block_EscapeHtml);
+        }
     }
 
-    u8 *FileEndString = (u8 *)"};\0";
-    WriteFile(File, FileEndString, GetStringLength(FileEndString));
+    b32 OutputsMatch = ScalarSize == SimdSize && memcmp(ScalarOutput, SimdOutput, ScalarSize) == 0;
+    printf("Escaped %llu bytes into %llu bytes, outputs %s\n", (unsigned long long)SourceSize,
+           (unsigned long long)SimdSize, OutputsMatch ? "match" : "DO NOT MATCH");
+
     ryn_memory_ArenaStackPop(TempArena);
 }
 
-internal void GenerateSoundData(ryn_memory_arena *TempArena)
+/* Highlight every .c and .h file in ../src and ../lib, the way code pages are generated. */
+internal void BenchmarkHighlightCode(ryn_memory_arena *TempArena)
 {
-    u8 *SfxCorrectSourcePath = (u8 *)"../assets/sfx_correct.wav";
-    u8 *SfxCorrectDestinationPath = (u8 *)"../gen/sfx_correct.h";
-    /* u64 BeginningOffset = TempArena->Offset; */
+    u8 *Directories[] = {(u8 *)"../src", (u8 *)"../lib"};
+    u64 TotalSourceSize = 0;
+    u64 TotalHtmlSize = 0;
+    u64 ElapsedMicroseconds = 0;
+    s32 FileCount = 0;
 
-    buffer *Buffer = ReadFileIntoBuffer(SfxCorrectSourcePath);
+    ryn_memory_ArenaStackPush(TempArena);
 
-    if (Buffer && Buffer->Data)
-    {
-        u8 *ArrayName = (u8 *)"SfxCorrectData";
-        GenerateByteArray(TempArena, SfxCorrectDestinationPath, ArrayName, Buffer->Data, Buffer->Size);
-    }
-    else
+    for (u32 I = 0; I < ArrayCount(Directories); ++I)
     {
-        printf("Error in GenerateSoundData: File not found '%s'\n", SfxCorrectSourcePath);
+        ryn_memory_arena FileArena = ryn_memory_CreateArena(Megabytes(16));
+
+        for (file_list *File = WalkDirectory(&FileArena, Directories[I]); File; File = File->Next)
+        {
+            if (!IsHighlightedCodeFile(File->Name.Bytes))
+            {
+                continue;
+            }
+
+            u64 ArenaOffset = TempArena->Offset;
+            u8 *Source = ryn_memory_GetArenaWriteLocation(TempArena);
+            u64 FileSize = ReadFileIntoAllocator(TempArena, File->Name.Bytes);
+            u64 SourceSize = FileSize ? FileSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator. */
+
+            u64 StartTime = ryn_ReadOSTimer();
+            ryn_BEGIN_BANDWIDTH_BLOCK(timed_block_HighlightCode, SourceSize);
+            buffer Html = HighlightCode(TempArena, Source, SourceSize);
+            ryn_END_TIMED_BLOCK(timed_block_HighlightCode);
+            ElapsedMicroseconds += ryn_ReadOSTimer() - StartTime;
+
+            TotalSourceSize += SourceSize;
+            TotalHtmlSize += Html.Size;
+            FileCount += 1;
+            TempArena->Offset = ArenaOffset;
+        }
+
+        ryn_memory_FreeArena(FileArena);
     }
+
+    printf("Highlighted %d files, %llu bytes into %llu bytes of html in %.2fms\n", FileCount,
+           (unsigned long long)TotalSourceSize, (unsigned long long)TotalHtmlSize, (double)ElapsedMicroseconds / 1000.0);
+
+    ryn_memory_ArenaStackPop(TempArena);
 }
 
-internal void GenerateFontData(ryn_memory_arena TempString)
+/* Compile a ~10MB blog, made by repeating a post that uses every kind of line. */
+internal void BenchmarkCompileBlog(ryn_memory_arena *TempArena)
 {
-    /* TODO: Use GenerateByteArray */
-    u8 HexData[16] = {};
-    u64 BeginningOffset = TempString.Offset;
-
-    u8 *FontFilePath = (u8 *)"../assets/Roboto-Regular.ttf";
-    u8 *FontDataPath = (u8 *)"../gen/roboto_regular.h";
+    char *Post =
+        "=== A title with a [link](/somewhere)\n"
+        "--- A smaller title\n"
+        "\n"
+        "A paragraph with some words in it, and [another link](https://example.com/page) in the middle.\n"
+        "#image /assets/scuba.png\n"
+        "- First item\n"
+        "- Second item with a [link](/list)\n"
+        "1. Numbered item\n"
+        "2. Another numbered item\n"
+        "```\n"
+        "    if (A < B && C > D) { return \"escaped\"; }\n"
+        "```\n"
+        "\n";
+    u64 PostSize = GetStringLength((u8 *)Post);
+    u64 SourceSize = 0;
+    s32 RunCount = 8;
 
-    u8 *DataOutput = ryn_memory_GetArenaWriteLocation(&TempString);
-    buffer *Buffer = ReadFileIntoBuffer(FontFilePath);
+    ryn_memory_ArenaStackPush(TempArena);
 
-    PushString(&TempString, (u8 *)"u8 FontData[] = {");
+    u8 *Source = ryn_memory_GetArenaWriteLocation(TempArena);
 
-    for (s32 I = 0; I < Buffer->Size; ++I)
+    while (SourceSize < Megabytes(10))
     {
-        b32 IsLastByte = I == Buffer->Size - 1;
+        ryn_memory_WriteArena(TempArena, (u8 *)Post, PostSize);
+        SourceSize += PostSize;
+    }
 
-        char *FormatString = IsLastByte ? "0x%02x" : "0x%02x,";
+    SetupBlogLineTable();
 
-        sprintf((char *)HexData, FormatString, Buffer->Data[I]);
-        PushString(&TempString, HexData);
+    buffer Html = {0};
+    u64 ArenaOffset = TempArena->Offset;
 
-        if (I != 0 && I % 15 == 0)
-        {
-            PushString(&TempString, (u8 *)"\n");
-        }
+    for (s32 Run = 0; Run < RunCount; ++Run)
+    {
+        TempArena->Offset = ArenaOffset;
+        ryn_BEGIN_BANDWIDTH_BLOCK(timed_block_CompileBlog, SourceSize);
+        Html = CompileBlog(TempArena, Source, SourceSize);
+        ryn_END_TIMED_BLOCK(timed_block_CompileBlog);
     }
-    PushString(&TempString, (u8 *)"};\0");
 
-    u64 FileSize = TempString.Offset - BeginningOffset;
-    WriteFileWithPath(FontDataPath, DataOutput, FileSize);
+    printf("Compiled %llu bytes of blog into %llu bytes of html\n", (unsigned long long)SourceSize, (unsigned long long)Html.Size);
 
-    TempString.Offset = BeginningOffset;
+    ryn_memory_ArenaStackPop(TempArena);
 }
 
-internal void GenerateGameAssets(ryn_memory_arena TempString)
+/* Write a 16MB byte array, about the size of the biggest asset pack, as a C header. */
+internal void BenchmarkGenerateByteArray(ryn_memory_arena *TempArena)
 {
-    /* NOTE: for now GenerateGameAssets just generates assets for scuba. */
-#define AssetPairCount 2
-    char *AssetPairs[AssetPairCount][2] = {
-        {"../assets/scuba.png", "../gen/scuba.h"},
-        {"../assets/influence.png", "../gen/influence.h"}
-    };
-
-    for (s32 I = 0; I < AssetPairCount; ++I)
-    {
-        int TextureWidth, TextureHeight, BitsPerChannel;
-        char *AssetPath = AssetPairs[I][0];
-        char *DataPath = AssetPairs[I][1];
-        u8 *TextureData = stbi_load((char *)AssetPath, &TextureWidth, &TextureHeight, &BitsPerChannel, 0);
+    u64 Size = Megabytes(16);
+    u8 *Path = (u8 *)"../gen/byte_array_benchmark.h";
 
-        if (!TextureData)
-        {
-            LogError("loading scuba texture");
-        }
-        else
-        {
-            /* TODO: compress the asset data!!!!!! */
-            u8 *ScubaOutput = ryn_memory_GetArenaWriteLocation(&TempString);
-            u64 BeginningOffset = TempString.Offset;
-            u8 HexData[16] = {};
-
-            PushString(&TempString, (u8 *)"/* NOTE: The first two u32 values in AssetData are for image-width and image-height respectively. */\n");
-            PushString(&TempString, (u8 *)"u32 AssetData[] = {    \n");
-
-            { /* write texture width/height to data */
-                sprintf((char *)HexData, "0x%08x,", TextureWidth);
-                PushString(&TempString, HexData);
-
-                sprintf((char *)HexData, "0x%08x,", TextureHeight);
-                PushString(&TempString, HexData);
-            }
-
-            for (s32 Y = 0; Y < TextureHeight * 4; ++Y)
-            {
-                for (s32 X = 0; X < TextureWidth; X += 4)
-                {
-                    s32 PixelIndex = Y * TextureWidth + X;
-                    b32 IsLastPixel = PixelIndex - 1 == TextureWidth * TextureHeight;
-
-                    u32 R = TextureData[PixelIndex];
-                    u32 G = TextureData[PixelIndex + 1];
-                    u32 B = TextureData[PixelIndex + 2];
-                    u32 A = TextureData[PixelIndex + 3];
+    ryn_memory_ArenaStackPush(TempArena);
 
-                    u32 Pixel = (R << 24) | (G << 16) | (B << 8) | A;
-                    char *FormatString = IsLastPixel ? "0x%08x" : "0x%08x,";
-                    sprintf((char *)HexData, FormatString, Pixel);
+    u8 *Bytes = ryn_memory_PushSize(TempArena, Size);
 
-                    PushString(&TempString, HexData);
-                }
+    if (Bytes)
+    {
+        for (u64 I = 0; I < Size; ++I)
+        {
+            Bytes[I] = (u8)(HashBytes((u8 *)&I, sizeof(I)) >> 56);
+        }
 
-                PushString(&TempString, (u8 *)"\n    ");
-            }
+        EnsureDirectoryExists((u8 *)"../gen");
 
-            PushString(&TempString, (u8 *)"\n};\0");
+        ryn_BEGIN_BANDWIDTH_BLOCK(timed_block_GenerateByteArray, Size);
+        GenerateByteArray(TempArena, Path, (u8 *)"BenchmarkData", Bytes, Size);
+        ryn_END_TIMED_BLOCK(timed_block_GenerateByteArray);
 
-            u64 FileSize = TempString.Offset - BeginningOffset;
-            WriteFileWithPath((u8 *)DataPath, ScubaOutput, FileSize);
-        }
+        printf("Wrote %llu bytes as a byte array\n", (unsigned long long)Size);
+        remove((char *)Path);
     }
 
-    GenerateFontData(TempString);
-    GenerateSoundData(&TempString);
+    ryn_memory_ArenaStackPop(TempArena);
 }
 
 int main(s32 ArgCount, char **Args)
@@ -275,7 +345,8 @@ int main(s32 ArgCount, char **Args)
     ryn_BEGIN_TIMED_BLOCK(timed_block_Main);
 
     int Result = 0;
-    command_line_arg_type CommandLineArgType = ParseCommandLineArgs(ArgCount, Args);
+    command_line_args CommandLineArgs = ParseCommandLineArgs(ArgCount, Args);
+    command_line_arg_type CommandLineArgType = CommandLineArgs.Valid ? CommandLineArgs.Type : 0;
 
     ryn_memory_arena TempString = ryn_memory_CreateArena(Gigabytes(1));
 
@@ -283,12 +354,60 @@ int main(s32 ArgCount, char **Args)
     {
     case command_line_arg_type_Preprocess:
     {
-        GenerateSite(&TempString);
+        build_manifest Manifest = LoadBuildManifest((u8 *)"../gen/build_manifest.txt", GetSiteGeneratorHash());
+        site_report Report = {0};
+        Report.Manifest = &Manifest;
+
+        GenerateSite(&TempString, &Manifest, &Report);
+
+        BeginSiteStage(&Report, site_stage_Write);
+        WriteBuildManifest(&Manifest);
+        EndSiteStage(&Report, site_stage_Write);
+
+        printf("Site outputs built %d, up-to-date %d\n", Manifest.BuiltCount, Manifest.SkippedCount);
+
+        if (CommandLineArgs.Compress)
+        {
+            BeginSiteStage(&Report, site_stage_Compress);
+            CompressSite((u8 *)"../site");
+            EndSiteStage(&Report, site_stage_Compress);
+        }
+
+        PrintSiteReport(&Report);
+        WriteSiteReportJson(&Report, (u8 *)SITE_REPORT_PATH);
     } break;
     case command_line_arg_type_GameAssets:
     {
         GenerateGameAssets(TempString);
     } break;
+    case command_line_arg_type_Benchmark:
+    {
+        BenchmarkHtmlEscape(&TempString);
+        BenchmarkHighlightCode(&TempString);
+        BenchmarkCompileBlog(&TempString);
+        BenchmarkGenerateByteArray(&TempString);
+    } break;
+    case command_line_arg_type_Compress:
+    {
+        /* NOTE: Separate from preprocess, so it can run after emcc has written the wasm and js into ../site. */
+        CompressSite((u8 *)"../site");
+    } break;
+    case command_line_arg_type_Watch:
+    {
+        /* NOTE: Runs until the process is killed. */
+        WatchSite(&TempString, (u8 *)"../gen/build_manifest.txt");
+    } break;
+    case command_line_arg_type_Serve:
+    {
+        /* NOTE: Runs until the process is killed. */
+        ServeSite(SERVER_PORT);
+    } break;
+    case command_line_arg_type_TokenizerTables:
+    {
+        /* NOTE: Writes into ../src, since everything that includes idi_tokenizer.c needs the tables to build. */
+        SetupTokenizerTable();
+        WriteTokenizerTables(&TempString, (u8 *)"../src/idi_tokenizer_tables.h");
+    } break;
     default:
         printf("Un-handled command line arg type: %d\n", CommandLineArgType);
         break;
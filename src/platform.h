@@ -20,6 +20,16 @@
 #include <string.h>
 #include <unistd.h>
 #include <fts.h>
+#include <pthread.h>
+#include <sched.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/event.h>
+#include <sys/uio.h>
 #endif
 
 
@@ -48,15 +58,38 @@ typedef struct
     FILE *File;
 } file;
 
+typedef struct
+{
+    b32 Exists;
+    u64 Size;
+    u64 ModifiedTime; /* NOTE: Nanoseconds, only meant to be compared against other values from platform_GetFileInfo. */
+} file_info;
+
+/* NOTE: Totals for every file read and written through the platform layer, used for build reports. */
+typedef struct
+{
+    u64 FilesRead;
+    u64 BytesRead;
+    u64 FilesWritten;
+    u64 BytesWritten;
+} io_counters;
+
+global_variable io_counters GlobalIoCounters;
+
 void *AllocateMemory(u64 Size);
 void FreeMemory(void *Ref);
 
+void CountFileRead(u64 Size);
+void CountFileWrite(u64 FileCount, u64 Size);
+io_counters GetIoCounters(void);
+
 void GetResourceUsage(void);
 
 date GetDate(void);
 
 buffer *ReadFileIntoBuffer(u8 *FilePath);
 u64 platform_GetFileSize(u8 *FilePath);
+file_info platform_GetFileInfo(u8 *FilePath);
 u64 ReadFileIntoData(u8 *FilePath, u8 *Bytes, u64 MaxBytes);
 u64 ReadFileIntoAllocator(ryn_memory_arena *Arena, u8 *FilePath);
 void FreeBuffer(buffer *Buffer);
@@ -72,6 +105,14 @@ void EnsurePathDirectoriesExist(u8 *Path);
 
 file_list *WalkDirectory(ryn_memory_arena *Arena, u8 *Path);
 
+void *platform_LoadLibrary(u8 *Name);
+void *platform_GetLibraryProc(void *Library, u8 *Name);
+
+typedef struct directory_watch directory_watch;
+directory_watch *platform_CreateDirectoryWatch(u8 **Paths, s32 PathCount);
+b32 platform_WaitForDirectoryChange(directory_watch *Watch, s32 TimeoutMilliseconds);
+void platform_FreeDirectoryWatch(directory_watch *Watch);
+
 void *AllocateMemory(u64 Size)
 {
     /* just use malloc for now... */
@@ -108,6 +149,45 @@ void GetResourceUsage(void)
 }
 #endif
 
+/* NOTE: Files are read and written from job threads too, so the counters are updated atomically. */
+void CountFileRead(u64 Size)
+{
+#if ryn_memory_Mac
+    __atomic_fetch_add(&GlobalIoCounters.FilesRead, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&GlobalIoCounters.BytesRead, Size, __ATOMIC_RELAXED);
+#else
+    GlobalIoCounters.FilesRead += 1;
+    GlobalIoCounters.BytesRead += Size;
+#endif
+}
+
+void CountFileWrite(u64 FileCount, u64 Size)
+{
+#if ryn_memory_Mac
+    __atomic_fetch_add(&GlobalIoCounters.FilesWritten, FileCount, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&GlobalIoCounters.BytesWritten, Size, __ATOMIC_RELAXED);
+#else
+    GlobalIoCounters.FilesWritten += FileCount;
+    GlobalIoCounters.BytesWritten += Size;
+#endif
+}
+
+io_counters GetIoCounters(void)
+{
+    io_counters Counters;
+
+#if ryn_memory_Mac
+    Counters.FilesRead = __atomic_load_n(&GlobalIoCounters.FilesRead, __ATOMIC_RELAXED);
+    Counters.BytesRead = __atomic_load_n(&GlobalIoCounters.BytesRead, __ATOMIC_RELAXED);
+    Counters.FilesWritten = __atomic_load_n(&GlobalIoCounters.FilesWritten, __ATOMIC_RELAXED);
+    Counters.BytesWritten = __atomic_load_n(&GlobalIoCounters.BytesWritten, __ATOMIC_RELAXED);
+#else
+    Counters = GlobalIoCounters;
+#endif
+
+    return Counters;
+}
+
 date GetDate(void)
 {
     date Date;
@@ -158,6 +238,7 @@ buffer *ReadFileIntoBuffer(u8 *FilePath)
     Buffer->Data = AllocateMemory(Buffer->Size + 1);
     fread(Buffer->Data, 1, Buffer->Size, File);
     Buffer->Data[Buffer->Size] = 0; // null terminate
+    CountFileRead(Buffer->Size);
 
     fclose(File);
 
@@ -207,6 +288,31 @@ u64 platform_GetFileSize(u8 *FilePath)
 }
 #endif
 
+#if ryn_memory_Windows
+file_info platform_GetFileInfo(u8 *FilePath)
+{
+    Assert(0);
+    file_info FileInfo = {0};
+    return FileInfo;
+}
+#elif ryn_memory_Mac
+file_info platform_GetFileInfo(u8 *FilePath)
+{
+    file_info FileInfo = {0};
+    struct stat StatResult;
+    int StatError = stat((char *)FilePath, &StatResult);
+
+    if (!StatError)
+    {
+        FileInfo.Exists = 1;
+        FileInfo.Size = StatResult.st_size;
+        FileInfo.ModifiedTime = (u64)StatResult.st_mtimespec.tv_sec * 1000000000 + (u64)StatResult.st_mtimespec.tv_nsec;
+    }
+
+    return FileInfo;
+}
+#endif
+
 u64 ReadFileIntoData(u8 *FilePath, u8 *Bytes, u64 MaxBytes)
 {
     u64 FileSize = platform_GetFileSize(FilePath);
@@ -226,6 +332,7 @@ u64 ReadFileIntoData(u8 *FilePath, u8 *Bytes, u64 MaxBytes)
 
     fread(Bytes, 1, FileSize, File);
     fclose(File);
+    CountFileRead(FileSize);
 
     return FileSize;
 }
@@ -250,6 +357,7 @@ u64 ReadFileIntoAllocator(ryn_memory_arena *Allocator, u8 *FilePath)
 
         Data[FileSize - 1] = 0; /* Null-terminate just to be safe... */
         BytesWritten = FileSize;
+        CountFileRead(FileSize - 1);
         Allocator->Offset += BytesWritten;
     }
 
@@ -270,6 +378,7 @@ void WriteFileWithPath(u8 *FilePath, u8 *Data, size Size)
     {
         fwrite(Data, 1, Size, File);
         fclose(File);
+        CountFileWrite(1, Size);
     }
     else
     {
@@ -286,6 +395,10 @@ file platform_OpenFile(u8 *FilePath)
     {
         printf("Error in platform_OpenFile: trying to open file \"%s\"\n", FilePath);
     }
+    else
+    {
+        CountFileWrite(1, 0);
+    }
 
     return File;
 }
@@ -298,6 +411,7 @@ void CloseFile(file File)
 void platform_WriteFile(file File, u8 *Data, u64 Size)
 {
     fwrite(Data, 1, Size, File.File);
+    CountFileWrite(0, Size);
 }
 
 void WriteFileFromBuffer(u8 *FilePath, buffer *Buffer)
@@ -408,8 +522,8 @@ file_list *WalkDirectory(ryn_memory_arena *Arena, u8 *Path)
 
                 if (IsWalkableFile(FilePath))
                 {
-                    b32 IsFirstAllocation = Arena->Offset == 0;
                     file_list *FileItem = ryn_memory_PushZeroStruct(Arena, file_list);
+                    b32 IsFirstAllocation = FileItem == Result;
                     s32 FilePathLength = GetStringLength(FilePath) + 1;
                     FileItem->Name.Bytes = PushString_(Arena, FilePath, FilePathLength);
                     FileItem->Name.Bytes[FilePathLength-1] = 0;
@@ -448,4 +562,178 @@ file_list *WalkDirectory(ryn_memory_arena *Arena, u8 *Path)
 
     return Result;
 }
-#endif
\ No newline at end of file
+#endif
+
+#if ryn_memory_Windows
+void *platform_LoadLibrary(u8 *Name)
+{
+    return 0;
+}
+
+void *platform_GetLibraryProc(void *Library, u8 *Name)
+{
+    return 0;
+}
+#elif ryn_memory_Mac
+/* NOTE: Returns 0 if the library isn't installed, callers are expected to carry on without it. */
+void *platform_LoadLibrary(u8 *Name)
+{
+    void *Library = dlopen((char *)Name, RTLD_NOW | RTLD_LOCAL);
+    return Library;
+}
+
+void *platform_GetLibraryProc(void *Library, u8 *Name)
+{
+    void *Proc = dlsym(Library, (char *)Name);
+    return Proc;
+}
+#endif
+
+/*
+  Directory watches report that something under a set of directories changed, not what changed.
+  Callers are expected to work out what is stale themselves, e.g. from the build manifest.
+  platform_WaitForDirectoryChange returns 1 if there was a change, or 0 if the timeout ran out
+  first. A negative timeout waits forever.
+*/
+#define DIRECTORY_WATCH_PATH_MAX 8
+#define DIRECTORY_WATCH_FILE_MAX 4096
+
+#if ryn_memory_Windows
+directory_watch *platform_CreateDirectoryWatch(u8 **Paths, s32 PathCount)
+{
+    printf("TODO: Implement platform_CreateDirectoryWatch for Windows.\n");
+    return 0;
+}
+
+b32 platform_WaitForDirectoryChange(directory_watch *Watch, s32 TimeoutMilliseconds)
+{
+    return 0;
+}
+
+void platform_FreeDirectoryWatch(directory_watch *Watch)
+{
+}
+#elif ryn_memory_Mac
+#ifndef O_EVTONLY
+#define O_EVTONLY O_RDONLY
+#endif
+
+struct directory_watch
+{
+    s32 Queue;
+    s32 PathCount;
+    u8 *Paths[DIRECTORY_WATCH_PATH_MAX];
+    s32 FileCount;
+    s32 Files[DIRECTORY_WATCH_FILE_MAX];
+};
+
+/* NOTE: kqueue watches open files. Directories are watched too, to see files being added, removed
+   or replaced (editors often save by renaming a new file over the old one). Each event's udata
+   says whether it came from a directory, since only those need everything to be opened again. */
+internal void AddDirectoryWatches(directory_watch *Watch)
+{
+    for (s32 I = 0; I < Watch->FileCount; ++I)
+    {
+        close(Watch->Files[I]);
+    }
+
+    Watch->FileCount = 0;
+
+    for (s32 I = 0; I < Watch->PathCount; ++I)
+    {
+        char *Paths[] = { (char *)Watch->Paths[I], 0 };
+        FTS *Fts = fts_open(Paths, FTS_PHYSICAL | FTS_NOCHDIR | FTS_XDEV, 0);
+
+        if (!Fts)
+        {
+            printf("Error in AddDirectoryWatches: error calling fts_open on \"%s\"\n", Watch->Paths[I]);
+            continue;
+        }
+
+        FTSENT *Entry;
+        while ((Entry = fts_read(Fts)) != 0)
+        {
+            if (Entry->fts_info != FTS_D && Entry->fts_info != FTS_F)
+            {
+                continue;
+            }
+            else if (Watch->FileCount >= DIRECTORY_WATCH_FILE_MAX)
+            {
+                printf("Error in AddDirectoryWatches: too many files, not watching \"%s\"\n", Entry->fts_path);
+                continue;
+            }
+
+            s32 File = open(Entry->fts_path, O_EVTONLY);
+
+            if (File >= 0)
+            {
+                struct kevent Change;
+                u32 Flags = NOTE_WRITE | NOTE_EXTEND | NOTE_DELETE | NOTE_RENAME;
+                void *IsDirectory = (void *)(size)(Entry->fts_info == FTS_D);
+                EV_SET(&Change, File, EVFILT_VNODE, EV_ADD | EV_CLEAR, Flags, 0, IsDirectory);
+                kevent(Watch->Queue, &Change, 1, 0, 0, 0);
+                Watch->Files[Watch->FileCount++] = File;
+            }
+        }
+
+        fts_close(Fts);
+    }
+}
+
+directory_watch *platform_CreateDirectoryWatch(u8 **Paths, s32 PathCount)
+{
+    directory_watch *Watch = AllocateMemory(sizeof(directory_watch));
+    SetMemory((u8 *)Watch, 0, sizeof(directory_watch));
+
+    Watch->Queue = kqueue();
+    Watch->PathCount = PathCount < DIRECTORY_WATCH_PATH_MAX ? PathCount : DIRECTORY_WATCH_PATH_MAX;
+
+    if (Watch->Queue < 0)
+    {
+        printf("Error in platform_CreateDirectoryWatch: kqueue failed\n");
+        FreeMemory(Watch);
+        return 0;
+    }
+
+    for (s32 I = 0; I < Watch->PathCount; ++I)
+    {
+        Watch->Paths[I] = Paths[I];
+    }
+
+    AddDirectoryWatches(Watch);
+
+    return Watch;
+}
+
+b32 platform_WaitForDirectoryChange(directory_watch *Watch, s32 TimeoutMilliseconds)
+{
+    struct kevent Events[64];
+    struct timespec Timeout = { TimeoutMilliseconds / 1000, (TimeoutMilliseconds % 1000) * 1000000 };
+    s32 EventCount = kevent(Watch->Queue, 0, 0, Events, ArrayCount(Events), TimeoutMilliseconds < 0 ? 0 : &Timeout);
+    b32 Changed = EventCount > 0;
+    b32 DirectoryChanged = 0;
+
+    for (s32 I = 0; I < EventCount; ++I)
+    {
+        DirectoryChanged |= Events[I].udata != 0;
+    }
+
+    if (DirectoryChanged)
+    {
+        AddDirectoryWatches(Watch);
+    }
+
+    return Changed;
+}
+
+void platform_FreeDirectoryWatch(directory_watch *Watch)
+{
+    for (s32 I = 0; I < Watch->FileCount; ++I)
+    {
+        close(Watch->Files[I]);
+    }
+
+    close(Watch->Queue);
+    FreeMemory(Watch);
+}
+#endif
@@ -1,4 +1,5 @@
 #define IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+#define HERE_DOC_CHAR '#'
 
 typedef enum
 {
@@ -15,13 +16,66 @@ typedef struct
 } pre_processor_command;
 
 #define PRE_PROCESSOR_COMMAND_MAX 16
-#define PRE_PROCESSOR_VARIABLE_MAX 64
+#define VARIABLE_SLOT_COUNT 256 /* NOTE: Must be a power of two. */
+#define INCLUDE_CACHE_SLOT_COUNT 256 /* NOTE: Must be a power of two. */
 
-typedef struct
+typedef struct pre_processor_variable pre_processor_variable;
+struct pre_processor_variable
 {
+    pre_processor_variable *NextInSlot;
+    pre_processor_variable *PreviouslySet; /* NOTE: Every variable in a table, newest first, so scopes can be popped. */
+    u64 KeyHash;
     u8 *Key;
-    u8 *Value;
-} pre_processor_variable;
+    u8 *Value; /* NOTE: Not copied, it must outlive the scope it is set in. */
+    u64 Size;
+    s32 Depth; /* NOTE: 0 for globals. */
+};
+
+typedef struct variable_scope variable_scope;
+struct variable_scope
+{
+    variable_scope *Previous;
+    pre_processor_variable *LastSet;
+    u64 ArenaOffset;
+};
+
+/* Variables are hashed into slots, and a variable set in an inner scope is put in front of any
+   outer variable with the same key. Popping a scope unlinks its variables and gives their memory
+   back to the arena. A table with a Parent falls back to it for keys it doesn't have, which is how
+   page jobs get their own frame on top of the shared, read-only globals. */
+typedef struct variable_table variable_table;
+struct variable_table
+{
+    variable_table *Parent;
+    ryn_memory_arena Arena; /* NOTE: Holds keys, variables and scopes, values are not copied. */
+    pre_processor_variable *Slots[VARIABLE_SLOT_COUNT];
+    pre_processor_variable *LastSet;
+    variable_scope *Scope;
+    s32 Depth;
+};
+
+typedef struct
+{
+    u8 *Path; /* NOTE: Interned in the include-cache arena. */
+    u64 PathHash;
+    u64 Size;
+    u64 ModifiedTime;
+    u64 ContentHash;
+    u8 *Data;
+} include_cache_entry;
+
+/* Include files are read once per run and served from memory after that. Entries are re-validated
+   against the file's size and modified-time on every lookup, so edits made during a run are picked up.
+   Lookups may come from page jobs on several threads, so the cache is guarded by a mutex. */
+typedef struct
+{
+    ticket_mutex Mutex;
+    ryn_memory_arena Arena;
+    include_cache_entry Entries[INCLUDE_CACHE_SLOT_COUNT];
+    s32 EntryCount;
+    s32 HitCount;
+    s32 MissCount;
+} include_cache;
 
 typedef struct
 {
@@ -30,13 +84,82 @@ typedef struct
     u8 *Ket;
     s32 KetCount;
     pre_processor_command Commands[PRE_PROCESSOR_COMMAND_MAX];
-    pre_processor_variable Variables[PRE_PROCESSOR_VARIABLE_MAX];
+    variable_table *Variables;
     s32 CommandCount;
 
     ryn_memory_arena StringAllocator;
     ryn_memory_arena OutputAllocator;
+
+    build_manifest *Manifest;
+    include_cache *IncludeCache;
+    b32 StreamOutput;
 } pre_processor;
 
+typedef struct
+{
+    /* NOTE: Output goes to Arena when it is set, otherwise it is streamed to File. */
+    ryn_memory_arena *Arena;
+    file File;
+    u64 Size;
+    b32 Error;
+} template_output;
+
+typedef enum
+{
+    template_op_Undefined,
+    template_op_Literal,         /* Data/Size is a slice of the template source. */
+    template_op_HereDoc,         /* Data/Size is the here-doc body, also a slice of the template source. */
+    template_op_IncludeFile,     /* Data is the null-terminated include path. */
+    template_op_IncludeVariable, /* Data is the null-terminated variable name, without the '$'. */
+    template_op_Count,
+} template_op_type;
+
+typedef struct template_op template_op;
+struct template_op
+{
+    template_op *Next;
+    template_op_type Type;
+    u8 *Data;
+    u64 Size;
+};
+
+typedef struct
+{
+    template_op *FirstOp;
+    template_op *LastOp;
+    s32 OpCount;
+    b32 Error;
+} template;
+
+typedef enum
+{
+    page_job_type_Undefined,
+    page_job_type_Code,
+    page_job_type_Blog,
+    page_job_type_Count,
+} page_job_type;
+
+/* NOTE: One page generated on the job system. Everything a job writes lives in the job itself or its worker's scratch arena. */
+typedef struct page_job page_job;
+struct page_job
+{
+    page_job *Next;
+    page_job_type Type;
+    pre_processor *PreProcessor; /* NOTE: Read-only inside the job. */
+    template *Template;
+    u8 *SourcePath;
+    u8 *OutputPath;
+    build_manifest Manifest;
+    ryn_memory_arena *ScratchArenas; /* NOTE: One per job-system participant, reset at the start of every job. */
+    b32 Error;
+};
+
+typedef struct
+{
+    page_job *First;
+    page_job *Last;
+} page_job_list;
+
 typedef enum
 {
     command_result_Undefined,
@@ -54,14 +177,19 @@ typedef enum
     blog_line_type_Header,
     blog_line_type_SubHeader,
     blog_line_type_Image,
+    blog_line_type_ListItem,
+    blog_line_type_NumberedListItem,
+    blog_line_type_CodeFence,
     blog_line_type_Count,
 } blog_line_type;
 
 
-b32 PreprocessFile(pre_processor *PreProcessor, ryn_memory_arena TempString, u8 *FilePath, u8 *OutputFilePath);
-void GenerateSite(ryn_memory_arena *TempString);
+b32 PreprocessFile(pre_processor *PreProcessor, u8 *FilePath, u8 *OutputFilePath);
+void GenerateSite(ryn_memory_arena *TempString, build_manifest *Manifest, site_report *Report);
+void WatchSite(ryn_memory_arena *TempString, u8 *ManifestPath);
 
-u8 *BlogPageTemplateOpen =
+/* NOTE: Page layouts are compiled once per run and executed for every page with BlogHtml bound. */
+u8 *BlogPageTemplate =
     (u8 *)"<!doctype html>"                        \
     "<html lang=\"en-us\">"                        \
     "<head>"                                       \
@@ -72,116 +200,319 @@ u8 *BlogPageTemplateOpen =
     "<body>"                                       \
     /* TODO: Remove hard-coded style */
     "<main style=\"padding: 1rem;\">"              \
-    "{| include ../src/layout/navigation_header.html |}";
+    "{| include ../src/layout/navigation_header.html |}" \
+    "{| include $BlogHtml |}"                      \
+    "</main>"                                      \
+    "</body>"                                      \
+    "</html>";
 
-u8 *BlogPageTemplateClose =
-    (u8 *)"</main>"                             \
-    "</body>"                                   \
+/* NOTE: Executed for every source file with CodePagePath and CodePageSource bound. */
+u8 *CodePageTemplate =
+    (u8 *)"<!doctype html>"                                              \
+    "<html lang=\"en-us\">"                                              \
+        "<head>"                                                         \
+            "{| include ../src/layout/head_common.html |}"               \
+            "<style>"                                                    \
+                "{| include ../src/layout/code_page_style.css |}"        \
+            "</style>"                                                   \
+        "</head>"                                                        \
+        "<body>"                                                         \
+    /* TODO: move hard-coded style */
+            "<main style=\"padding: 1rem\">"                             \
+                "{| include ../src/layout/navigation_header.html |}"     \
+                    "<h2>{| include $CodePagePath |}</h2>"               \
+                    "<pre>{| include $CodePageSource |}</pre>"           \
+            "</main>"                                                    \
+        "</body>"                                                        \
     "</html>";
 
+/* NOTE: Bump SITE_GENERATOR_VERSION whenever a change to the generator changes its output for the same inputs. */
+#define SITE_GENERATOR_VERSION 5
+
+internal u64 GetSiteGeneratorHash(void)
+{
+    u64 Hashes[3] = {SITE_GENERATOR_VERSION, HashBytes(BlogPageTemplate, GetStringLength(BlogPageTemplate)),
+                     HashBytes(CodePageTemplate, GetStringLength(CodePageTemplate))};
+    u64 Hash = HashBytes((u8 *)Hashes, sizeof(Hashes));
+    return Hash;
+}
+
 
 
-internal void SkipSpace(buffer *Buffer, s32 *Index)
+internal variable_table *CreateVariableTable(ryn_memory_arena *Arena, variable_table *Parent, u64 Size)
 {
-    while (*Index < Buffer->Size)
+    variable_table *Table = ryn_memory_PushZeroStruct(Arena, variable_table);
+
+    if (Table)
     {
-        if (!IS_SPACE(Buffer->Data[*Index]))
-        {
-            break;
-        }
-        else
-        {
-            *Index += 1;
-        }
+        Table->Arena = ryn_memory_CreateSubArena(Arena, Size);
+        Table->Parent = Parent;
+        Table->Depth = Parent ? Parent->Depth + 1 : 0;
+    }
+    else
+    {
+        LogError("allocating variable table");
     }
+
+    return Table;
 }
 
-internal s32 StringMatchLength(u8 *StringA, u8 *StringB, u64 MaxBytes)
-{    u32 I = 0;
+internal pre_processor_variable *FindVariable(variable_table *Table, u8 *Key)
+{
+    pre_processor_variable *Result = 0;
+    u64 KeyHash = HashCString(Key);
 
-    if (StringA && StringB)
+    for (; Table && !Result; Table = Table->Parent)
     {
-        while (I < MaxBytes && StringA[I] && StringB[I])
+        pre_processor_variable *Variable = Table->Slots[KeyHash & (VARIABLE_SLOT_COUNT - 1)];
+
+        for (; Variable; Variable = Variable->NextInSlot)
         {
-            if (StringA[I] == StringB[I])
-            {
-                I += 1;
-            }
-            else
+            if (Variable->KeyHash == KeyHash && StringsEqual(Variable->Key, Key))
             {
+                Result = Variable;
                 break;
             }
         }
     }
 
-    return I;
+    return Result;
 }
 
-internal u8 *GetPreprocessVariable(pre_processor *PreProcessor, u8 *Key)
+/* Set a variable in the table's current scope, hiding any variable with the same key from an outer scope. */
+internal b32 SetVariable(variable_table *Table, u8 *Key, u8 *Value, u64 Size)
 {
-    u8 *Value = 0;
+    b32 ErrorCode = 0;
+    u64 KeyHash = HashCString(Key);
+    pre_processor_variable **Slot = &Table->Slots[KeyHash & (VARIABLE_SLOT_COUNT - 1)];
+    pre_processor_variable *Variable = *Slot;
 
-    for (s32 I = 0; I < PRE_PROCESSOR_VARIABLE_MAX; ++I)
+    /* NOTE: Variables from the current scope are always in front of the slot, so only those need to be checked. */
+    for (; Variable && Variable->Depth == Table->Depth; Variable = Variable->NextInSlot)
     {
-        pre_processor_variable Variable = PreProcessor->Variables[I];
-
-        if (Variable.Key)
+        if (Variable->KeyHash == KeyHash && StringsEqual(Variable->Key, Key))
         {
-            if (StringsEqual(Variable.Key, Key))
-            {
-                Value = Variable.Value;
-                break;
-            }
+            break;
         }
-        else
+    }
+
+    if (!Variable || Variable->Depth != Table->Depth)
+    {
+        Variable = ryn_memory_PushZeroStruct(&Table->Arena, pre_processor_variable);
+
+        if (!Variable)
         {
-            break;
+            LogError("allocating pre-processor variable");
+            ErrorCode = 1;
+            return ErrorCode;
         }
+
+        Variable->Key = PushCString(&Table->Arena, Key);
+        Variable->KeyHash = KeyHash;
+        Variable->Depth = Table->Depth;
+        Variable->NextInSlot = *Slot;
+        Variable->PreviouslySet = Table->LastSet;
+        *Slot = Variable;
+        Table->LastSet = Variable;
+    }
+
+    Variable->Value = Value;
+    Variable->Size = Size;
+
+    return ErrorCode;
+}
+
+internal void PushVariableScope(variable_table *Table)
+{
+    u64 ArenaOffset = Table->Arena.Offset;
+    variable_scope *Scope = ryn_memory_PushZeroStruct(&Table->Arena, variable_scope);
+
+    if (Scope)
+    {
+        Scope->Previous = Table->Scope;
+        Scope->LastSet = Table->LastSet;
+        Scope->ArenaOffset = ArenaOffset;
+        Table->Scope = Scope;
+        Table->Depth += 1;
+    }
+    else
+    {
+        LogError("allocating variable scope");
+    }
+}
+
+/* Drop every variable set since the matching PushVariableScope. */
+internal void PopVariableScope(variable_table *Table)
+{
+    variable_scope *Scope = Table->Scope;
+    Assert(Scope != 0);
+
+    while (Table->LastSet != Scope->LastSet)
+    {
+        pre_processor_variable *Variable = Table->LastSet;
+        pre_processor_variable **Slot = &Table->Slots[Variable->KeyHash & (VARIABLE_SLOT_COUNT - 1)];
+
+        /* NOTE: Newer variables were unlinked first, so this one is at the front of its slot. */
+        Assert(*Slot == Variable);
+        *Slot = Variable->NextInSlot;
+        Table->LastSet = Variable->PreviouslySet;
     }
+
+    Table->Scope = Scope->Previous;
+    Table->Depth -= 1;
+    Table->Arena.Offset = Scope->ArenaOffset;
+}
+
+internal u8 *GetPreprocessVariable(pre_processor *PreProcessor, u8 *Key)
+{
+    pre_processor_variable *Variable = FindVariable(PreProcessor->Variables, Key);
+    u8 *Value = Variable ? Variable->Value : 0;
     return Value;
 }
 
 internal b32 SetPreprocessVariable(pre_processor *PreProcessor, u8 *Key, u8 *Value)
 {
-    b32 ErrorCode = 0;
-    b32 HasSet = 0;
-    s32 FirstOpenIndex = -1;
+    b32 ErrorCode = SetVariable(PreProcessor->Variables, Key, Value, GetStringLength(Value));
+    return ErrorCode;
+}
+
+/* Check the manifest to see if an output's recorded inputs are unchanged. Up-to-date records are carried over to the new manifest. */
+internal b32 IsBuildOutputCurrent(pre_processor *PreProcessor, u8 *OutputPath)
+{
+    build_manifest *Manifest = PreProcessor->Manifest;
+    build_record *OldRecord = FindBuildRecord(Manifest, OutputPath);
+    b32 IsCurrent = OldRecord && OldRecord->InputCount > 0 && platform_GetFileInfo(OutputPath).Exists;
+
+    for (s32 I = 0; IsCurrent && I < OldRecord->InputCount; ++I)
+    {
+        build_input *Input = &OldRecord->Inputs[I];
+
+        switch (Input->Type)
+        {
+        case build_input_type_File:
+        {
+            IsCurrent = IsFileInputCurrent(Manifest, Input);
+        } break;
+        case build_input_type_Variable:
+        {
+            u8 *Value = GetPreprocessVariable(PreProcessor, Input->Name);
+            u64 Hash = Value ? HashCString(Value) : 0;
+            IsCurrent = Hash == Input->Hash;
+        } break;
+        default:
+        {
+            IsCurrent = 0;
+        } break;
+        }
+    }
+
+    if (IsCurrent)
+    {
+        KeepBuildRecord(Manifest, OldRecord);
+    }
+
+    return IsCurrent;
+}
+
+internal include_cache *CreateIncludeCache(void)
+{
+    ryn_memory_arena Arena = ryn_memory_CreateArena(Megabytes(256));
+    include_cache *Cache = ryn_memory_PushZeroStruct(&Arena, include_cache);
+
+    if (Cache)
+    {
+        Cache->Arena = Arena;
+    }
+
+    return Cache;
+}
+
+/* Look up an include file, reading it if it is not cached or has changed. The entry is copied out
+   while the cache is locked, since another thread may replace it afterwards. */
+internal b32 LoadIncludeFile(include_cache *Cache, u8 *Path, include_cache_entry *Include)
+{
+    include_cache_entry *Result = 0;
+    file_info FileInfo = platform_GetFileInfo(Path);
+
+    if (!FileInfo.Exists)
+    {
+        return 0;
+    }
 
-    for (s32 I = 0; I < PRE_PROCESSOR_VARIABLE_MAX; ++I)
+    BeginTicketMutex(&Cache->Mutex);
+
+    s32 PathLength = GetStringLength(Path);
+    u64 PathHash = HashBytes(Path, PathLength);
+    u32 Mask = INCLUDE_CACHE_SLOT_COUNT - 1;
+
+    for (u32 Probe = 0; Probe < INCLUDE_CACHE_SLOT_COUNT; ++Probe)
     {
-        pre_processor_variable *Variable = &PreProcessor->Variables[I];
+        include_cache_entry *Entry = &Cache->Entries[(PathHash + Probe) & Mask];
 
-        if (Variable->Key)
+        if (!Entry->Path)
         {
-            if (StringsEqual(Variable->Key, Key))
+            Entry->Path = ryn_memory_PushSize(&Cache->Arena, PathLength + 1);
+
+            if (!Entry->Path)
             {
-                Variable->Value = Value;
-                HasSet = 1;
                 break;
             }
+
+            core_CopyMemory(Path, Entry->Path, PathLength + 1);
+            Entry->PathHash = PathHash;
+            Cache->EntryCount += 1;
+            Result = Entry;
+            break;
         }
-        else if (FirstOpenIndex < 0)
+        else if (Entry->PathHash == PathHash && StringsEqual(Entry->Path, Path))
         {
-            FirstOpenIndex = I;
+            Result = Entry;
+            break;
         }
     }
 
-    if (!HasSet && FirstOpenIndex >= 0)
+    if (!Result)
+    {
+        LogError("include cache is full");
+    }
+    else if (Result->Data && Result->Size == FileInfo.Size && Result->ModifiedTime == FileInfo.ModifiedTime)
     {
-        PreProcessor->Variables[FirstOpenIndex].Key = Key;
-        PreProcessor->Variables[FirstOpenIndex].Value = Value;
-        HasSet = 1;
+        Cache->HitCount += 1;
+    }
+    else
+    {
+        /* NOTE: Stale data is left in the arena, which is fine since include files rarely change during a run. */
+        u8 *Data = ryn_memory_PushSize(&Cache->Arena, FileInfo.Size + 1);
+        u64 BytesRead = Data ? ReadFileIntoData(Path, Data, FileInfo.Size) : 0;
+
+        Cache->MissCount += 1;
+
+        if (Data && (BytesRead == FileInfo.Size))
+        {
+            Data[FileInfo.Size] = 0;
+            Result->Data = Data;
+            Result->Size = FileInfo.Size;
+            Result->ModifiedTime = FileInfo.ModifiedTime;
+            Result->ContentHash = HashBytes(Data, FileInfo.Size);
+        }
+        else
+        {
+            Result->Data = 0;
+            Result = 0;
+        }
     }
 
-    if (!HasSet)
+    if (Result)
     {
-        ErrorCode = 1;
+        *Include = *Result;
     }
 
-    return ErrorCode;
+    EndTicketMutex(&Cache->Mutex);
+
+    return Result != 0;
 }
 
-internal pre_processor CreatePreProcessor(u8 *Bra, u8 *Ket)
+internal pre_processor CreatePreProcessor(u8 *Bra, u8 *Ket, build_manifest *Manifest)
 {
     pre_processor PreProcessor;
 
@@ -192,12 +523,9 @@ internal pre_processor CreatePreProcessor(u8 *Bra, u8 *Ket)
     PreProcessor.KetCount = GetStringLength(Ket);
 
     PreProcessor.CommandCount = 0;
-
-    for (s32 I = 0; I < PRE_PROCESSOR_VARIABLE_MAX; ++I)
-    {
-        PreProcessor.Variables[I].Key = 0;
-        PreProcessor.Variables[I].Value = 0;
-    }
+    PreProcessor.Manifest = Manifest;
+    PreProcessor.IncludeCache = CreateIncludeCache();
+    PreProcessor.StreamOutput = 1;
 
     { /* allocator setup */
         u64 StringAllocatorVirtualSize = Gigabytes(1);
@@ -208,6 +536,9 @@ internal pre_processor CreatePreProcessor(u8 *Bra, u8 *Ket)
         PreProcessor.OutputAllocator = ryn_memory_CreateSubArena(&PreProcessor.StringAllocator, OutputBufferVirtualSize);
     }
 
+    /* NOTE: The table gets its own sub-arena, so popping a scope can't free anything else. */
+    PreProcessor.Variables = CreateVariableTable(&PreProcessor.StringAllocator, 0, Megabytes(64));
+
     return PreProcessor;
 }
 
@@ -223,383 +554,406 @@ internal void AddPreProcessorCommand(pre_processor *PreProcessor, pre_processor_
     PreProcessor->CommandCount += 1;
 }
 
-internal b32 CheckIfStringIsPrefix(u8 *String, buffer *Buffer, s32 BufferOffset)
+/* Find the first occurrence of Pattern in Data, jumping between candidates with memchr. Returns -1 if there is no match. */
+internal s64 FindBytes(u8 *Data, s64 Size, u8 *Pattern, s64 PatternSize)
 {
-    b32 IsPrefix = 1;
-    s32 StringLength = GetStringLength(String);
+    s64 Result = -1;
+    s64 Offset = 0;
 
-    if ((Buffer->Size - BufferOffset) >= StringLength)
+    while (PatternSize > 0 && Offset + PatternSize <= Size)
     {
-        for (s32 I = 0; I < StringLength; I++)
+        u8 *Candidate = memchr(Data + Offset, Pattern[0], Size - Offset - PatternSize + 1);
+
+        if (!Candidate)
         {
-            if (String[I] != Buffer->Data[BufferOffset + I])
-            {
-                IsPrefix = 0;
-                break;
-            }
+            break;
+        }
+
+        s64 CandidateOffset = Candidate - Data;
+
+        if (memcmp(Candidate, Pattern, PatternSize) == 0)
+        {
+            Result = CandidateOffset;
+            break;
         }
+
+        Offset = CandidateOffset + 1;
     }
-    else
+
+    return Result;
+}
+
+internal void EmitTemplateSlice(template_output *Output, u8 *Data, u64 Size)
+{
+    if (Size == 0)
+    {
+        return;
+    }
+
+    if (Output->Arena)
+    {
+        u8 *Destination = ryn_memory_PushSize(Output->Arena, Size);
+
+        if (Destination)
+        {
+            memcpy(Destination, Data, Size);
+        }
+        else
+        {
+            Output->Error = 1;
+        }
+    }
+    else if (Output->File.File)
+    {
+        platform_WriteFile(Output->File, Data, Size);
+    }
+
+    Output->Size += Size;
+}
+
+internal s32 SkipSpaceInSlice(u8 *Data, s32 Size, s32 Index)
+{
+    while (Index < Size && IS_SPACE(Data[Index]))
     {
-        IsPrefix = 0;
+        Index += 1;
     }
 
-    return IsPrefix;
+    return Index;
 }
 
-internal buffer GetCommandToken(pre_processor *PreProcessor, buffer *Buffer, s32 Offset)
+/* Copy the first space-delimited token of a command into the arena, so it can be used as a null-terminated path or key. */
+internal buffer GetCommandToken(ryn_memory_arena *Arena, u8 *Command, s32 CommandSize, s32 Offset)
 {
     buffer TokenBuffer;
     TokenBuffer.Size = 0;
     TokenBuffer.Data = 0;
 
-    SkipSpace(Buffer, &Offset);
+    Offset = SkipSpaceInSlice(Command, CommandSize, Offset);
 
-    for (; TokenBuffer.Size < Buffer->Size - Offset; TokenBuffer.Size++)
+    while (Offset + TokenBuffer.Size < CommandSize && !IS_SPACE(Command[Offset + TokenBuffer.Size]))
     {
-        b32 IsKet = CheckIfStringIsPrefix(PreProcessor->Ket, Buffer, TokenBuffer.Size);
-        b32 IsSpace = IS_SPACE(Buffer->Data[Offset + TokenBuffer.Size]);
-
-        if (IsKet || IsSpace)
-        {
-            ryn_memory_arena *StringAllocator = &PreProcessor->StringAllocator;
-            TokenBuffer.Data = StringAllocator->Data + StringAllocator->Offset;
+        TokenBuffer.Size += 1;
+    }
 
-            b32 WriteError = ryn_memory_WriteArena(StringAllocator, Buffer->Data + Offset, TokenBuffer.Size + 1);
+    TokenBuffer.Data = ryn_memory_PushSize(Arena, TokenBuffer.Size + 1);
 
-            if (!WriteError)
-            {
-                TokenBuffer.Data[TokenBuffer.Size] = 0;
-            }
-            break;
-        }
+    if (TokenBuffer.Data)
+    {
+        memcpy(TokenBuffer.Data, Command + Offset, TokenBuffer.Size);
+        TokenBuffer.Data[TokenBuffer.Size] = 0;
     }
 
     return TokenBuffer;
 }
 
-internal b32 HandlePreProcessCommand(pre_processor *PreProcessor, buffer *Buffer, s32 Offset, s32 CommandSize)
+internal void PushTemplateOp(ryn_memory_arena *Arena, template *Template, template_op_type Type, u8 *Data, u64 Size)
+{
+    if (Size == 0 && (Type == template_op_Literal || Type == template_op_HereDoc))
+    {
+        return;
+    }
+
+    template_op *Op = ryn_memory_PushZeroStruct(Arena, template_op);
+
+    if (!Op)
+    {
+        LogError("pushing template op");
+        Template->Error = 1;
+        return;
+    }
+
+    Op->Type = Type;
+    Op->Data = Data;
+    Op->Size = Size;
+
+    if (Template->LastOp)
+    {
+        Template->LastOp->Next = Op;
+    }
+    else
+    {
+        Template->FirstOp = Op;
+    }
+
+    Template->LastOp = Op;
+    Template->OpCount += 1;
+}
+
+/* Compile the text between Bra and Ket. Returns 0 if the text is not a known command. */
+internal b32 CompileTemplateCommand(pre_processor *PreProcessor, ryn_memory_arena *Arena, template *Template, u8 *Command, s32 CommandSize)
 {
-    s32 Index = Offset;
-    s32 MaxIndex = Offset + CommandSize;
     u8 *IncludeName = (u8 *)"include";
-    ryn_memory_arena *OutputAllocator = &PreProcessor->OutputAllocator;
+    s32 IncludeNameLength = GetStringLength(IncludeName);
     b32 CommandWasHandled = 0;
 
-    SkipSpace(Buffer, &Index);
+    s32 Index = SkipSpaceInSlice(Command, CommandSize, 0);
+    b32 IsInclude = (Index + IncludeNameLength < CommandSize &&
+                     memcmp(Command + Index, IncludeName, IncludeNameLength) == 0 &&
+                     IS_SPACE(Command[Index + IncludeNameLength]));
 
-    if (Index < MaxIndex && CheckIfStringIsPrefix(IncludeName, Buffer, Index))
+    if (IsInclude)
     {
-        { /* skip the include keyword */
-            Index += GetStringLength(IncludeName);
-            SkipSpace(Buffer, &Index);
-        }
+        buffer Token = GetCommandToken(Arena, Command, CommandSize, Index + IncludeNameLength);
 
         CommandWasHandled = 1;
 
-        buffer Token = GetCommandToken(PreProcessor, Buffer, Index);
-
-        if (Token.Data[0] == '$')
+        if (!Token.Data || Token.Size == 0)
+        {
+            LogError("include command is missing an argument");
+        }
+        else if (Token.Data[0] == '$')
         {
             /* we have a variable argument */
-            u8 *TokenName = Token.Data + 1;
-            u8 *IncludeData = GetPreprocessVariable(PreProcessor, TokenName);
-
-            if (IncludeData)
-            {
-                PushString(OutputAllocator, IncludeData);
-            }
-            else
-            {
-                printf("Include variable name \"%s\"\n", Token.Data);
-                LogError("while handling pre-processor \"include\", we could not load the include variable's value.");
-            }
+            PushTemplateOp(Arena, Template, template_op_IncludeVariable, Token.Data + 1, Token.Size - 1);
         }
         else
         {
             /* assume we are dealing with a path argument */
-            buffer *Buffer = ReadFileIntoBuffer(Token.Data);
-
-            if (Buffer)
-            {
-                b32 WriteError = ryn_memory_WriteArena(OutputAllocator, Buffer->Data, Buffer->Size);
-                FreeBuffer(Buffer);
-
-                if (WriteError)
-                {
-                    LogError("failed to write file to output");
-                }
-            }
-            else
-            {
-                printf("Include file = \"%s\"\n", Token.Data);
-                LogError("include file not found");
-            }
+            PushTemplateOp(Arena, Template, template_op_IncludeFile, Token.Data, Token.Size);
         }
     }
     else
     {
-        printf("PreProcessor command: \"%s\"\n", Buffer->Data);
+        printf("PreProcessor command: \"%.*s\"\n", CommandSize, Command);
         LogError("unknown preprocessor command");
     }
 
     return CommandWasHandled;
 }
 
-internal b32 PreprocessBuffer(pre_processor *PreProcessor, ryn_memory_arena *TempString, buffer *Buffer, u8 *OutputFilePath)
-{
-    ryn_memory_arena *OutputAllocator = &PreProcessor->OutputAllocator;
+/*
+  Compile a template into a list of ops in a single forward pass. The scan jumps from one Bra to the
+  next, and everything between commands becomes a literal slice of the source, so Data must outlive
+  the template.
 
-    b32 Error = 0;
-    s32 WriteIndex = 0;
+  "{| include path |}" and "{| include $Variable |}" are replaced with the file or variable contents.
+  "{|#LABEL <text>LABEL" is a here-doc: <text> is emitted verbatim, without looking for commands inside it.
+*/
+internal template CompileTemplate(pre_processor *PreProcessor, ryn_memory_arena *Arena, u8 *Data, s64 Size)
+{
+    template Template = {0};
+    s64 WriteIndex = 0;
+    s64 I = 0;
 
-    if (!Buffer)
+    for (;;)
     {
-        printf("Error in PreprocessFile: null buffer\n");
-        Error = 1;
-    }
+        s64 BraOffset = FindBytes(Data + I, Size - I, PreProcessor->Bra, PreProcessor->BraCount);
 
-    for (s32 I = 0; I < Buffer->Size; I++)
-    {
-        b32 FoundBra = CheckIfStringIsPrefix(PreProcessor->Bra, Buffer, I);
-        s32 HereDocCharOffset = I + PreProcessor->BraCount;
-        b32 IsHereDoc = HereDocCharOffset < Buffer->Size && Buffer->Data[HereDocCharOffset] == '#';
+        if (BraOffset < 0)
+        {
+            break;
+        }
+
+        s64 BraIndex = I + BraOffset;
+        s64 CommandStart = BraIndex + PreProcessor->BraCount;
 
-        if (FoundBra && IsHereDoc)
+        if (CommandStart < Size && Data[CommandStart] == HERE_DOC_CHAR)
         {
-            I = HereDocCharOffset + 1; /* NOTE one past the here-doc character */
-            s32 Begin = I;
-            /* Skip to the next space, which is the end of the heredoc label */
-            while (!IS_SPACE(Buffer->Data[I]))
+            s64 LabelStart = CommandStart + 1;
+            s64 LabelEnd = LabelStart;
+
+            while (LabelEnd < Size && !IS_SPACE(Data[LabelEnd]))
             {
-                I += 1;
+                LabelEnd += 1;
             }
 
-            /* Set up the heredoc label, which is used to scan for the end of the heredoc. */
-            s32 HereDocLabelSize = I - Begin + 1;
-            u8 *HereDocLabel = TempString->Data + TempString->Offset;
-            s32 WriteError = ryn_memory_WriteArena(TempString, Buffer->Data + Begin, HereDocLabelSize);
+            s64 LabelSize = LabelEnd - LabelStart;
+            s64 HereDocBegin = LabelEnd + 1; /* NOTE: One past the space that ends the label. */
+            s64 LabelOffset = -1;
 
-            if (WriteError)
-            {
-                LogError("failed to write heredoc label to allocator");
-            }
-            else
+            if (LabelSize > 0 && HereDocBegin <= Size)
             {
-                TempString->Data[TempString->Offset - 1] = 0;
+                LabelOffset = FindBytes(Data + HereDocBegin, Size - HereDocBegin, Data + LabelStart, LabelSize);
             }
 
-            SkipSpace(Buffer, &I);
-
-            for (s32 J = I; J < Buffer->Size; J++)
+            if (LabelOffset >= 0)
             {
-                if (CheckIfStringIsPrefix(HereDocLabel, Buffer, J))
-                {
-                    s32 PreDataSize = HereDocCharOffset - PreProcessor->BraCount - WriteIndex;
-                    b32 WriteError = ryn_memory_WriteArena(OutputAllocator, Buffer->Data + WriteIndex, PreDataSize);
+                PushTemplateOp(Arena, &Template, template_op_Literal, Data + WriteIndex, BraIndex - WriteIndex);
+                PushTemplateOp(Arena, &Template, template_op_HereDoc, Data + HereDocBegin, LabelOffset);
 
-                    if (WriteError)
-                    {
-                        LogError("failed to write heredoc pre-data to output");
-                    }
-
-                    s32 HereDocDataBegin = Begin + HereDocLabelSize;
-                    s32 HereDocDataSize = J - HereDocDataBegin;
-                    u8 *DataBegin = Buffer->Data + HereDocDataBegin;
-
-                    WriteError = ryn_memory_WriteArena(OutputAllocator, DataBegin, HereDocDataSize);
-
-                    if (WriteError)
-                    {
-                        LogError("failed to write heredoc data to output");
-                    }
-
-                    I = J + HereDocLabelSize - 1; /* NOTE minus one to ignore the null terminator in the heredoc label */
-                    WriteIndex = I;
-                    break;
-                }
+                WriteIndex = HereDocBegin + LabelOffset + LabelSize;
+                I = WriteIndex;
+            }
+            else
+            {
+                I = CommandStart;
             }
         }
-        else if (FoundBra)
+        else
         {
-            s32 CommandStart = I + PreProcessor->BraCount;
+            s64 KetOffset = FindBytes(Data + CommandStart, Size - CommandStart, PreProcessor->Ket, PreProcessor->KetCount);
 
-            for (s32 J = CommandStart; J < Buffer->Size; J++)
+            if (KetOffset >= 0)
             {
-                b32 FoundKet = CheckIfStringIsPrefix(PreProcessor->Ket, Buffer, J);
+                s64 JustPastKet = CommandStart + KetOffset + PreProcessor->KetCount;
 
-                if (FoundKet)
-                {
-                    u8 *BufferStart = Buffer->Data + WriteIndex;
-                    s32 JustPastKet = J + PreProcessor->KetCount;
-                    s32 Size = I - WriteIndex;
-
-                    s32 OldI = I;
-                    s32 OldWriteIndex = WriteIndex;
-
-                    b32 WriteError = ryn_memory_WriteArena(OutputAllocator, BufferStart, Size);
-
-                    if (WriteError)
-                    {
-                        LogError("failed to write to output");
-                        break;
-                    }
+                PushTemplateOp(Arena, &Template, template_op_Literal, Data + WriteIndex, BraIndex - WriteIndex);
 
-                    WriteIndex = JustPastKet;
-                    I = JustPastKet;
+                b32 CommandWasHandled = CompileTemplateCommand(PreProcessor, Arena, &Template, Data + CommandStart, KetOffset);
 
-                    b32 CommandWasHandled = HandlePreProcessCommand(PreProcessor, Buffer, CommandStart, J);
-
-                    if (!CommandWasHandled)
-                    {
-                        /* We saw preprocessor brackets, but did not parse. Assume it's not a pre-processer and
-                           just output the text as usual.
-                        */
-                        I = OldI;
-                        WriteIndex = OldWriteIndex;
-                    }
-                    break;
+                if (!CommandWasHandled)
+                {
+                    /* We saw preprocessor brackets, but did not parse. Assume it's not a pre-processer and
+                       just output the text as usual.
+                    */
+                    PushTemplateOp(Arena, &Template, template_op_Literal, Data + BraIndex, JustPastKet - BraIndex);
                 }
+
+                WriteIndex = JustPastKet;
+                I = JustPastKet;
+            }
+            else
+            {
+                I = CommandStart;
             }
         }
     }
 
-    if (WriteIndex < Buffer->Size)
+    /* NOTE This handles any text after the last preprocessor command, or if there were not preprocessor commands. */
+    PushTemplateOp(Arena, &Template, template_op_Literal, Data + WriteIndex, Size - WriteIndex);
+
+    return Template;
+}
+
+/* Run a compiled template. Only global variables are added to the build manifest, variables from
+   an inner scope are per-page values that come from inputs the caller already recorded. */
+internal void ExecuteTemplate(pre_processor *PreProcessor, template *Template, template_output *Output)
+{
+    for (template_op *Op = Template->FirstOp; Op; Op = Op->Next)
     {
-        /* NOTE This branch handles any text after the last preprocessor command, or if
-           there were not preprocessor commands.
-        */
-        s32 Size = Buffer->Size - WriteIndex;
-        u8 *DataBegin = Buffer->Data + WriteIndex;
-        b32 WriteError = ryn_memory_WriteArena(OutputAllocator, DataBegin, Size);
+        switch (Op->Type)
+        {
+        case template_op_Literal:
+        case template_op_HereDoc:
+        {
+            EmitTemplateSlice(Output, Op->Data, Op->Size);
+        } break;
+        case template_op_IncludeFile:
+        {
+            include_cache_entry Include;
 
-        if (WriteError)
+            if (LoadIncludeFile(PreProcessor->IncludeCache, Op->Data, &Include))
+            {
+                AddBuildFileInputHash(PreProcessor->Manifest, Include.Path, Include.ContentHash, Include.Size, Include.ModifiedTime);
+                EmitTemplateSlice(Output, Include.Data, Include.Size);
+            }
+            else
+            {
+                printf("Include file = \"%s\"\n", Op->Data);
+                LogError("include file not found");
+            }
+        } break;
+        case template_op_IncludeVariable:
         {
-            LogError("failed to write to output");
-        }
-    }
+            pre_processor_variable *Variable = FindVariable(PreProcessor->Variables, Op->Data);
 
-    printf("Writing pre-processed file %s\n", OutputFilePath);
-    WriteFileWithPath(OutputFilePath, OutputAllocator->Data, OutputAllocator->Offset);
-    OutputAllocator->Offset = 0;
+            if (!Variable || Variable->Depth == 0)
+            {
+                AddBuildVariableInput(PreProcessor->Manifest, Op->Data, Variable ? Variable->Value : 0);
+            }
 
-    return Error;
+            if (Variable && Variable->Value)
+            {
+                EmitTemplateSlice(Output, Variable->Value, Variable->Size);
+            }
+            else
+            {
+                printf("Include variable name \"$%s\"\n", Op->Data);
+                LogError("while handling pre-processor \"include\", we could not load the include variable's value.");
+            }
+        } break;
+        default:
+        {
+            LogError("unknown template op");
+        } break;
+        }
+    }
 }
 
-b32 PreprocessFile(pre_processor *PreProcessor, ryn_memory_arena TempString, u8 *FilePath, u8 *OutputFilePath)
+internal b32 PreprocessTemplate(pre_processor *PreProcessor, template *Template, u8 *OutputFilePath)
 {
-    buffer *Buffer = ReadFileIntoBuffer(FilePath);
-    b32 Error = PreprocessBuffer(PreProcessor, &TempString, Buffer, OutputFilePath);
-    return Error;
-}
-
-global_variable buffer BlogLineTypes[blog_line_type_Count] = {
-    [blog_line_type_Paragraph]   = (buffer){0,(u8 *)""},
-    [blog_line_type_Header]      = (buffer){3,(u8 *)"==="},
-    [blog_line_type_SubHeader]   = (buffer){3,(u8 *)"---"},
-    [blog_line_type_Image]       = (buffer){6,(u8 *)"#image"},
-};
+    b32 Error = Template->Error;
+    template_output Output = {0};
 
-internal blog_line_type GetBlogLineType(u8 *BlogData, u64 MaxBytes)
-{
-    blog_line_type Type = blog_line_type_Paragraph;
+    printf("Writing pre-processed file %s\n", OutputFilePath);
 
-    buffer Header = BlogLineTypes[blog_line_type_Header];
-    buffer SubHeader = BlogLineTypes[blog_line_type_SubHeader];
-    buffer Image = BlogLineTypes[blog_line_type_Image];
+    if (PreProcessor->StreamOutput)
+    {
+        /* NOTE: Streaming mode writes slices straight to the output file, so the page is never assembled in memory. */
+        Output.File = platform_OpenFile(OutputFilePath);
+        Error = Error || Output.File.File == 0;
+    }
+    else
+    {
+        Output.Arena = &PreProcessor->OutputAllocator;
+    }
 
-    if (StringMatchLength(BlogData, Header.Data, MaxBytes) == Header.Size)
+    if (!Error)
     {
-        Type = blog_line_type_Header;
+        ExecuteTemplate(PreProcessor, Template, &Output);
+        Error = Output.Error;
     }
-    else if (StringMatchLength(BlogData, SubHeader.Data, MaxBytes) == SubHeader.Size)
+
+    if (Output.File.File)
     {
-        Type = blog_line_type_SubHeader;
+        CloseFile(Output.File);
     }
-    else if (StringMatchLength(BlogData, Image.Data, MaxBytes) == Image.Size)
+    else if (Output.Arena)
     {
-        Type = blog_line_type_Image;
+        WriteFileWithPath(OutputFilePath, Output.Arena->Data, Output.Arena->Offset);
+        Output.Arena->Offset = 0;
     }
 
-    return Type;
+    return Error;
 }
 
-internal s32 GetBytesUntilNewline(u8 *Bytes, s32 MaxBytes)
+internal b32 PreprocessBuffer(pre_processor *PreProcessor, buffer *Buffer, u8 *OutputFilePath)
 {
-    s32 BytesUntilNewline = -1;
+    b32 Error = 0;
 
-    for (s32 I = 0; I < MaxBytes; ++I)
+    if (!Buffer)
     {
-        if (Bytes[I] == '\n')
-        {
-            BytesUntilNewline = I;
-            break;
-        }
+        printf("Error in PreprocessFile: null buffer\n");
+        Error = 1;
+        return Error;
     }
 
-    return BytesUntilNewline;
+    /* NOTE: One-off files are compiled into the string allocator and thrown away after they are written. */
+    ryn_memory_arena *StringAllocator = &PreProcessor->StringAllocator;
+    u64 StringAllocatorOffset = StringAllocator->Offset;
+
+    template Template = CompileTemplate(PreProcessor, StringAllocator, Buffer->Data, Buffer->Size);
+    Error = PreprocessTemplate(PreProcessor, &Template, OutputFilePath);
+
+    StringAllocator->Offset = StringAllocatorOffset;
+
+    return Error;
 }
 
-internal b32 HandleBlogLine(ryn_memory_arena *HtmlOutput, buffer *BlogBuffer, s32 *I)
+b32 PreprocessFile(pre_processor *PreProcessor, u8 *FilePath, u8 *OutputFilePath)
 {
-    b32 ShouldContinue = 0;
+    b32 Error = 0;
 
-    while (*I < BlogBuffer->Size && BlogBuffer->Data[*I])
+    if (!IsBuildOutputCurrent(PreProcessor, OutputFilePath))
     {
-        SkipSpace(BlogBuffer, I);
-        u8 *BlogOffsetData = BlogBuffer->Data + *I;
+        buffer *Buffer = ReadFileIntoBuffer(FilePath);
 
-        blog_line_type BlogLineType = GetBlogLineType(BlogOffsetData, BlogBuffer->Size);
-        b32 ShouldHandleTextTag = 0;
-        u8 *OpenTagName = (u8 *)"<div>";
-        u8 *CloseTagName = (u8 *)"</div>";
-
-        switch (BlogLineType)
-        {
-        case blog_line_type_Header:
+        if (Buffer)
         {
-            ShouldHandleTextTag = 1;
-            OpenTagName = (u8 *)"<h1>";
-            CloseTagName = (u8 *)"</h1>";
-        } break;
-        case blog_line_type_SubHeader: {
-            ShouldHandleTextTag = 1;
-            OpenTagName = (u8 *)"<h2>";
-            CloseTagName = (u8 *)"</h2>";
-        } break;
-        case blog_line_type_Paragraph: {
-            ShouldHandleTextTag = 1;
-            OpenTagName = (u8 *)"<p>";
-            CloseTagName = (u8 *)"</p>";
-        } break;
-        case blog_line_type_Image: {
-            ShouldHandleTextTag = 1;
-            OpenTagName = (u8 *)"<img src=\"";
-            CloseTagName = (u8 *)"\" />";
-        } break;
-        default: break;
+            BeginBuildRecord(PreProcessor->Manifest, OutputFilePath);
+            AddBuildFileInput(PreProcessor->Manifest, FilePath, Buffer->Data, Buffer->Size);
+            Error = PreprocessBuffer(PreProcessor, Buffer, OutputFilePath);
+            EndBuildRecord(PreProcessor->Manifest);
+            FreeBuffer(Buffer);
         }
-
-        if (ShouldHandleTextTag)
+        else
         {
-            *I += BlogLineTypes[BlogLineType].Size;
-            SkipSpace(BlogBuffer, I);
-            u8 *StartOfText = BlogBuffer->Data + *I;
-            s32 BytesUntilNewline = GetBytesUntilNewline(StartOfText, BlogBuffer->Size);
-
-            if (BytesUntilNewline > 0)
-            {
-                PushString(HtmlOutput, OpenTagName);
-                ryn_memory_WriteArena(HtmlOutput, StartOfText, BytesUntilNewline);
-                PushString(HtmlOutput, CloseTagName);
-                PushString(HtmlOutput, (u8 *)"\n");
-
-                *I = *I + BytesUntilNewline + 1;
-            }
+            printf("Error in PreprocessFile: file not found \"%s\"\n", FilePath);
+            Error = 1;
         }
     }
 
-    return ShouldContinue;
+    return Error;
 }
 
 internal s32 CompareString(u8 *StringA, u8 *StringB)
@@ -644,7 +998,7 @@ internal file_list *SortFileList(file_list *Files)
 
         while (CurrentSortedFile)
         {
-            s32 CompareResult = CompareString(UnsortedFiles->Name, CurrentSortedFile->Name);
+            s32 CompareResult = CompareString(UnsortedFiles->Name.Bytes, CurrentSortedFile->Name.Bytes);
 
             if (CompareResult < 0)
             {
@@ -664,242 +1018,923 @@ internal file_list *SortFileList(file_list *Files)
                     UnsortedFiles = NextUnsortedFile;
                 }
 
-                break;
-            }
-            else if (!CurrentSortedFile->Next)
+                break;
+            }
+            else if (!CurrentSortedFile->Next)
+            {
+                /* unsorted file is greater than all sorted files */
+                file_list *NextUnsortedFile = UnsortedFiles->Next;
+                CurrentSortedFile->Next = UnsortedFiles;
+                UnsortedFiles->Next = 0;
+                UnsortedFiles = NextUnsortedFile;
+                break;
+            }
+            else
+            {
+                PreviousSortedFile = CurrentSortedFile;
+                CurrentSortedFile = CurrentSortedFile->Next;
+            }
+        }
+
+
+    }
+
+    return SortedFiles;
+}
+
+internal void PushNullTerminator(ryn_memory_arena *Allocator)
+{
+    Allocator->Data[Allocator->Offset] = 0;
+    Allocator->Offset += 1;
+}
+
+internal buffer GetOutputHtmlPath(ryn_memory_arena *TempString, u8 *OldRootPath, u8 *NewRootPath, u8 *CodePagePath, b32 ExcludePathExtension, b32 AddHtmlExtension)
+{
+    u8 *Extension = (u8 *)".html";
+
+    buffer Buffer;
+    Buffer.Size = 0;
+    Buffer.Data = TempString->Data + TempString->Offset;
+
+    s32 BeginOffset = TempString->Offset;
+    s32 I = 0;
+
+    /* We want to replace the source code path prefix "../src" with the "../gen" prefix.
+       This loop increments an offset until the source/code paths don't match.
+    */
+    for (;;)
+    {
+        b32 SomethingIsNull = !(OldRootPath[I] && CodePagePath[I]);
+        b32 CharsNotEqual = OldRootPath[I] != CodePagePath[I];
+
+        if (SomethingIsNull || CharsNotEqual)
+        {
+            break;
+        }
+
+        ++I;
+    }
+
+    s32 CodePagePathOffset = I;
+
+    if (NewRootPath)
+    {
+        PushString(TempString, NewRootPath);
+    }
+
+    if (ExcludePathExtension)
+    {
+        s32 End = CodePagePathOffset;
+
+        while (CodePagePath[End])
+        {
+            if (CodePagePath[End] == '.')
+            {
+                break;
+            }
+
+            End += 1;
+        }
+
+        s32 Size = End - CodePagePathOffset;
+        ryn_memory_WriteArena(TempString, CodePagePath + CodePagePathOffset, Size);
+    }
+    else
+    {
+        PushString(TempString, CodePagePath + CodePagePathOffset);
+    }
+
+    if (AddHtmlExtension)
+    {
+        PushString(TempString, Extension);
+    }
+
+    PushNullTerminator(TempString);
+
+    Buffer.Size = TempString->Offset - BeginOffset;
+    core_CopyMemory(TempString->Data + BeginOffset, Buffer.Data, Buffer.Size);
+
+    return Buffer;
+}
+
+typedef struct
+{
+    u8 Size;
+    u8 Text[8]; /* NOTE: The escapers copy all 8 bytes, the unused ones are zero. */
+} html_entity;
+
+#define HTML_ENTITY_SIZE_MAX 6
+#define HTML_ESCAPE_SLACK 16 /* NOTE: The escapers write whole 16-byte chunks and 8-byte entities past the end of their output. */
+
+global_variable html_entity HtmlEntities[256] = {
+    ['&']  = {5, "&amp;"},
+    ['<']  = {4, "&lt;"},
+    ['>']  = {4, "&gt;"},
+    ['"']  = {6, "&quot;"},
+    ['\''] = {5, "&#39;"},
+};
+
+/* Destination must have room for EscapeHtmlCapacity(Size) bytes. */
+internal u64 EscapeHtmlCapacity(u64 Size)
+{
+    return Size * HTML_ENTITY_SIZE_MAX + HTML_ESCAPE_SLACK;
+}
+
+/* NOTE: The reference escaper, also used for the tail that does not fill a whole chunk. */
+internal u64 EscapeHtmlScalar(u8 *Destination, u8 *Source, u64 Size)
+{
+    u64 Out = 0;
+
+    for (u64 I = 0; I < Size; ++I)
+    {
+        html_entity *Entity = &HtmlEntities[Source[I]];
+
+        if (Entity->Size)
+        {
+            memcpy(Destination + Out, Entity->Text, 8);
+            Out += Entity->Size;
+        }
+        else
+        {
+            Destination[Out] = Source[I];
+            Out += 1;
+        }
+    }
+
+    return Out;
+}
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+/* Return the index of the first byte in the 16-byte chunk that needs escaping, or 16 if there is none. */
+internal u32 FindHtmlSpecial16(u8 *Data)
+{
+    u32 Result = 16;
+
+#if defined(__SSE2__)
+    __m128i Chunk = _mm_loadu_si128((__m128i *)Data);
+    __m128i Special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chunk, _mm_set1_epi8('&')),
+                                                _mm_cmpeq_epi8(Chunk, _mm_set1_epi8('<'))),
+                                   _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chunk, _mm_set1_epi8('>')),
+                                                             _mm_cmpeq_epi8(Chunk, _mm_set1_epi8('"'))),
+                                                _mm_cmpeq_epi8(Chunk, _mm_set1_epi8('\''))));
+    u32 Mask = (u32)_mm_movemask_epi8(Special);
+
+    if (Mask)
+    {
+        Result = __builtin_ctz(Mask);
+    }
+#else
+    uint8x16_t Chunk = vld1q_u8(Data);
+    uint8x16_t Special = vorrq_u8(vorrq_u8(vceqq_u8(Chunk, vdupq_n_u8('&')),
+                                           vceqq_u8(Chunk, vdupq_n_u8('<'))),
+                                  vorrq_u8(vorrq_u8(vceqq_u8(Chunk, vdupq_n_u8('>')),
+                                                    vceqq_u8(Chunk, vdupq_n_u8('"'))),
+                                           vceqq_u8(Chunk, vdupq_n_u8('\''))));
+    /* NOTE: Narrow each byte of the compare to 4 bits, so the whole chunk fits in one 64-bit mask. */
+    u64 Mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Special), 4)), 0);
+
+    if (Mask)
+    {
+        Result = __builtin_ctzll(Mask) >> 2;
+    }
+#endif
+
+    return Result;
+}
+#endif
+
+/*
+  Escape & < > " and ' 16 bytes at a time. Each chunk is stored to the destination whole, before we
+  know whether it is clean, so runs without special characters are copied with one load and one store.
+  When a chunk has a special character, only the bytes before it are kept and its entity is written
+  over the rest. Returns the number of bytes written.
+*/
+internal u64 EscapeHtml(u8 *Destination, u8 *Source, u64 Size)
+{
+    u64 In = 0;
+    u64 Out = 0;
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    while (In + 16 <= Size)
+    {
+        u32 CleanCount = FindHtmlSpecial16(Source + In);
+
+        memcpy(Destination + Out, Source + In, 16);
+        In += CleanCount;
+        Out += CleanCount;
+
+        if (CleanCount < 16)
+        {
+            html_entity *Entity = &HtmlEntities[Source[In]];
+            memcpy(Destination + Out, Entity->Text, 8);
+            Out += Entity->Size;
+            In += 1;
+        }
+    }
+#endif
+
+    Out += EscapeHtmlScalar(Destination + Out, Source + In, Size - In);
+
+    return Out;
+}
+
+/* Escape straight into the arena. The worst case is reserved up front and the unused part is given back. */
+internal buffer EscapeHtmlString(ryn_memory_arena *Arena, u8 *HtmlString, u64 Length)
+{
+    buffer Buffer = {0};
+    u64 BeginOffset = Arena->Offset;
+    u8 *Destination = ryn_memory_PushSize(Arena, EscapeHtmlCapacity(Length));
+
+    if (Destination)
+    {
+        Buffer.Data = Destination;
+        Buffer.Size = EscapeHtml(Destination, HtmlString, Length);
+        Arena->Offset = BeginOffset + Buffer.Size;
+    }
+    else
+    {
+        LogError("escaping html string");
+    }
+
+    return Buffer;
+}
+
+#define HIGHLIGHT_TAG_SIZE_MAX 32
+
+/* NOTE: Token types that are not in this table are emitted as plain text. */
+global_variable char *HighlightOpenTags[token_type__Count] = {
+#define X(_name, typename, _literal)\
+    [token_type_##typename] = "<span class=\"kw\">",
+    Keywords_XList
+#undef X
+    [token_type_Digit]       = "<span class=\"num\">",
+    [token_type_BinaryDigit] = "<span class=\"num\">",
+    [token_type_HexDigit]    = "<span class=\"num\">",
+    [token_type_String]      = "<span class=\"str\">",
+    [token_type_CharLiteral] = "<span class=\"str\">",
+    [token_type_Comment]     = "<span class=\"com\">",
+    [token_type_Directive]   = "<span class=\"dir\">",
+};
+
+internal u64 HighlightCodeCapacity(u64 Size)
+{
+    /* NOTE: Worst case is every byte being its own highlighted token that needs escaping. */
+    return Size * (HTML_ENTITY_SIZE_MAX + HIGHLIGHT_TAG_SIZE_MAX) + HTML_ESCAPE_SLACK;
+}
+
+internal u64 EmitHighlightedToken(u8 *Destination, token_type Type, u8 *Token, u64 Size)
+{
+    u64 Out = 0;
+
+    if (Type == token_type_Identifier)
+    {
+        ryn_string String;
+        String.Bytes = Token;
+        String.Size = Size;
+
+        token_type KeywordType = LookupKeyword(String);
+
+        if (KeywordType)
+        {
+            Type = KeywordType;
+        }
+    }
+
+    char *OpenTag = HighlightOpenTags[Type];
+
+    if (OpenTag)
+    {
+        u64 OpenTagSize = strlen(OpenTag);
+        memcpy(Destination, OpenTag, OpenTagSize);
+        Out += OpenTagSize;
+        Out += EscapeHtml(Destination + Out, Token, Size);
+        memcpy(Destination + Out, "</span>", 7);
+        Out += 7;
+    }
+    else
+    {
+        Out += EscapeHtml(Destination, Token, Size);
+    }
+
+    return Out;
+}
+
+/*
+  Run source through the idi tokenizer table and write escaped html with a <span class> around keywords,
+  numbers, strings, comments and directives, in a single pass and without building a token list.
+  Characters the tokenizer does not handle are written as plain text and tokenizing starts over after them.
+*/
+internal buffer HighlightCode(ryn_memory_arena *Arena, u8 *Source, u64 Size)
+{
+    buffer Buffer = {0};
+    u64 BeginOffset = Arena->Offset;
+    u8 *Destination = ryn_memory_PushSize(Arena, HighlightCodeCapacity(Size));
+
+    if (!Destination)
+    {
+        LogError("highlighting code");
+        return Buffer;
+    }
+
+    u8 BeginState = TokenizerStateMap[tokenizer_state_Begin];
+    u8 DoneState = TokenizerStateMap[tokenizer_state_Done];
+    u8 ErrorState = TokenizerStateMap[tokenizer_state__Error];
+    u8 State = BeginState;
+    u64 StartOfToken = 0;
+    u64 Out = 0;
+    u64 I = 0;
+
+    while (I < Size)
+    {
+        u8 NextState = TokenizerClassTable[State][TokenizerCharClass[Source[I]]];
+        token_type Type = TokenizerStateType[State];
+
+        if (NextState == DoneState && Type)
+        {
+            Out += EmitHighlightedToken(Destination + Out, Type, Source + StartOfToken, I - StartOfToken);
+            StartOfToken = I;
+            State = BeginState;
+        }
+        else if (NextState == ErrorState && State == TokenizerStateMap[tokenizer_state_StringEscape])
+        {
+            /* NOTE: Escapes the tokenizer does not know yet, like octal and hex, should not end the string. */
+            State = TokenizerStateMap[tokenizer_state_String];
+            I += 1;
+        }
+        else if (NextState == ErrorState && State == TokenizerStateMap[tokenizer_state_CharLiteralEscape])
+        {
+            State = TokenizerStateMap[tokenizer_state_CharLiteral];
+            I += 1;
+        }
+        else if (NextState == ErrorState || NextState == DoneState)
+        {
+            I += 1;
+            Out += EscapeHtml(Destination + Out, Source + StartOfToken, I - StartOfToken);
+            StartOfToken = I;
+            State = BeginState;
+        }
+        else
+        {
+            I += 1;
+
+            if (NextState == State)
+            {
+                I = SkipTokenizerState(State, Source, I, Size);
+            }
+
+            State = NextState;
+        }
+    }
+
+    if (StartOfToken < Size)
+    {
+        /* NOTE: An unfinished token at the end, e.g. an unterminated comment, is highlighted as its current state's type. */
+        Out += EmitHighlightedToken(Destination + Out, TokenizerStateType[State], Source + StartOfToken, Size - StartOfToken);
+    }
+
+    Buffer.Data = Destination;
+    Buffer.Size = Out;
+    Arena->Offset = BeginOffset + Out;
+
+    return Buffer;
+}
+
+internal b32 IsHighlightedCodeFile(u8 *Path)
+{
+    s32 Length = GetStringLength(Path);
+    b32 Result = (Length >= 2 && Path[Length - 2] == '.' && (Path[Length - 1] == 'c' || Path[Length - 1] == 'h'));
+    return Result;
+}
+
+/*
+  Blog markup, one block per line:
+
+      === Header
+      --- Sub-header
+      #image /assets/scuba.png
+      - List item (or "* item", or "1. item" for a numbered list)
+      ```
+      code, escaped as-is until the closing fence
+      ```
+      Anything else is a paragraph, and may contain [links](/to/somewhere).
+
+  Compiling is a single pass. First every newline is found with a SIMD scan, then each line is
+  classified by its first byte, so at most a couple of prefixes are compared per line.
+*/
+
+#define BLOG_LINE_PREFIX_NONE 0xff
+
+typedef struct
+{
+    u32 *LineStarts; /* NOTE: LineStarts[LineCount] is one past the end, so line I is LineStarts[I]..LineStarts[I+1]-1 without its newline. */
+    u32 LineCount;
+} blog_line_index;
+
+typedef struct
+{
+    blog_line_type Type;
+    buffer Prefix;
+} blog_line_prefix;
+
+/* NOTE: Prefixes with the same first byte must be next to each other, they are tried in order. */
+global_variable blog_line_prefix BlogLinePrefixes[] = {
+    {blog_line_type_Header,        (buffer){3,(u8 *)"==="}},
+    {blog_line_type_SubHeader,     (buffer){3,(u8 *)"---"}},
+    {blog_line_type_ListItem,      (buffer){2,(u8 *)"- "}},
+    {blog_line_type_ListItem,      (buffer){2,(u8 *)"* "}},
+    {blog_line_type_Image,         (buffer){6,(u8 *)"#image"}},
+    {blog_line_type_CodeFence,     (buffer){3,(u8 *)"```"}},
+};
+
+/* NOTE: Index of the first prefix in BlogLinePrefixes for every first byte, filled in by SetupBlogLineTable. */
+global_variable u8 BlogLineTable[256];
+
+internal void SetupBlogLineTable(void)
+{
+    SetMemory(BlogLineTable, BLOG_LINE_PREFIX_NONE, sizeof(BlogLineTable));
+
+    for (s32 I = ArrayCount(BlogLinePrefixes) - 1; I >= 0; --I)
+    {
+        BlogLineTable[BlogLinePrefixes[I].Prefix.Data[0]] = (u8)I;
+    }
+}
+
+internal blog_line_index BuildBlogLineIndex(ryn_memory_arena *Arena, u8 *Data, u64 Size)
+{
+    blog_line_index Index = {0};
+    u64 MaxLineCount = Size + 2;
+
+    if (Size >= 0xffffffff || ryn_memory_GetArenaFreeSpace(Arena) < (MaxLineCount + 1) * sizeof(u32))
+    {
+        LogError("allocating blog line index");
+        return Index;
+    }
+
+    /* NOTE: Only the lines that are found are pushed, the worst case is just checked for. */
+    Arena->Offset = (Arena->Offset + 3) & ~(u64)3;
+    u32 *LineStarts = (u32 *)ryn_memory_GetArenaWriteLocation(Arena);
+    u32 LineCount = 0;
+    u64 I = 0;
+
+    LineStarts[LineCount++] = 0;
+
+#if defined(__SSE2__)
+    __m128i Newline = _mm_set1_epi8('\n');
+
+    for (; I + 16 <= Size; I += 16)
+    {
+        u32 Mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)(Data + I)), Newline));
+
+        while (Mask)
+        {
+            LineStarts[LineCount++] = (u32)(I + __builtin_ctz(Mask) + 1);
+            Mask &= Mask - 1;
+        }
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t Newline = vdupq_n_u8('\n');
+
+    for (; I + 16 <= Size; I += 16)
+    {
+        uint8x16_t Matches = vceqq_u8(vld1q_u8(Data + I), Newline);
+        /* NOTE: Narrow each byte of the compare to 4 bits, so the whole chunk fits in one 64-bit mask. */
+        u64 Mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Matches), 4)), 0);
+
+        while (Mask)
+        {
+            u32 Bit = __builtin_ctzll(Mask);
+            LineStarts[LineCount++] = (u32)(I + (Bit >> 2) + 1);
+            Mask &= ~((u64)0xf << Bit);
+        }
+    }
+#endif
+
+    for (; I < Size; ++I)
+    {
+        if (Data[I] == '\n')
+        {
+            LineStarts[LineCount++] = (u32)(I + 1);
+        }
+    }
+
+    if (LineStarts[LineCount - 1] < Size)
+    {
+        /* NOTE: The last line has no newline, pretend it has one so every line ends the same way. */
+        LineStarts[LineCount++] = (u32)(Size + 1);
+    }
+
+    Index.LineStarts = LineStarts;
+    Index.LineCount = LineCount - 1;
+    ryn_memory_PushSize(Arena, LineCount * sizeof(u32));
+
+    return Index;
+}
+
+internal blog_line_type GetBlogLineType(u8 *Line, u64 Size, u64 *PrefixSize)
+{
+    blog_line_type Type = blog_line_type_Paragraph;
+    u32 PrefixIndex = BlogLineTable[Line[0]];
+    *PrefixSize = 0;
+
+    if (PrefixIndex != BLOG_LINE_PREFIX_NONE)
+    {
+        u8 FirstByte = Line[0];
+
+        for (u32 I = PrefixIndex; I < ArrayCount(BlogLinePrefixes) && BlogLinePrefixes[I].Prefix.Data[0] == FirstByte; ++I)
+        {
+            buffer Prefix = BlogLinePrefixes[I].Prefix;
+
+            if ((u64)Prefix.Size <= Size && memcmp(Line, Prefix.Data, Prefix.Size) == 0)
+            {
+                Type = BlogLinePrefixes[I].Type;
+                *PrefixSize = Prefix.Size;
+                break;
+            }
+        }
+    }
+    else if (Line[0] >= '0' && Line[0] <= '9')
+    {
+        u64 I = 1;
+        while (I < Size && Line[I] >= '0' && Line[I] <= '9') I += 1;
+
+        if (I + 1 < Size && Line[I] == '.' && Line[I + 1] == ' ')
+        {
+            Type = blog_line_type_NumberedListItem;
+            *PrefixSize = I + 2;
+        }
+    }
+
+    return Type;
+}
+
+/* Write an attribute value escaped, so a quote or '&' in it can't end the attribute or start an entity. */
+internal void EmitEscapedAttribute(ryn_memory_arena *Output, u8 *Text, u64 Size)
+{
+    u8 *Escaped = ryn_memory_PushSize(Output, EscapeHtmlCapacity(Size));
+
+    if (Escaped)
+    {
+        /* NOTE: Give back the room the escaped text didn't use. */
+        Output->Offset -= EscapeHtmlCapacity(Size) - EscapeHtml(Escaped, Text, Size);
+    }
+}
+
+/* Write text, turning [label](url) into links with the url escaped. */
+internal void EmitBlogText(ryn_memory_arena *Output, u8 *Text, u64 Size)
+{
+    u8 *At = Text;
+    u8 *End = Text + Size;
+
+    while (At < End)
+    {
+        u8 *Open = memchr(At, '[', End - At);
+        u8 *Close = Open ? memchr(Open, ']', End - Open) : 0;
+
+        if (!Close)
+        {
+            break;
+        }
+
+        /* NOTE: Use the last '[' before the ']', so "[a [b](c)" links "b". */
+        for (u8 *Scan = Close - 1; Scan > Open; --Scan)
+        {
+            if (*Scan == '[')
             {
-                /* unsorted file is greater than all sorted files */
-                file_list *NextUnsortedFile = UnsortedFiles->Next;
-                CurrentSortedFile->Next = UnsortedFiles;
-                UnsortedFiles->Next = 0;
-                UnsortedFiles = NextUnsortedFile;
+                Open = Scan;
                 break;
             }
-            else
-            {
-                PreviousSortedFile = CurrentSortedFile;
-                CurrentSortedFile = CurrentSortedFile->Next;
-            }
         }
 
+        u8 *Url = Close + 2;
+        u8 *UrlEnd = (Close + 1 < End && Close[1] == '(') ? memchr(Url, ')', End - Url) : 0;
 
+        if (UrlEnd)
+        {
+            ryn_memory_WriteArena(Output, At, Open - At);
+            PushString(Output, (u8 *)"<a href=\"");
+            EmitEscapedAttribute(Output, Url, UrlEnd - Url);
+            PushString(Output, (u8 *)"\">");
+            ryn_memory_WriteArena(Output, Open + 1, Close - (Open + 1));
+            PushString(Output, (u8 *)"</a>");
+            At = UrlEnd + 1;
+        }
+        else
+        {
+            ryn_memory_WriteArena(Output, At, Close + 1 - At);
+            At = Close + 1;
+        }
     }
 
-    return SortedFiles;
+    ryn_memory_WriteArena(Output, At, End - At);
 }
 
-internal void PushNullTerminator(ryn_memory_arena *Allocator)
+internal void EmitBlogBlock(ryn_memory_arena *Output, char *OpenTag, u8 *Text, u64 Size, char *CloseTag)
 {
-    Allocator->Data[Allocator->Offset] = 0;
-    Allocator->Offset += 1;
+    PushString(Output, (u8 *)OpenTag);
+    EmitBlogText(Output, Text, Size);
+    PushString(Output, (u8 *)CloseTag);
 }
 
-internal buffer GetOutputHtmlPath(ryn_memory_arena *TempString, u8 *OldRootPath, u8 *NewRootPath, u8 *CodePagePath, b32 ExcludePathExtension, b32 AddHtmlExtension)
+/* Compile blog markup into html in the arena. */
+internal buffer CompileBlog(ryn_memory_arena *Arena, u8 *Data, u64 Size)
 {
-    u8 *Extension = (u8 *)".html";
+    buffer Html = {0};
+    blog_line_index Index = BuildBlogLineIndex(Arena, Data, Size);
+    blog_line_type OpenList = blog_line_type_Paragraph;
+    b32 InCode = 0;
+    u64 BeginOffset = Arena->Offset;
 
-    buffer Buffer;
-    Buffer.Size = 0;
-    Buffer.Data = TempString->Data + TempString->Offset;
+    for (u32 LineIndex = 0; LineIndex < Index.LineCount; ++LineIndex)
+    {
+        u8 *Line = Data + Index.LineStarts[LineIndex];
+        u64 LineSize = Index.LineStarts[LineIndex + 1] - 1 - Index.LineStarts[LineIndex];
+        u64 Start = 0;
+        u64 End = LineSize;
 
-    s32 BeginOffset = TempString->Offset;
-    s32 I = 0;
+        while (Start < End && IS_SPACE(Line[Start])) Start += 1;
+        while (End > Start && IS_SPACE(Line[End - 1])) End -= 1;
 
-    /* We want to replace the source code path prefix "../src" with the "../gen" prefix.
-       This loop increments an offset until the source/code paths don't match.
-    */
-    for (;;)
-    {
-        b32 SomethingIsNull = !(OldRootPath[I] && CodePagePath[I]);
-        b32 CharsNotEqual = OldRootPath[I] != CodePagePath[I];
+        if (InCode)
+        {
+            if (End - Start >= 3 && memcmp(Line + Start, "```", 3) == 0)
+            {
+                PushString(Arena, (u8 *)"</code></pre>\n");
+                InCode = 0;
+            }
+            else
+            {
+                /* NOTE: Code keeps its indentation, only a trailing '\r' is dropped. */
+                u64 CodeSize = LineSize && Line[LineSize - 1] == '\r' ? LineSize - 1 : LineSize;
+                EscapeHtmlString(Arena, Line, CodeSize);
+                PushString(Arena, (u8 *)"\n");
+            }
 
-        if (SomethingIsNull || CharsNotEqual)
+            continue;
+        }
+
+        u64 PrefixSize = 0;
+        blog_line_type Type = Start < End ? GetBlogLineType(Line + Start, End - Start, &PrefixSize) : blog_line_type_Count;
+        u8 *Text = Line + Start + PrefixSize;
+        u64 TextSize = End - Start - PrefixSize;
+
+        while (TextSize && IS_SPACE(*Text))
         {
-            break;
+            Text += 1;
+            TextSize -= 1;
         }
 
-        ++I;
+        if (OpenList != blog_line_type_Paragraph && Type != OpenList)
+        {
+            PushString(Arena, OpenList == blog_line_type_ListItem ? (u8 *)"</ul>\n" : (u8 *)"</ol>\n");
+            OpenList = blog_line_type_Paragraph;
+        }
+
+        switch (Type)
+        {
+        case blog_line_type_Header:
+        {
+            if (TextSize) EmitBlogBlock(Arena, "<h1>", Text, TextSize, "</h1>\n");
+        } break;
+        case blog_line_type_SubHeader:
+        {
+            if (TextSize) EmitBlogBlock(Arena, "<h2>", Text, TextSize, "</h2>\n");
+        } break;
+        case blog_line_type_Paragraph:
+        {
+            EmitBlogBlock(Arena, "<p>", Text, TextSize, "</p>\n");
+        } break;
+        case blog_line_type_Image:
+        {
+            if (TextSize)
+            {
+                PushString(Arena, (u8 *)"<img src=\"");
+                EmitEscapedAttribute(Arena, Text, TextSize);
+                PushString(Arena, (u8 *)"\" />\n");
+            }
+        } break;
+        case blog_line_type_ListItem:
+        case blog_line_type_NumberedListItem:
+        {
+            if (OpenList != Type)
+            {
+                PushString(Arena, Type == blog_line_type_ListItem ? (u8 *)"<ul>\n" : (u8 *)"<ol>\n");
+                OpenList = Type;
+            }
+
+            EmitBlogBlock(Arena, "<li>", Text, TextSize, "</li>\n");
+        } break;
+        case blog_line_type_CodeFence:
+        {
+            /* NOTE: Anything after the fence, like a language name, is ignored for now. */
+            PushString(Arena, (u8 *)"<pre><code>");
+            InCode = 1;
+        } break;
+        default: break; /* NOTE: Blank line. */
+        }
     }
 
-    s32 CodePagePathOffset = I;
+    if (OpenList != blog_line_type_Paragraph)
+    {
+        PushString(Arena, OpenList == blog_line_type_ListItem ? (u8 *)"</ul>\n" : (u8 *)"</ol>\n");
+    }
 
-    if (NewRootPath)
+    if (InCode)
     {
-        PushString(TempString, NewRootPath);
+        PushString(Arena, (u8 *)"</code></pre>\n");
     }
 
-    if (ExcludePathExtension)
+    Html.Data = Arena->Data + BeginOffset;
+    Html.Size = (s32)(Arena->Offset - BeginOffset);
+
+    return Html;
+}
+
+internal void GeneratePageJob(void *Data, s32 WorkerIndex)
+{
+    page_job *Job = Data;
+    ryn_memory_arena *Scratch = &Job->ScratchArenas[WorkerIndex];
+    Scratch->Offset = 0;
+
+    /* NOTE: Each job records into its own manifest, which is merged in page order once all jobs are done.
+       Output is always streamed, since the pre-processor's output allocator is shared. The page's
+       variables go in a frame on top of the globals, which is thrown away when the worker's scratch arena is reset. */
+    pre_processor PreProcessor = *Job->PreProcessor;
+    PreProcessor.Manifest = &Job->Manifest;
+    PreProcessor.StreamOutput = 1;
+    PreProcessor.Variables = CreateVariableTable(Scratch, Job->PreProcessor->Variables, Megabytes(1));
+
+    buffer *Source = ReadFileIntoBuffer(Job->SourcePath);
+
+    if (Source)
     {
-        s32 End = CodePagePathOffset;
+        BeginBuildRecord(&Job->Manifest, Job->OutputPath);
+        AddBuildFileInput(&Job->Manifest, Job->SourcePath, Source->Data, Source->Size);
 
-        while (CodePagePath[End])
+        switch (Job->Type)
         {
-            if (CodePagePath[End] == '.')
+        case page_job_type_Code:
+        {
+            buffer EscapedHtmlBuffer;
+
+            if (IsHighlightedCodeFile(Job->SourcePath))
             {
-                break;
+                EscapedHtmlBuffer = HighlightCode(Scratch, Source->Data, Source->Size);
+            }
+            else
+            {
+                EscapedHtmlBuffer = EscapeHtmlString(Scratch, Source->Data, Source->Size);
             }
 
-            End += 1;
+            SetVariable(PreProcessor.Variables, (u8 *)"CodePagePath", Job->SourcePath, GetStringLength(Job->SourcePath));
+            SetVariable(PreProcessor.Variables, (u8 *)"CodePageSource", EscapedHtmlBuffer.Data, EscapedHtmlBuffer.Size);
+        } break;
+        case page_job_type_Blog:
+        {
+            buffer BlogHtml = CompileBlog(Scratch, Source->Data, Source->Size);
+
+            SetVariable(PreProcessor.Variables, (u8 *)"BlogHtml", BlogHtml.Data, BlogHtml.Size);
+        } break;
+        default:
+        {
+            LogError("unknown page job type");
+        } break;
         }
 
-        s32 Size = End - CodePagePathOffset;
-        ryn_memory_WriteArena(TempString, CodePagePath + CodePagePathOffset, Size);
+        Job->Error = PreprocessTemplate(&PreProcessor, Job->Template, Job->OutputPath);
+        EndBuildRecord(&Job->Manifest);
+        FreeBuffer(Source);
     }
     else
     {
-        PushString(TempString, CodePagePath + CodePagePathOffset);
+        printf("Error in GeneratePageJob: file not found \"%s\"\n", Job->SourcePath);
+        Job->Error = 1;
     }
+}
 
-    if (AddHtmlExtension)
+internal page_job *PushPageJob(ryn_memory_arena *Arena, page_job_list *List, page_job_type Type, pre_processor *PreProcessor, template *Template, u8 *SourcePath, u8 *OutputPath)
+{
+    page_job *Job = ryn_memory_PushZeroStruct(Arena, page_job);
+
+    if (Job)
     {
-        PushString(TempString, Extension);
-    }
+        Job->Type = Type;
+        Job->PreProcessor = PreProcessor;
+        Job->Template = Template;
+        Job->SourcePath = SourcePath;
+        Job->OutputPath = OutputPath;
 
-    PushNullTerminator(TempString);
+        if (List->Last)
+        {
+            List->Last->Next = Job;
+        }
+        else
+        {
+            List->First = Job;
+        }
 
-    Buffer.Size = TempString->Offset - BeginOffset;
-    core_CopyMemory(TempString->Data + BeginOffset, Buffer.Data, Buffer.Size);
+        List->Last = Job;
+    }
+    else
+    {
+        LogError("pushing page job");
+    }
 
-    return Buffer;
+    return Job;
 }
 
-internal void GenerateBlogPages(ryn_memory_arena *TempString, pre_processor *PreProcessor, u8 *SiteBlogDirectory)
+/*
+  Generate every page in the list in parallel, then merge their build records in list order so the
+  manifest stays deterministic. Each worker gets one scratch arena that is reset for every page it
+  generates, instead of a fresh mapping per page.
+*/
+internal void RunPageJobs(job_system *JobSystem, page_job_list *List)
 {
-    u8 *BlogDirectory = (u8 *)"../blog";
-    u8 *BlogPageTemplateFilePath = (u8 *)"../src/layout/blog.html";
-    u8 *BlogListingFilePath = (u8 *)"../gen/blog_listing.html";
-
-    ryn_memory_arena FileArena = ryn_memory_CreateArena(Gigabytes(1));
-    file_list *FileList = WalkDirectory(&FileArena, BlogDirectory);
-    file_list *SortedFileList = SortFileList(FileList);
+    ryn_memory_arena ScratchArenas[JOB_THREAD_MAX] = {0};
 
-    buffer File;
-    buffer BlogPageTemplate;
-
-    BlogPageTemplate.Size = platform_GetFileSize(BlogPageTemplateFilePath);
-    BlogPageTemplate.Data = ryn_memory_PushSize(TempString, BlogPageTemplate.Size + 1);
+    for (s32 I = 0; I < JobSystem->ThreadCount; ++I)
+    {
+        ScratchArenas[I] = ryn_memory_CreateArena(Gigabytes(1));
+    }
 
-    if (!BlogPageTemplate.Data)
+    for (page_job *Job = List->First; Job; Job = Job->Next)
     {
-        LogError("loading blog page template file");
-        return;
+        Job->Manifest.Arena = ryn_memory_CreateArena(Megabytes(1));
+        Job->Manifest.GeneratorHash = Job->PreProcessor->Manifest->GeneratorHash;
+        Job->ScratchArenas = ScratchArenas;
+        PushJob(JobSystem, GeneratePageJob, Job);
     }
 
-    ReadFileIntoData(BlogPageTemplateFilePath, BlogPageTemplate.Data, BlogPageTemplate.Size);
-    BlogPageTemplate.Data[BlogPageTemplate.Size] = 0; /* null terminate */
+    RunJobs(JobSystem);
 
-    u64 TempStringOffset = TempString->Offset;
-    u64 BlogListingOffset = PreProcessor->OutputAllocator.Offset;
+    for (s32 I = 0; I < JobSystem->ThreadCount; ++I)
+    {
+        ryn_memory_FreeArena(ScratchArenas[I]);
+    }
 
-    /* write each blog page */
-    for (file_list *CurrentFile = SortedFileList; CurrentFile; CurrentFile = CurrentFile->Next)
+    for (page_job *Job = List->First; Job; Job = Job->Next)
     {
-        File.Size = platform_GetFileSize(CurrentFile->Name);
-        File.Data = ryn_memory_PushSize(TempString, File.Size + 1);
+        build_manifest *Manifest = Job->PreProcessor->Manifest;
+        MergeBuildRecords(Manifest, &Job->Manifest);
+        ryn_memory_FreeArena(Job->Manifest.Arena);
 
-        if (File.Data)
+        if (Job->Error)
         {
-            ReadFileIntoData(CurrentFile->Name, File.Data, File.Size + 1);
-            File.Data[File.Size] = 0;
-
-            u64 BlogHtmlOffset = TempString->Offset;
-
-            PushString(TempString, BlogPageTemplateOpen);
-
-            s32 BlogFileDataOffset = 0;
-            while (HandleBlogLine(TempString, &File, &BlogFileDataOffset));
+            printf("Page \"%s\"\n", Job->OutputPath);
+            LogError("generating page");
+        }
+    }
+}
 
-            PushString(TempString, BlogPageTemplateClose);
+internal void GenerateBlogPages(ryn_memory_arena *TempString, pre_processor *PreProcessor, job_system *JobSystem, u8 *SiteBlogDirectory)
+{
+    u8 *BlogDirectory = (u8 *)"../blog";
+    u8 *BlogListingFilePath = (u8 *)"../gen/blog_listing.html";
 
-            buffer BlogHtmlBuffer;
-            BlogHtmlBuffer.Data = TempString->Data + BlogHtmlOffset;
-            BlogHtmlBuffer.Size = TempString->Offset - BlogHtmlOffset;
+    ryn_memory_arena FileArena = ryn_memory_CreateArena(Gigabytes(1));
+    file_list *FileList = WalkDirectory(&FileArena, BlogDirectory);
+    file_list *SortedFileList = SortFileList(FileList);
 
-            buffer BlogOutputPath = GetOutputHtmlPath(TempString, BlogDirectory, SiteBlogDirectory, CurrentFile->Name, 1, 1);
+    u64 TempStringOffset = TempString->Offset;
+    template Template = CompileTemplate(PreProcessor, &FileArena, BlogPageTemplate, GetStringLength(BlogPageTemplate));
+    SetupBlogLineTable();
+    page_job_list PageJobs = {0};
 
-            b32 Error = PreprocessBuffer(PreProcessor, TempString, &BlogHtmlBuffer, BlogOutputPath.Data);
+    /* write each blog page */
+    for (file_list *CurrentFile = SortedFileList; CurrentFile; CurrentFile = CurrentFile->Next)
+    {
+        buffer BlogOutputPath = GetOutputHtmlPath(TempString, BlogDirectory, SiteBlogDirectory, CurrentFile->Name.Bytes, 1, 1);
 
-            if (Error)
-            {
-                LogError("preprocessing blog template page");
-            }
-        }
-        else
+        if (!IsBuildOutputCurrent(PreProcessor, BlogOutputPath.Data))
         {
-            LogError("writing blog file to temp-string");
+            PushPageJob(&FileArena, &PageJobs, page_job_type_Blog, PreProcessor, &Template, CurrentFile->Name.Bytes, BlogOutputPath.Data);
         }
-
-        TempString->Offset = TempStringOffset;
     }
 
+    RunPageJobs(JobSystem, &PageJobs);
+    TempString->Offset = TempStringOffset;
+
     { /* write blog listing page */
         ryn_memory_arena *OutputAllocator = &PreProcessor->OutputAllocator;
         u64 OutputOffset = PreProcessor->OutputAllocator.Offset;
 
         for (file_list *CurrentFile = SortedFileList; CurrentFile; CurrentFile = CurrentFile->Next)
         {
-            buffer BlogOutputPath = GetOutputHtmlPath(TempString, BlogDirectory, (u8 *)"/blog", CurrentFile->Name, 1, 1);
+            buffer BlogOutputPath = GetOutputHtmlPath(TempString, BlogDirectory, (u8 *)"/blog", CurrentFile->Name.Bytes, 1, 1);
 
             PushString(OutputAllocator, (u8 *)"<li><a href=\"");
             PushString(OutputAllocator, BlogOutputPath.Data);
             PushString(OutputAllocator, (u8 *)"\">");
-            PushString(OutputAllocator, CurrentFile->Name);
+            PushString(OutputAllocator, CurrentFile->Name.Bytes);
             PushString(OutputAllocator, (u8 *)"</a></li>\n");
         }
 
         u8 *BlogListingData = OutputAllocator->Data + OutputOffset;
-        u64 Size = OutputAllocator->Offset - BlogListingOffset;
-        WriteFileWithPath(BlogListingFilePath, BlogListingData, Size);
+        u64 Size = OutputAllocator->Offset - OutputOffset;
+        WriteOutputIfChanged(PreProcessor->Manifest, BlogListingFilePath, BlogListingData, Size);
         OutputAllocator->Offset = OutputOffset;
     }
 
-    ryn_memory_FreeArena(FileAllocator);
-}
-
-internal buffer EscapeHtmlString(ryn_memory_arena *TempString, u8 *HtmlString, s32 Length)
-{
-    s32 HtmlStringBegin = 0;
-    s32 InitialOffset = TempString->Offset;
-    s32 I;
-
-    buffer Buffer;
-    Buffer.Size = 0;
-    Buffer.Data = TempString->Data + TempString->Offset;
-
-    for (I = 0; I < Length; I++)
-    {
-        u8 *EscapeString = 0;
-
-        switch(HtmlString[I])
-        {
-        case '<': EscapeString = (u8 *)"&lt;"; break;
-        case '>': EscapeString = (u8 *)"&gt;"; break;
-        default:
-            break;
-        }
-
-        if (EscapeString)
-        {
-            u8 *BeginData = HtmlString + HtmlStringBegin;
-            s32 Size = I - HtmlStringBegin;
-            u8 *Data = ryn_memory_PushSize(TempString, Size);
-
-            core_CopyMemory(BeginData, Data, Size);
-            PushString(TempString, EscapeString);
-            HtmlStringBegin = I + 1;
-        }
-    }
-
-    s32 RemainingLength = I - HtmlStringBegin;
-
-    if (RemainingLength)
-    {
-        ryn_memory_WriteArena(TempString, HtmlString + HtmlStringBegin, RemainingLength);
-    }
-
-    Buffer.Size = TempString->Offset - InitialOffset;
-
-    return Buffer;
+    ryn_memory_FreeArena(FileArena);
 }
 
 #define FILE_TREE_DEPTH_MAX 16
@@ -1000,10 +2035,10 @@ internal u8 *GetFileNameFromPath(ryn_memory_arena *Allocator, u8 *Path)
     return FileName;
 }
 
-void GenerateCodePages(ryn_memory_arena *FileArena, ryn_memory_arena *TempString)
+void GenerateCodePages(ryn_memory_arena *FileArena, ryn_memory_arena *TempString, pre_processor *PreProcessor, job_system *JobSystem, site_report *Report)
 {
     u8 *SourceCodePath = (u8 *)"../src";
-    u8 *GenCodePagesPath = (u8 *)"../gen/code_pages";
+    u8 *SiteCodePagesPath = (u8 *)"../site";
 
     file_list *FileList = WalkDirectory(FileArena, SourceCodePath);
     ryn_memory_arena CodePage = ryn_memory_CreateArena(Gigabytes(1));
@@ -1011,13 +2046,14 @@ void GenerateCodePages(ryn_memory_arena *FileArena, ryn_memory_arena *TempString
     file_list *SortedFileList = SortFileList(FileList);
 
     { /* Print out html for file-tree */
+        BeginSiteStage(Report, site_stage_CodeListing);
         u8 *CodePageListingPath = (u8 *)"../gen/code_page_links.html";
         file_tree Tree = {0};
 
         for (file_list *CurrentFile = SortedFileList; CurrentFile; CurrentFile = CurrentFile->Next)
         {
-            buffer FileOutputName = GetOutputHtmlPath(TempString, SourceCodePath, 0, CurrentFile->Name, 0, 0);
-            path_parts PathParts = GetPathParts(TempString, CurrentFile->Name);
+            buffer FileOutputName = GetOutputHtmlPath(TempString, SourceCodePath, 0, CurrentFile->Name.Bytes, 0, 0);
+            path_parts PathParts = GetPathParts(TempString, CurrentFile->Name.Bytes);
             s32 LeadingSpaceCount = 0;
 
             PushString(&CodePage, (u8 *)"<div>");
@@ -1076,69 +2112,83 @@ void GenerateCodePages(ryn_memory_arena *FileArena, ryn_memory_arena *TempString
             PushString(&CodePage, (u8 *)"</div>");
         }
 
-        WriteFileWithPath(CodePageListingPath, CodePage.Data, CodePage.Offset);
+        WriteOutputIfChanged(PreProcessor->Manifest, CodePageListingPath, CodePage.Data, CodePage.Offset);
         CodePage.Offset = 0;
+        EndSiteStage(Report, site_stage_CodeListing);
     }
 
     { /* inidividual code page docs */
+        BeginSiteStage(Report, site_stage_CodePages);
+        template Template = CompileTemplate(PreProcessor, &CodePage, CodePageTemplate, GetStringLength(CodePageTemplate));
+        page_job_list PageJobs = {0};
+
         for (file_list *CurrentFile = SortedFileList; CurrentFile; CurrentFile = CurrentFile->Next)
         {
-            buffer Buffer = GetOutputHtmlPath(TempString, SourceCodePath, GenCodePagesPath, CurrentFile->Name, 0, 1);
+            buffer Buffer = GetOutputHtmlPath(TempString, SourceCodePath, SiteCodePagesPath, CurrentFile->Name.Bytes, 0, 1);
             EnsurePathDirectoriesExist(Buffer.Data);
 
-            PushString(&CodePage, (u8 *)(
-                "<!doctype html>"                                                          \
-                "<html lang=\"en-us\">"                                                    \
-                    "<head>"                                                               \
-                        "{" "| include ../src/layout/head_common.html |" "}"               \
-                        "<style>"                                                          \
-                            "{" "| include ../src/layout/code_page_style.css |" "}"        \
-                        "</style>"                                                         \
-                    "</head>"                                                              \
-                    "<body>"                                                               \
-                /* TODO: move hard-coded style */
-                        "<main style=\"padding: 1rem\">"                                   \
-                            "{" "| include ../src/layout/navigation_header.html |" "}"     \
-                                "<h2>"));
-
-            PushString(&CodePage, CurrentFile->Name);
+            if (!IsBuildOutputCurrent(PreProcessor, Buffer.Data))
+            {
+                PushPageJob(&CodePage, &PageJobs, page_job_type_Code, PreProcessor, &Template, CurrentFile->Name.Bytes, Buffer.Data);
+            }
+        }
 
-            PushString(&CodePage, (u8 *)(
-                                "</h2>"                                                    \
-                                "<pre>"                                                    \
-                                    "{" "|" "#HERE" "DOC "));
+        RunPageJobs(JobSystem, &PageJobs);
+        TempString->Offset = 0;
+        EndSiteStage(Report, site_stage_CodePages);
+    }
 
+    ryn_memory_FreeArena(CodePage);
+}
 
-            buffer *CodePageBuffer = ReadFileIntoBuffer(CurrentFile->Name);
-            buffer EscapedHtmlBuffer = EscapeHtmlString(TempString, CodePageBuffer->Data, CodePageBuffer->Size);
+/*
+  The generator keeps the pre-processor, its include cache and the job system alive between
+  builds, so watch mode can rebuild without starting cold. Whether a page needs building is still
+  decided by the build manifest on every run.
+*/
+typedef struct
+{
+    pre_processor PreProcessor;
+    job_system *JobSystem;
+    ryn_memory_arena FileArena;
+} site_generator;
 
-            u8 *CodePageData = ryn_memory_PushSize(&CodePage, EscapedHtmlBuffer.Size);
-            core_CopyMemory(EscapedHtmlBuffer.Data, CodePageData, EscapedHtmlBuffer.Size);
+internal site_generator *CreateSiteGenerator(build_manifest *Manifest)
+{
+    site_generator *Generator = AllocateMemory(sizeof(site_generator));
 
-            PushString(&CodePage, (u8 *)"HERE" "DOC</pre></main></body></html>");
+    if (!Generator)
+    {
+        LogError("allocating site generator");
+        return Generator;
+    }
 
-            WriteFileWithPath(Buffer.Data, CodePage.Data, CodePage.Offset);
-            FreeBuffer(CodePageBuffer);
+    EnsureDirectoryExists((u8 *)"../gen");
+    EnsureDirectoryExists((u8 *)"../assets");
+    EnsureDirectoryExists((u8 *)"../site");
+    EnsureDirectoryExists((u8 *)"../site/blog");
+    EnsureDirectoryExists((u8 *)"../site/assets");
 
-            CodePage.Offset = 0;
-            TempString->Offset = 0;
-        }
+    Generator->FileArena = ryn_memory_CreateArena(Gigabytes(1));
+    Generator->JobSystem = CreateJobSystem(0);
 
-    }
+    Generator->PreProcessor = CreatePreProcessor((u8 *)"{|", (u8 *)"|}", Manifest);
+    AddPreProcessorCommand(&Generator->PreProcessor, pre_processor_command_Include, (u8 *)"include");
+    AddPreProcessorCommand(&Generator->PreProcessor, pre_processor_command_Docgen, (u8 *)"docgen");
 
-    ryn_memory_FreeArena(FileAllocator);
+    return Generator;
 }
 
-void GenerateSite(ryn_memory_arena *FileArena, ryn_memory_arena *TempString)
+internal void FreeSiteGenerator(site_generator *Generator)
 {
-    u8 *GenDirectory       = (u8 *)"../gen";
-    u8 *CodePagesDirectory = (u8 *)"../gen/code_pages";
-
-    u8 *AssetsDirectory = (u8 *)"../assets";
+    FreeJobSystem(Generator->JobSystem);
+    ryn_memory_FreeArena(Generator->FileArena);
+    FreeMemory(Generator);
+}
 
-    u8 *SiteDirectory       = (u8 *)"../site";
+internal void RunSiteGenerator(site_generator *Generator, ryn_memory_arena *TempString, site_report *Report)
+{
     u8 *SiteBlogDirectory   = (u8 *)"../site/blog";
-    u8 *SiteAssetsDirectory = (u8 *)"../site/assets";
 
     u8 *IndexIn  = (u8 *)"../src/layout/index.html";
     u8 *IndexOut = (u8 *)"../site/index.html";
@@ -1158,97 +2208,122 @@ void GenerateSite(ryn_memory_arena *FileArena, ryn_memory_arena *TempString)
     u8 *EstudiosoIn  = (u8 *)"../src/layout/estudioso.html";
     u8 *EstudiosoOut = (u8 *)"../gen/estudioso.html";
 
-    u8 *Bra = (u8 *)"{|";
-    u8 *Ket = (u8 *)"|}";
+    pre_processor *PreProcessor = &Generator->PreProcessor;
+    build_manifest *Manifest = PreProcessor->Manifest;
+    job_system *JobSystem = Generator->JobSystem;
 
-    EnsureDirectoryExists(GenDirectory);
-    EnsureDirectoryExists(CodePagesDirectory);
-    EnsureDirectoryExists(AssetsDirectory);
-    EnsureDirectoryExists(SiteDirectory);
-    EnsureDirectoryExists(SiteBlogDirectory);
-    EnsureDirectoryExists(SiteAssetsDirectory);
+    /* NOTE: The file list from the last run is thrown away, the directories are walked again. */
+    Generator->FileArena.Offset = 0;
 
     { /* Copy some ../assets into ../site/assets. */
         /* TODO: Put asset mappings into some kind of data structure and loop thoough it? */
-        u64 OldAllocatorOffset = TempString->Offset;
-        u64 FileSize = ReadFileIntoAllocator(TempString, (u8 *)"../assets/scuba.png");
-        WriteFileWithPath((u8 *)"../site/assets/scuba.png", TempString->Data + OldAllocatorOffset, FileSize);
-        TempString->Offset = OldAllocatorOffset;
+        BeginSiteStage(Report, site_stage_AssetCopy);
+        u8 *AssetIn = (u8 *)"../assets/scuba.png";
+        u8 *AssetOut = (u8 *)"../site/assets/scuba.png";
+
+        if (!IsBuildOutputCurrent(PreProcessor, AssetOut))
+        {
+            u64 OldAllocatorOffset = TempString->Offset;
+            u64 FileSize = ReadFileIntoAllocator(TempString, AssetIn);
+            u8 *FileData = TempString->Data + OldAllocatorOffset;
+            u64 DataSize = FileSize ? FileSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator added by ReadFileIntoAllocator. */
+
+            BeginBuildRecord(Manifest, AssetOut);
+            AddBuildFileInput(Manifest, AssetIn, FileData, DataSize);
+            WriteFileWithPath(AssetOut, FileData, DataSize);
+            EndBuildRecord(Manifest);
+
+            TempString->Offset = OldAllocatorOffset;
+        }
+
+        EndSiteStage(Report, site_stage_AssetCopy);
     }
 
-    pre_processor PreProcessor = CreatePreProcessor(Bra, Ket);
-    AddPreProcessorCommand(&PreProcessor, pre_processor_command_Include, (u8 *)"include");
-    AddPreProcessorCommand(&PreProcessor, pre_processor_command_Docgen, (u8 *)"docgen");
+    GenerateCodePages(&Generator->FileArena, TempString, PreProcessor, JobSystem, Report);
+
+    TempString->Offset = 0;
+
+    BeginSiteStage(Report, site_stage_BlogPages);
+    GenerateBlogPages(TempString, PreProcessor, JobSystem, SiteBlogDirectory);
+    EndSiteStage(Report, site_stage_BlogPages);
 
-    GenerateCodePages(TempString);
+    BeginSiteStage(Report, site_stage_LayoutPages);
+    PreprocessFile(PreProcessor, IndexIn, IndexOut);
+    PreprocessFile(PreProcessor, CodeIn, CodeOut);
+    PreprocessFile(PreProcessor, BlogIn, BlogOut);
+    PreprocessFile(PreProcessor, LSystemIn, LSystemOut);
+    PreprocessFile(PreProcessor, ScubaIn, ScubaOut);
+    PreprocessFile(PreProcessor, EstudiosoIn, EstudiosoOut);
+    EndSiteStage(Report, site_stage_LayoutPages);
 
     {
-        file_list *FileList = WalkDirectory(CodePagesDirectory);
-        file_list *SortedFileList = SortFileList(FileList);
+        include_cache *Cache = PreProcessor->IncludeCache;
+        printf("Include cache: %d files, %d hits, %d reads\n", Cache->EntryCount, Cache->HitCount, Cache->MissCount);
+    }
+}
 
-        for (file_list *CurrentFile = SortedFileList; CurrentFile; CurrentFile = CurrentFile->Next)
-        {
-            buffer OutputHtmlPath = GetOutputHtmlPath(TempString, CodePagesDirectory, SiteDirectory, CurrentFile->Name, 0, 0);
-            EnsurePathDirectoriesExist(OutputHtmlPath.Data);
+void GenerateSite(ryn_memory_arena *TempString, build_manifest *Manifest, site_report *Report)
+{
+    site_generator *Generator = CreateSiteGenerator(Manifest);
 
-            u8 FileName[256];
-            {
-                s32 FileNameLength = GetStringLength(CurrentFile->Name);
-                s32 Offset = 0;
+    if (Generator)
+    {
+        RunSiteGenerator(Generator, TempString, Report);
+        FreeSiteGenerator(Generator);
+    }
+}
 
-                /* NOTE: Check if path begins with relative-up-path "../" and ignore if it is there. */
-                if (FileNameLength >= 3)
-                {
-                    u8 *Name = CurrentFile->Name;
-                    if (Name[0] == '.' && Name[1] == '.' && Name[2] == '/')
-                    {
-                        Offset = 3;
-                    }
-                }
+#define WATCH_DEBOUNCE_MILLISECONDS 8
 
-                u32 DotCount = 0;
-                s32 I;
-                for (I = 0; I < 256; ++I)
-                {
-                    u8 Char = OutputHtmlPath.Data[I + Offset];
+/*
+  Rebuild the site every time something under ../src, ../blog or ../assets changes. Editors tend to
+  save with a few events in a row, so the rebuild waits until the directories have been quiet for
+  WATCH_DEBOUNCE_MILLISECONDS. The manifest is written after every rebuild, so a plain preprocess
+  run afterwards has nothing to do.
+*/
+void WatchSite(ryn_memory_arena *TempString, u8 *ManifestPath)
+{
+    u8 *WatchedDirectories[] = { (u8 *)"../src", (u8 *)"../blog", (u8 *)"../assets" };
 
-                    if ((I + Offset) >= FileNameLength)
-                    {
-                        break;
-                    }
+    build_manifest Manifest = LoadBuildManifest(ManifestPath, GetSiteGeneratorHash());
+    site_generator *Generator = CreateSiteGenerator(&Manifest);
+    directory_watch *Watch = platform_CreateDirectoryWatch(WatchedDirectories, ArrayCount(WatchedDirectories));
 
-                    if (Char == '.')
-                    {
-                        DotCount += 1;
+    if (!Generator || !Watch)
+    {
+        printf("Error in WatchSite: could not start watching\n");
+        return;
+    }
 
-                        if (DotCount == 2)
-                        {
-                            break;
-                        }
-                    }
+    u64 ChangeTime = ryn_ReadOSTimer();
 
-                    FileName[I] = Char;
-                }
-                FileName[I] = 0;
-            }
+    for (;;)
+    {
+        site_report Report = {0};
+        Report.Manifest = &Manifest;
 
-            SetPreprocessVariable(&PreProcessor, (u8 *)"FileName", FileName);
+        RunSiteGenerator(Generator, TempString, &Report);
 
-            PreprocessFile(&PreProcessor, *TempString, CurrentFile->Name, OutputHtmlPath.Data);
-        }
+        BeginSiteStage(&Report, site_stage_Write);
+        WriteBuildManifest(&Manifest);
+        EndSiteStage(&Report, site_stage_Write);
 
-        ryn_memory_FreeArena(FileAllocator);
-    }
+        PrintSiteReport(&Report);
+        printf("Rebuilt %d, up-to-date %d, %.2fms after the change\n",
+               Manifest.BuiltCount, Manifest.SkippedCount, (double)(ryn_ReadOSTimer() - ChangeTime) / 1000.0);
 
-    TempString->Offset = 0;
+        RollBuildManifest(&Manifest);
+        TempString->Offset = 0;
 
-    GenerateBlogPages(TempString, &PreProcessor, SiteBlogDirectory);
+        printf("Watching for changes...\n");
+        fflush(stdout);
 
-    PreprocessFile(&PreProcessor, *TempString, IndexIn, IndexOut);
-    PreprocessFile(&PreProcessor, *TempString, CodeIn, CodeOut);
-    PreprocessFile(&PreProcessor, *TempString, BlogIn, BlogOut);
-    PreprocessFile(&PreProcessor, *TempString, LSystemIn, LSystemOut);
-    PreprocessFile(&PreProcessor, *TempString, ScubaIn, ScubaOut);
-    PreprocessFile(&PreProcessor, *TempString, EstudiosoIn, EstudiosoOut);
+        platform_WaitForDirectoryChange(Watch, -1);
+        ChangeTime = ryn_ReadOSTimer();
 
+        while (platform_WaitForDirectoryChange(Watch, WATCH_DEBOUNCE_MILLISECONDS))
+        {
+            /* NOTE: Wait for the burst of events to settle. */
+        }
+    }
 }
@@ -25,11 +25,13 @@ int Screen_Height = 700;
 #include <emscripten/emscripten.h>
 #endif
 
-#include "../gen/scuba.h"
-#include "../gen/roboto_regular.h"
 #include "core.c"
+#include "asset_pack.h"
+#include "../gen/scuba_pack.h"
+#include "../gen/scuba_sprites.h"
 #include "math.c"
 #include "raylib_helpers.h"
+#include "asset_loader.c"
 #include "ui.c"
 
 #define PI_OVER_2 (PI/2.0f)
@@ -37,6 +39,10 @@ int Screen_Height = 700;
 #define DEBUG_DRAW_COLLISIONS 1
 
 #define TEXTURE_MAP_SCALE 4
+/* NOTE: Sprites come from the atlas baked at TEXTURE_MAP_SCALE, this won't compile if assets/scuba.sprites doesn't bake it. */
+#define SpriteScaleIndex_(Scale) SCUBA_SPRITE_SCALE_INDEX_##Scale
+#define SpriteScaleIndex(Scale) SpriteScaleIndex_(Scale)
+#define SPRITE_SCALE_INDEX SpriteScaleIndex(TEXTURE_MAP_SCALE)
 #define MAX_ENTITY_COUNT 256
 #define MAX_COLLISION_AREA_COUNT 512
 #define MAX_COLLISION_GEOMETRY_COUNT 128
@@ -87,7 +93,7 @@ typedef enum
 typedef struct
 {
     sprite_type Type;
-    Rectangle SourceRectangle;
+    scuba_sprite Id;
     s32 DepthZ;
 } sprite;
 
@@ -551,7 +557,7 @@ internal entity *AddEntity(game_state *GameState, sprite_type SpriteType)
             Entity->Type = entity_type_Base;
             Entity->MovementType = entity_movement_type_Moveable;
             Entity->Sprites[0].Type = SpriteType;
-            Entity->Sprites[0].SourceRectangle = R2(5,3,12,9);
+            Entity->Sprites[0].Id = scuba_sprite_Fish;
             Entity->Sprites[0].DepthZ = 2;
             Entity->Position = V2(0.0f, 0.0f);
             Entity->Health = 4;
@@ -564,7 +570,7 @@ internal entity *AddEntity(game_state *GameState, sprite_type SpriteType)
             Entity->Type = entity_type_Base;
             Entity->MovementType = entity_movement_type_Monorail;
             Entity->Sprites[0].Type = SpriteType;
-            Entity->Sprites[0].SourceRectangle = R2(1,27,34,20);
+            Entity->Sprites[0].Id = scuba_sprite_Eel;
             Entity->Sprites[0].DepthZ = 1;
             Entity->Position = V2(0.0f, 0.0f);
             Entity->CollisionAreaIndex = AddCollisionArea(GameState, Entity);
@@ -576,7 +582,7 @@ internal entity *AddEntity(game_state *GameState, sprite_type SpriteType)
             Entity->Type = entity_type_Base;
             Entity->MovementType = entity_movement_type_None;
             Entity->Sprites[0].Type = SpriteType;
-            Entity->Sprites[0].SourceRectangle = R2(13,118,TILE_SIZE,TILE_SIZE);
+            Entity->Sprites[0].Id = scuba_sprite_Coral;
             Entity->Sprites[0].DepthZ = -1;
         } break;
         case sprite_type_Wall:
@@ -586,7 +592,7 @@ internal entity *AddEntity(game_state *GameState, sprite_type SpriteType)
             Entity->Type = entity_type_Base;
             Entity->MovementType = entity_movement_type_None;
             Entity->Sprites[0].Type = SpriteType;
-            Entity->Sprites[0].SourceRectangle = R2(13,147,TILE_SIZE,TILE_SIZE);
+            Entity->Sprites[0].Id = scuba_sprite_Wall;
             Entity->Sprites[0].DepthZ = -1;
             /* TODO: Clean up the way we do collision area definition */
             Entity->CollisionAreaIndex = AddCollisionArea(GameState, Entity);
@@ -599,10 +605,10 @@ internal entity *AddEntity(game_state *GameState, sprite_type SpriteType)
             Entity->Type = entity_type_Base;
             Entity->MovementType = entity_movement_type_None;
             Entity->Sprites[0].Type = SpriteType;
-            Entity->Sprites[0].SourceRectangle = R2(90,6,110,70);
+            Entity->Sprites[0].Id = scuba_sprite_CageBack;
             Entity->Sprites[0].DepthZ = 0;
             Entity->Sprites[1].Type = SpriteType;
-            Entity->Sprites[1].SourceRectangle = R2(90,101,110,70);
+            Entity->Sprites[1].Id = scuba_sprite_CageFront;
             Entity->Sprites[1].DepthZ = 3;
             Entity->Position = V2(0.0f, 0.0f);
             Entity->CollisionAreaIndex = AddCollisionArea(GameState, Entity);
@@ -614,7 +620,7 @@ internal entity *AddEntity(game_state *GameState, sprite_type SpriteType)
             Entity->Type = entity_type_Base;
             Entity->MovementType = entity_movement_type_None;
             Entity->Sprites[0].Type = SpriteType;
-            Entity->Sprites[0].SourceRectangle = R2(14,69,39,20);
+            Entity->Sprites[0].Id = scuba_sprite_Crab;
             Entity->Sprites[0].DepthZ = 1;
             Entity->Position = MultiplyV2S(V2(9.0f, 7.0f), TILE_SIZE * TEXTURE_MAP_SCALE);
             Entity->CollisionAreaIndex = AddCollisionArea(GameState, Entity);
@@ -748,9 +754,9 @@ internal void DrawSprite(game_state *GameState, entity *Entity)
     for (s32 I = 0; I < ENTITY_SPRITE_COUNT; ++I)
     {
         sprite Sprite = Entity->Sprites[I];
-        Rectangle SourceRectangle = Sprite.SourceRectangle;
-        Vector2 SpriteSize = (Vector2){TEXTURE_MAP_SCALE*SourceRectangle.width,
-                                       TEXTURE_MAP_SCALE*SourceRectangle.height};
+        /* NOTE: The atlas is already at TEXTURE_MAP_SCALE, so sprites are drawn at their size in it. */
+        Rectangle SourceRectangle = ScubaSpriteRects[SPRITE_SCALE_INDEX][Sprite.Id];
+        Vector2 SpriteSize = (Vector2){SourceRectangle.width, SourceRectangle.height};
         /* TODO: Get rid of control flow involving debug state, so that debug code can be compiled out. */
         if (DebugPause)
         {
@@ -1421,10 +1427,10 @@ internal void UpdateEntity(game_state *GameState, entity *Entity, f32 DeltaTime)
 
 internal Rectangle GetSpriteRectangle(entity *Entity)
 {
-    Rectangle SourceRectangle = Entity->Sprites[0].SourceRectangle;
+    Rectangle SourceRectangle = ScubaSpriteRects[SPRITE_SCALE_INDEX][Entity->Sprites[0].Id];
 
-    f32 Width = TEXTURE_MAP_SCALE * SourceRectangle.width;
-    f32 Height = TEXTURE_MAP_SCALE * SourceRectangle.height;
+    f32 Width = SourceRectangle.width;
+    f32 Height = SourceRectangle.height;
 
     Rectangle SpriteRectangle = (Rectangle){
         Entity->Position.x - (Width / 2.0f),
@@ -2395,44 +2401,12 @@ internal game_state InitGameState(Texture2D ScubaTexture)
 internal b32 LoadScubaTexture(Texture2D *Texture)
 {
     b32 Error = 0;
-    s32 AssetSize = ArrayCount(AssetData);
+    *Texture = LoadPackTexture(GetAssetPack(ScubaPack), ScubaSpriteAtlasNames[SPRITE_SCALE_INDEX]);
 
-    if (AssetSize > 2)
+    if (!IsTextureReady(*Texture))
     {
-        u32 AssetWidth = AssetData[0];
-        u32 AssetHeight = AssetData[1];
-        u64 PixelCount = AssetWidth * AssetHeight;
-
-        Image ScubaImage = GenImageColor(AssetWidth, AssetHeight, (Color){255,0,255,255});
-
-        for (u64 I = 2; I < PixelCount + 2; ++I)
-        {
-            u32 X = (I - 2) % AssetWidth;
-            u32 Y = (I - 2) / AssetWidth;
-            if (X < AssetWidth && X >= 0 && Y < AssetHeight && Y >= 0)
-            {
-                /* NOTE: We could pack our colors and just cast the u32,
-                 * but for now we break the color components out and re-write them. */
-                u8 R = (AssetData[I] >> 24) & 0xff;
-                u8 G = (AssetData[I] >> 16) & 0xff;
-                u8 B = (AssetData[I] >>  8) & 0xff;
-                u8 A = (AssetData[I]      ) & 0xff;
-                Color PixelColor = (Color){R, G, B, A};
-
-                ImageDrawPixel(&ScubaImage, X, Y, PixelColor);
-            }
-            else
-            {
-                LogError("out of bounds scuba asset access");
-                break;
-            }
-        }
-
-        *Texture = LoadTextureFromImage(ScubaImage);
-    }
-    else
-    {
-        LogError("Scuba asset is too small to be useful, there was likely an error generating game assets.");
+        LogError("Scuba asset pack has no usable image, there was likely an error generating game assets.");
+        Error = 1;
     }
 
     return Error;
@@ -2450,10 +2424,7 @@ int main(void)
 
     InitWindow(Screen_Width, Screen_Height, "SCUBA");
 
-    s32 FontSize = 32;
-    s32 *Chars = 0;
-    s32 GlyphCount = 0;
-    Font LoadedFont = LoadFontFromMemory(".ttf", FontData, ArrayCount(FontData), FontSize, Chars, GlyphCount);
+    Font LoadedFont = LoadPackBakedFont(GetAssetPack(ScubaPack), "scuba.font");
 
     Texture2D ScubaTexture = {0};
     b32 TextureError = LoadScubaTexture(&ScubaTexture);
@@ -0,0 +1,827 @@
+/*
+  A static file server for the generated site, meant for local development.
+
+  One thread runs an event loop over non-blocking sockets with kqueue.
+  File bodies are sent with sendfile, so they never get copied through the process. If the client
+  accepts it and CompressSite wrote a .br or .gz next to the file, the compressed file is sent
+  instead. ETags are hashes of the bytes being sent, so the browser can revalidate with
+  If-None-Match and get back a 304.
+
+  Only GET and HEAD are handled. Connections are kept alive unless the client asks to close them,
+  and pipelined requests are answered in order.
+*/
+
+#define SERVER_PORT 8000
+#define SERVER_ROOT "../site"
+#define SERVER_CONNECTION_MAX 256
+#define SERVER_REQUEST_MAX 8192
+#define SERVER_HEADER_MAX 1024
+#define SERVER_PATH_MAX 1024
+#define SERVER_EVENT_MAX 64
+#define SERVER_ETAG_SLOT_COUNT 1024 /* NOTE: Must be a power of two. */
+
+typedef struct
+{
+    u8 *Extension;
+    u8 *ContentType;
+} content_type;
+
+global_variable content_type ContentTypes[] = {
+    {(u8 *)".html", (u8 *)"text/html; charset=utf-8"},
+    {(u8 *)".css",  (u8 *)"text/css; charset=utf-8"},
+    {(u8 *)".js",   (u8 *)"text/javascript; charset=utf-8"},
+    {(u8 *)".wasm", (u8 *)"application/wasm"},
+    {(u8 *)".json", (u8 *)"application/json"},
+    {(u8 *)".txt",  (u8 *)"text/plain; charset=utf-8"},
+    {(u8 *)".png",  (u8 *)"image/png"},
+    {(u8 *)".jpg",  (u8 *)"image/jpeg"},
+    {(u8 *)".jpeg", (u8 *)"image/jpeg"},
+    {(u8 *)".gif",  (u8 *)"image/gif"},
+    {(u8 *)".svg",  (u8 *)"image/svg+xml"},
+    {(u8 *)".ico",  (u8 *)"image/x-icon"},
+    {(u8 *)".data", (u8 *)"application/octet-stream"},
+};
+
+typedef enum
+{
+    server_connection_state_Free,
+    server_connection_state_Reading,
+    server_connection_state_Writing,
+} server_connection_state;
+
+typedef struct server_connection server_connection;
+struct server_connection
+{
+    server_connection *NextFree;
+    server_connection_state State;
+    s32 Socket;
+    b32 KeepAlive;
+    b32 WantsWrite; /* NOTE: Whether the poller was last asked for writable or readable events. */
+
+    s32 RequestSize;
+    s32 RequestUsed; /* NOTE: Bytes of Request taken up by the request being answered. */
+    u8 Request[SERVER_REQUEST_MAX];
+
+    s32 HeaderSize;
+    s32 HeaderSent;
+    u8 Header[SERVER_HEADER_MAX];
+
+    s32 File; /* NOTE: -1 if there is no body to send from a file. */
+    u64 FileOffset;
+    u64 FileSize;
+};
+
+typedef struct
+{
+    u8 *Path;
+    u64 PathHash;
+    u64 Size;
+    u64 ModifiedTime;
+    u64 ContentHash;
+} etag_entry;
+
+typedef struct
+{
+    s32 Listener;
+    s32 Poller;
+    u64 RequestCount;
+
+    ryn_memory_arena Arena; /* NOTE: Holds the etag paths, and file contents while they are hashed. */
+    etag_entry ETags[SERVER_ETAG_SLOT_COUNT];
+
+    server_connection *FreeConnections;
+    server_connection Connections[SERVER_CONNECTION_MAX];
+} file_server;
+
+internal u8 *GetContentType(u8 *Path)
+{
+    u8 *Result = (u8 *)"application/octet-stream";
+    s32 PathLength = GetStringLength(Path);
+
+    for (u32 I = 0; I < ArrayCount(ContentTypes); ++I)
+    {
+        s32 ExtensionLength = GetStringLength(ContentTypes[I].Extension);
+
+        if (PathLength >= ExtensionLength && StringsEqual(Path + PathLength - ExtensionLength, ContentTypes[I].Extension))
+        {
+            Result = ContentTypes[I].ContentType;
+            break;
+        }
+    }
+
+    return Result;
+}
+
+internal u8 ToLowerAscii(u8 Char)
+{
+    u8 Result = (Char >= 'A' && Char <= 'Z') ? Char + ('a' - 'A') : Char;
+    return Result;
+}
+
+/* If Line is the header called Name, return the offset of its value, otherwise return 0. */
+internal s32 MatchHeaderName(u8 *Line, s32 LineSize, char *Name)
+{
+    s32 NameLength = GetStringLength((u8 *)Name);
+    s32 Result = 0;
+
+    if (LineSize > NameLength && Line[NameLength] == ':')
+    {
+        s32 I = 0;
+
+        while (I < NameLength && ToLowerAscii(Line[I]) == ToLowerAscii((u8)Name[I]))
+        {
+            I += 1;
+        }
+
+        if (I == NameLength)
+        {
+            Result = SkipSpaceInSlice(Line, LineSize, NameLength + 1);
+        }
+    }
+
+    return Result;
+}
+
+/* Check a comma separated header value like "gzip, deflate, br;q=0.5" for Token. A q of 0 means not accepted. */
+internal b32 HeaderValueHasToken(u8 *Value, s32 ValueSize, char *Token)
+{
+    s32 TokenLength = GetStringLength((u8 *)Token);
+    s32 I = 0;
+
+    while (I < ValueSize)
+    {
+        I = SkipSpaceInSlice(Value, ValueSize, I);
+
+        s32 Start = I;
+        while (I < ValueSize && Value[I] != ',' && Value[I] != ';' && Value[I] != ' ')
+        {
+            I += 1;
+        }
+
+        b32 Matches = I - Start == TokenLength;
+        for (s32 J = 0; Matches && J < TokenLength; ++J)
+        {
+            Matches = ToLowerAscii(Value[Start + J]) == ToLowerAscii((u8)Token[J]);
+        }
+
+        s32 ParameterStart = I;
+        while (I < ValueSize && Value[I] != ',')
+        {
+            I += 1;
+        }
+
+        if (Matches)
+        {
+            s64 Q = FindBytes(Value + ParameterStart, I - ParameterStart, (u8 *)"q=0", 3);
+            b32 IsRejected = Q >= 0 && (ParameterStart + Q + 3 >= I || Value[ParameterStart + Q + 3] != '.');
+            return !IsRejected;
+        }
+
+        I += 1;
+    }
+
+    return 0;
+}
+
+/* Turn the request target into a path under SERVER_ROOT. Returns 0 if the target isn't a safe path. */
+internal b32 GetRequestFilePath(u8 *Target, s32 TargetSize, u8 *Path, s32 PathMax)
+{
+    s32 PathSize = GetStringLength((u8 *)SERVER_ROOT);
+
+    if (TargetSize <= 0 || Target[0] != '/' || PathSize + TargetSize + 16 > PathMax)
+    {
+        return 0;
+    }
+
+    core_CopyMemory((u8 *)SERVER_ROOT, Path, PathSize);
+
+    for (s32 I = 0; I < TargetSize && Target[I] != '?' && Target[I] != '#'; ++I)
+    {
+        u8 Char = Target[I];
+
+        if (Char == '%' && I + 2 < TargetSize)
+        {
+            u8 Hex[3] = { Target[I + 1], Target[I + 2], 0 };
+            char *End = 0;
+            Char = (u8)strtol((char *)Hex, &End, 16);
+
+            if (End != (char *)Hex + 2)
+            {
+                return 0;
+            }
+
+            I += 2;
+        }
+
+        if (Char == 0 || Char == '\\')
+        {
+            return 0;
+        }
+
+        Path[PathSize++] = Char;
+    }
+
+    Path[PathSize] = 0;
+
+    /* NOTE: Don't let ".." segments climb out of the site directory. */
+    s32 RootSize = GetStringLength((u8 *)SERVER_ROOT);
+    if (FindBytes(Path + RootSize, PathSize - RootSize, (u8 *)"/../", 4) >= 0 ||
+        (PathSize >= 3 && StringsEqual(Path + PathSize - 3, (u8 *)"/..")))
+    {
+        return 0;
+    }
+
+    if (Path[PathSize - 1] == '/')
+    {
+        core_CopyMemory((u8 *)"index.html", Path + PathSize, 11);
+    }
+
+    return 1;
+}
+
+/* Hash the file's contents, reusing the last hash while its size and modified time stay the same. */
+internal u64 GetFileETag(file_server *Server, u8 *Path, file_info FileInfo)
+{
+    s32 PathLength = GetStringLength(Path);
+    u64 PathHash = HashBytes(Path, PathLength);
+    u32 Mask = SERVER_ETAG_SLOT_COUNT - 1;
+    etag_entry *Entry = 0;
+
+    for (u32 Probe = 0; Probe < SERVER_ETAG_SLOT_COUNT; ++Probe)
+    {
+        etag_entry *Slot = &Server->ETags[(PathHash + Probe) & Mask];
+
+        if (!Slot->Path || (Slot->PathHash == PathHash && StringsEqual(Slot->Path, Path)))
+        {
+            Entry = Slot;
+            break;
+        }
+    }
+
+    if (Entry && Entry->Path && Entry->Size == FileInfo.Size && Entry->ModifiedTime == FileInfo.ModifiedTime)
+    {
+        return Entry->ContentHash;
+    }
+
+    u64 ArenaOffset = Server->Arena.Offset;
+    u8 *Data = ryn_memory_PushSize(&Server->Arena, FileInfo.Size + 1);
+    u64 BytesRead = Data ? ReadFileIntoData(Path, Data, FileInfo.Size) : 0;
+    u64 ContentHash = HashBytes(Data, BytesRead);
+    Server->Arena.Offset = ArenaOffset;
+
+    if (Entry && BytesRead == FileInfo.Size)
+    {
+        if (!Entry->Path)
+        {
+            Entry->Path = PushCString(&Server->Arena, Path);
+            Entry->PathHash = PathHash;
+        }
+
+        Entry->Size = FileInfo.Size;
+        Entry->ModifiedTime = FileInfo.ModifiedTime;
+        Entry->ContentHash = ContentHash;
+    }
+
+    return ContentHash;
+}
+
+internal void SetErrorResponse(server_connection *Connection, char *Status)
+{
+    Connection->HeaderSize = snprintf((char *)Connection->Header, SERVER_HEADER_MAX,
+                                      "HTTP/1.1 %s\r\n"
+                                      "Content-Type: text/plain; charset=utf-8\r\n"
+                                      "Content-Length: %d\r\n"
+                                      "Connection: %s\r\n"
+                                      "\r\n"
+                                      "%s\n",
+                                      Status, GetStringLength((u8 *)Status) + 1,
+                                      Connection->KeepAlive ? "keep-alive" : "close", Status);
+}
+
+/* Work out the response to the request in Connection->Request[0..HeaderEnd], leaving it ready to send. */
+internal void PrepareResponse(file_server *Server, server_connection *Connection, s32 HeaderEnd)
+{
+    u8 *Request = Connection->Request;
+    u8 *Method = Request;
+    s32 MethodSize = 0;
+    u8 *Target = 0;
+    s32 TargetSize = 0;
+    b32 IsHttp10 = 0;
+    b32 AcceptsGzip = 0;
+    b32 AcceptsBrotli = 0;
+    u8 *IfNoneMatch = 0;
+    s32 IfNoneMatchSize = 0;
+    s32 ConnectionHeader = 0; /* NOTE: 1 for close, 2 for keep-alive. */
+
+    Server->RequestCount += 1;
+    Connection->State = server_connection_state_Writing;
+    Connection->RequestUsed = HeaderEnd;
+    Connection->HeaderSent = 0;
+    Connection->File = -1;
+    Connection->FileOffset = 0;
+    Connection->FileSize = 0;
+
+    { /* Parse the request line and the headers we care about. */
+        s32 LineStart = 0;
+        b32 IsFirstLine = 1;
+
+        while (LineStart < HeaderEnd)
+        {
+            s32 LineEnd = LineStart;
+            while (LineEnd < HeaderEnd && Request[LineEnd] != '\r' && Request[LineEnd] != '\n')
+            {
+                LineEnd += 1;
+            }
+
+            u8 *Line = Request + LineStart;
+            s32 LineSize = LineEnd - LineStart;
+            s32 ValueOffset;
+
+            if (IsFirstLine)
+            {
+                while (MethodSize < LineSize && Line[MethodSize] != ' ')
+                {
+                    MethodSize += 1;
+                }
+
+                s32 TargetStart = MethodSize + 1;
+                TargetSize = 0;
+                while (TargetStart + TargetSize < LineSize && Line[TargetStart + TargetSize] != ' ')
+                {
+                    TargetSize += 1;
+                }
+
+                Target = Line + TargetStart;
+                IsHttp10 = FindBytes(Line, LineSize, (u8 *)"HTTP/1.0", 8) >= 0;
+                IsFirstLine = 0;
+            }
+            else if ((ValueOffset = MatchHeaderName(Line, LineSize, "Connection")))
+            {
+                ConnectionHeader = HeaderValueHasToken(Line + ValueOffset, LineSize - ValueOffset, "close") ? 1 :
+                                   HeaderValueHasToken(Line + ValueOffset, LineSize - ValueOffset, "keep-alive") ? 2 : 0;
+            }
+            else if ((ValueOffset = MatchHeaderName(Line, LineSize, "Accept-Encoding")))
+            {
+                AcceptsGzip = HeaderValueHasToken(Line + ValueOffset, LineSize - ValueOffset, "gzip");
+                AcceptsBrotli = HeaderValueHasToken(Line + ValueOffset, LineSize - ValueOffset, "br");
+            }
+            else if ((ValueOffset = MatchHeaderName(Line, LineSize, "If-None-Match")))
+            {
+                IfNoneMatch = Line + ValueOffset;
+                IfNoneMatchSize = LineSize - ValueOffset;
+            }
+
+            LineStart = LineEnd;
+            while (LineStart < HeaderEnd && (Request[LineStart] == '\r' || Request[LineStart] == '\n'))
+            {
+                LineStart += 1;
+            }
+        }
+    }
+
+    Connection->KeepAlive = IsHttp10 ? ConnectionHeader == 2 : ConnectionHeader != 1;
+
+    b32 IsHead = MethodSize == 4 && FindBytes(Method, MethodSize, (u8 *)"HEAD", 4) == 0;
+    b32 IsGet = MethodSize == 3 && FindBytes(Method, MethodSize, (u8 *)"GET", 3) == 0;
+    u8 Path[SERVER_PATH_MAX];
+    struct stat Stat;
+
+    if (!IsGet && !IsHead)
+    {
+        SetErrorResponse(Connection, "405 Method Not Allowed");
+        return;
+    }
+    else if (!GetRequestFilePath(Target, TargetSize, Path, SERVER_PATH_MAX))
+    {
+        SetErrorResponse(Connection, "400 Bad Request");
+        return;
+    }
+    else if (stat((char *)Path, &Stat) != 0)
+    {
+        SetErrorResponse(Connection, "404 Not Found");
+        return;
+    }
+    else if (S_ISDIR(Stat.st_mode))
+    {
+        /* NOTE: Redirect to the slash so relative links in the index page work. */
+        s32 PathEnd = 0;
+        while (PathEnd < TargetSize && Target[PathEnd] != '?' && Target[PathEnd] != '#')
+        {
+            PathEnd += 1;
+        }
+
+        Connection->HeaderSize = snprintf((char *)Connection->Header, SERVER_HEADER_MAX,
+                                          "HTTP/1.1 301 Moved Permanently\r\n"
+                                          "Location: %.*s/%.*s\r\n"
+                                          "Content-Length: 0\r\n"
+                                          "Connection: %s\r\n"
+                                          "\r\n",
+                                          PathEnd, Target, TargetSize - PathEnd, Target + PathEnd,
+                                          Connection->KeepAlive ? "keep-alive" : "close");
+        if (Connection->HeaderSize >= SERVER_HEADER_MAX)
+        {
+            SetErrorResponse(Connection, "414 URI Too Long");
+        }
+        return;
+    }
+
+    u8 *ContentType = GetContentType(Path);
+    file_info FileInfo = platform_GetFileInfo(Path);
+    char *ContentEncoding = 0;
+    b32 HasCompressedCopy = 0;
+
+    { /* Use a precompressed copy if there is one, it is at least as new as the file, and the client takes it. */
+        char *Encodings[] = { "br", "gzip" };
+        char *Extensions[] = { ".br", ".gz" };
+        b32 Accepts[] = { AcceptsBrotli, AcceptsGzip };
+        s32 PathLength = GetStringLength(Path);
+
+        for (u32 I = 0; I < ArrayCount(Encodings); ++I)
+        {
+            u8 CompressedPath[SERVER_PATH_MAX + 8];
+            core_CopyMemory(Path, CompressedPath, PathLength);
+            core_CopyMemory((u8 *)Extensions[I], CompressedPath + PathLength, GetStringLength((u8 *)Extensions[I]) + 1);
+
+            file_info CompressedInfo = platform_GetFileInfo(CompressedPath);
+
+            if (CompressedInfo.Exists && CompressedInfo.ModifiedTime >= FileInfo.ModifiedTime)
+            {
+                HasCompressedCopy = 1;
+
+                if (Accepts[I] && !ContentEncoding)
+                {
+                    ContentEncoding = Encodings[I];
+                    FileInfo = CompressedInfo;
+                    core_CopyMemory(CompressedPath, Path, GetStringLength(CompressedPath) + 1);
+                }
+            }
+        }
+    }
+
+    u64 ETag = GetFileETag(Server, Path, FileInfo);
+    char ETagString[24];
+    snprintf(ETagString, sizeof(ETagString), "\"%016llx\"", (unsigned long long)ETag);
+
+    b32 IsNotModified = (IfNoneMatch &&
+                         (FindBytes(IfNoneMatch, IfNoneMatchSize, (u8 *)ETagString, 18) >= 0 ||
+                          (IfNoneMatchSize == 1 && IfNoneMatch[0] == '*')));
+
+    if (!IsNotModified && IsGet)
+    {
+        Connection->File = open((char *)Path, O_RDONLY);
+
+        if (Connection->File < 0)
+        {
+            SetErrorResponse(Connection, "404 Not Found");
+            return;
+        }
+
+        Connection->FileSize = FileInfo.Size;
+    }
+
+    s32 Size = snprintf((char *)Connection->Header, SERVER_HEADER_MAX,
+                        "HTTP/1.1 %s\r\n"
+                        "Content-Type: %s\r\n",
+                        IsNotModified ? "304 Not Modified" : "200 OK", ContentType);
+
+    if (!IsNotModified)
+    {
+        Size += snprintf((char *)Connection->Header + Size, SERVER_HEADER_MAX - Size,
+                         "Content-Length: %llu\r\n", (unsigned long long)FileInfo.Size);
+    }
+
+    if (ContentEncoding)
+    {
+        Size += snprintf((char *)Connection->Header + Size, SERVER_HEADER_MAX - Size,
+                         "Content-Encoding: %s\r\n", ContentEncoding);
+    }
+
+    if (HasCompressedCopy)
+    {
+        Size += snprintf((char *)Connection->Header + Size, SERVER_HEADER_MAX - Size,
+                         "Vary: Accept-Encoding\r\n");
+    }
+
+    Size += snprintf((char *)Connection->Header + Size, SERVER_HEADER_MAX - Size,
+                     "ETag: %s\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "Connection: %s\r\n"
+                     "\r\n",
+                     ETagString, Connection->KeepAlive ? "keep-alive" : "close");
+
+    Connection->HeaderSize = Size;
+}
+
+/* Ask the poller for readable or writable events on Socket. Data comes back with each event. */
+internal void WatchSocket(file_server *Server, s32 Socket, void *Data, b32 Writable)
+{
+#if ryn_memory_Mac
+    struct kevent Changes[2];
+    EV_SET(&Changes[0], Socket, Writable ? EVFILT_READ : EVFILT_WRITE, EV_DELETE, 0, 0, 0);
+    EV_SET(&Changes[1], Socket, Writable ? EVFILT_WRITE : EVFILT_READ, EV_ADD, 0, 0, Data);
+
+    /* NOTE: The delete fails if the other filter was never added, which is fine. */
+    kevent(Server->Poller, &Changes[0], 1, 0, 0, 0);
+    kevent(Server->Poller, &Changes[1], 1, 0, 0, 0);
+#endif
+}
+
+/* Returns the bytes sent, 0 if the socket can't take any more right now, or -1 on an error. */
+internal s64 SendFile(s32 Socket, s32 File, u64 Offset, u64 Size)
+{
+    s64 Result = -1;
+
+#if ryn_memory_Mac
+    off_t Length = (off_t)Size;
+    s32 Error = sendfile(File, Socket, (off_t)Offset, &Length, 0, 0);
+
+    if (Error == 0 && Length > 0)
+    {
+        Result = Length;
+    }
+    else if (Error < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        /* NOTE: Length still holds the bytes that did get sent. */
+        Result = Length;
+    }
+#endif
+
+    return Result;
+}
+
+internal void CloseConnection(file_server *Server, server_connection *Connection)
+{
+    if (Connection->File >= 0)
+    {
+        close(Connection->File);
+    }
+
+    close(Connection->Socket);
+
+    Connection->State = server_connection_state_Free;
+    Connection->File = -1;
+    Connection->NextFree = Server->FreeConnections;
+    Server->FreeConnections = Connection;
+}
+
+/* Answer every complete request in the connection's buffer, until the socket would block. */
+internal void ServiceConnection(file_server *Server, server_connection *Connection)
+{
+    for (;;)
+    {
+        if (Connection->State == server_connection_state_Reading)
+        {
+            s64 HeaderEnd = FindBytes(Connection->Request, Connection->RequestSize, (u8 *)"\r\n\r\n", 4);
+
+            if (HeaderEnd >= 0)
+            {
+                PrepareResponse(Server, Connection, (s32)HeaderEnd + 4);
+            }
+            else if (Connection->RequestSize == SERVER_REQUEST_MAX)
+            {
+                Connection->State = server_connection_state_Writing;
+                Connection->KeepAlive = 0;
+                Connection->HeaderSent = 0;
+                Connection->RequestUsed = Connection->RequestSize;
+                SetErrorResponse(Connection, "431 Request Header Fields Too Large");
+            }
+            else
+            {
+                if (Connection->WantsWrite)
+                {
+                    WatchSocket(Server, Connection->Socket, Connection, 0);
+                    Connection->WantsWrite = 0;
+                }
+                return;
+            }
+        }
+
+        b32 WouldBlock = 0;
+
+        while (!WouldBlock && Connection->HeaderSent < Connection->HeaderSize)
+        {
+            ssize_t Sent = send(Connection->Socket, Connection->Header + Connection->HeaderSent,
+                                Connection->HeaderSize - Connection->HeaderSent, 0);
+
+            if (Sent > 0)
+            {
+                Connection->HeaderSent += (s32)Sent;
+            }
+            else if (Sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                WouldBlock = 1;
+            }
+            else
+            {
+                CloseConnection(Server, Connection);
+                return;
+            }
+        }
+
+        while (!WouldBlock && Connection->File >= 0 && Connection->FileOffset < Connection->FileSize)
+        {
+            s64 Sent = SendFile(Connection->Socket, Connection->File, Connection->FileOffset,
+                                Connection->FileSize - Connection->FileOffset);
+
+            if (Sent > 0)
+            {
+                Connection->FileOffset += Sent;
+            }
+            else if (Sent == 0)
+            {
+                WouldBlock = 1;
+            }
+            else
+            {
+                CloseConnection(Server, Connection);
+                return;
+            }
+        }
+
+        if (WouldBlock)
+        {
+            if (!Connection->WantsWrite)
+            {
+                WatchSocket(Server, Connection->Socket, Connection, 1);
+                Connection->WantsWrite = 1;
+            }
+            return;
+        }
+
+        /* NOTE: The response is out, get ready for the next request on this connection. */
+        if (Connection->File >= 0)
+        {
+            close(Connection->File);
+            Connection->File = -1;
+        }
+
+        if (!Connection->KeepAlive)
+        {
+            shutdown(Connection->Socket, SHUT_WR);
+            CloseConnection(Server, Connection);
+            return;
+        }
+
+        Connection->RequestSize -= Connection->RequestUsed;
+        memmove(Connection->Request, Connection->Request + Connection->RequestUsed, Connection->RequestSize);
+        Connection->RequestUsed = 0;
+        Connection->State = server_connection_state_Reading;
+    }
+}
+
+internal void AcceptConnections(file_server *Server)
+{
+    for (;;)
+    {
+        s32 Socket = accept(Server->Listener, 0, 0);
+
+        if (Socket < 0)
+        {
+            break;
+        }
+
+        server_connection *Connection = Server->FreeConnections;
+
+        if (!Connection)
+        {
+            /* NOTE: Out of connections, the client can try again once some are closed. */
+            close(Socket);
+            continue;
+        }
+
+        s32 NoDelay = 1;
+        fcntl(Socket, F_SETFL, fcntl(Socket, F_GETFL, 0) | O_NONBLOCK);
+        setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+
+        Server->FreeConnections = Connection->NextFree;
+        Connection->NextFree = 0;
+        Connection->State = server_connection_state_Reading;
+        Connection->Socket = Socket;
+        Connection->KeepAlive = 1;
+        Connection->WantsWrite = 0;
+        Connection->RequestSize = 0;
+        Connection->RequestUsed = 0;
+        Connection->File = -1;
+
+        WatchSocket(Server, Socket, Connection, 0);
+    }
+}
+
+internal void ReadFromConnection(file_server *Server, server_connection *Connection)
+{
+    if (Connection->State != server_connection_state_Reading)
+    {
+        return;
+    }
+
+    ssize_t Received = recv(Connection->Socket, Connection->Request + Connection->RequestSize,
+                            SERVER_REQUEST_MAX - Connection->RequestSize, 0);
+
+    if (Received > 0)
+    {
+        Connection->RequestSize += (s32)Received;
+        ServiceConnection(Server, Connection);
+    }
+    else if (Received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        CloseConnection(Server, Connection);
+    }
+}
+
+/* NOTE: Only listens on localhost, this is not meant to face the network. */
+internal s32 OpenListenSocket(u16 Port)
+{
+    s32 Listener = socket(AF_INET, SOCK_STREAM, 0);
+    s32 ReuseAddress = 1;
+    struct sockaddr_in Address = {0};
+
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(Port);
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (Listener < 0)
+    {
+        printf("Error in OpenListenSocket: could not create socket\n");
+        return -1;
+    }
+
+    setsockopt(Listener, SOL_SOCKET, SO_REUSEADDR, &ReuseAddress, sizeof(ReuseAddress));
+
+    if (bind(Listener, (struct sockaddr *)&Address, sizeof(Address)) != 0 || listen(Listener, 128) != 0)
+    {
+        printf("Error in OpenListenSocket: could not listen on port %d (%s)\n", Port, strerror(errno));
+        close(Listener);
+        return -1;
+    }
+
+    fcntl(Listener, F_SETFL, fcntl(Listener, F_GETFL, 0) | O_NONBLOCK);
+
+    return Listener;
+}
+
+void ServeSite(u16 Port)
+{
+#if ryn_memory_Mac
+    file_server *Server = AllocateMemory(sizeof(file_server));
+
+    if (!Server)
+    {
+        LogError("allocating file server");
+        return;
+    }
+
+    SetMemory((u8 *)Server, 0, sizeof(file_server));
+    Server->Arena = ryn_memory_CreateArena(Gigabytes(1));
+
+    for (s32 I = SERVER_CONNECTION_MAX - 1; I >= 0; --I)
+    {
+        Server->Connections[I].File = -1;
+        Server->Connections[I].NextFree = Server->FreeConnections;
+        Server->FreeConnections = &Server->Connections[I];
+    }
+
+    /* NOTE: A client hanging up mid-response should be an error from send, not a signal that kills us. */
+    signal(SIGPIPE, SIG_IGN);
+
+    Server->Listener = OpenListenSocket(Port);
+    Server->Poller = kqueue();
+
+    if (Server->Listener < 0 || Server->Poller < 0)
+    {
+        printf("Error in ServeSite: could not start the server\n");
+        return;
+    }
+
+    /* NOTE: The listener is the only socket registered without a connection. */
+    WatchSocket(Server, Server->Listener, 0, 0);
+
+    printf("Serving %s at http://localhost:%d/\n", SERVER_ROOT, Port);
+    fflush(stdout);
+
+    for (;;)
+    {
+        struct kevent Events[SERVER_EVENT_MAX];
+        s32 ReadyCount = kevent(Server->Poller, 0, 0, Events, SERVER_EVENT_MAX, 0);
+
+        for (s32 I = 0; I < ReadyCount; ++I)
+        {
+            server_connection *Connection = Events[I].udata;
+
+            if (!Connection)
+            {
+                AcceptConnections(Server);
+            }
+            else if (Connection->State == server_connection_state_Reading)
+            {
+                ReadFromConnection(Server, Connection);
+            }
+            else if (Connection->State == server_connection_state_Writing)
+            {
+                ServiceConnection(Server, Connection);
+            }
+        }
+    }
+#else
+    printf("TODO: Implement ServeSite for Windows.\n");
+#endif
+}
@@ -0,0 +1,181 @@
+/*
+  Per-stage numbers for a site build: time, outputs built and up-to-date, and the files and bytes
+  that went through the platform layer. The report is printed after the build and also written as
+  JSON, so builds can be compared over time.
+
+  Stages are expected to run one after another on the main thread, the io counters are global so
+  they include whatever jobs a stage ran.
+*/
+
+#define SITE_REPORT_PATH "../gen/site_report.json"
+
+#define SiteStage_XList\
+    X(AssetCopy,   "asset_copy")\
+    X(CodeListing, "code_listing")\
+    X(CodePages,   "code_pages")\
+    X(BlogPages,   "blog_pages")\
+    X(LayoutPages, "layout_pages")\
+    X(Write,       "write")\
+    X(Compress,    "compress")
+
+typedef enum
+{
+#define X(name, _json_name) site_stage_##name,
+    SiteStage_XList
+#undef X
+    site_stage_Count,
+} site_stage;
+
+global_variable char *SiteStageNames[site_stage_Count] = {
+#define X(name, json_name) [site_stage_##name] = json_name,
+    SiteStage_XList
+#undef X
+};
+
+typedef struct
+{
+    b32 Ran;
+    u64 Microseconds;
+    io_counters Io;
+    s32 BuiltCount;
+    s32 SkippedCount;
+
+    /* NOTE: Values when the stage began, the rest of the fields are differences from these. */
+    u64 BeginTime;
+    io_counters BeginIo;
+    s32 BeginBuiltCount;
+    s32 BeginSkippedCount;
+} site_stage_stats;
+
+typedef struct
+{
+    site_stage_stats Stages[site_stage_Count];
+    build_manifest *Manifest; /* NOTE: Outputs built and skipped are counted from this manifest. */
+} site_report;
+
+internal void BeginSiteStage(site_report *Report, site_stage Stage)
+{
+    if (!Report)
+    {
+        return;
+    }
+
+    site_stage_stats *Stats = &Report->Stages[Stage];
+    Stats->BeginTime = ryn_ReadOSTimer();
+    Stats->BeginIo = GetIoCounters();
+    Stats->BeginBuiltCount = Report->Manifest ? Report->Manifest->BuiltCount : 0;
+    Stats->BeginSkippedCount = Report->Manifest ? Report->Manifest->SkippedCount : 0;
+}
+
+internal void EndSiteStage(site_report *Report, site_stage Stage)
+{
+    if (!Report)
+    {
+        return;
+    }
+
+    site_stage_stats *Stats = &Report->Stages[Stage];
+    io_counters Io = GetIoCounters();
+
+    /* NOTE: Add on to what is there, so a stage can be split over a few Begin/End pairs. */
+    Stats->Ran = 1;
+    Stats->Microseconds += ryn_ReadOSTimer() - Stats->BeginTime;
+    Stats->Io.FilesRead += Io.FilesRead - Stats->BeginIo.FilesRead;
+    Stats->Io.BytesRead += Io.BytesRead - Stats->BeginIo.BytesRead;
+    Stats->Io.FilesWritten += Io.FilesWritten - Stats->BeginIo.FilesWritten;
+    Stats->Io.BytesWritten += Io.BytesWritten - Stats->BeginIo.BytesWritten;
+
+    if (Report->Manifest)
+    {
+        Stats->BuiltCount += Report->Manifest->BuiltCount - Stats->BeginBuiltCount;
+        Stats->SkippedCount += Report->Manifest->SkippedCount - Stats->BeginSkippedCount;
+    }
+}
+
+/* NOTE: Throughput counts bytes read plus bytes written. */
+internal double GetSiteStageMegabytesPerSecond(site_stage_stats *Stats)
+{
+    double Megabytes = (double)(Stats->Io.BytesRead + Stats->Io.BytesWritten) / (1024.0 * 1024.0);
+    double Seconds = (double)Stats->Microseconds / 1000000.0;
+    double Result = Seconds > 0.0 ? Megabytes / Seconds : 0.0;
+    return Result;
+}
+
+internal void PrintSiteReport(site_report *Report)
+{
+    site_stage_stats Total = {0};
+
+    printf("%-14s %9s %6s %10s %6s %12s %6s %12s %9s\n",
+           "stage", "ms", "built", "up-to-date", "read", "bytes-read", "wrote", "bytes-wrote", "MB/s");
+
+    for (s32 I = 0; I < site_stage_Count; ++I)
+    {
+        site_stage_stats *Stats = &Report->Stages[I];
+
+        if (!Stats->Ran)
+        {
+            continue;
+        }
+
+        printf("%-14s %9.2f %6d %10d %6llu %12llu %6llu %12llu %9.1f\n", SiteStageNames[I],
+               (double)Stats->Microseconds / 1000.0, Stats->BuiltCount, Stats->SkippedCount,
+               (unsigned long long)Stats->Io.FilesRead, (unsigned long long)Stats->Io.BytesRead,
+               (unsigned long long)Stats->Io.FilesWritten, (unsigned long long)Stats->Io.BytesWritten,
+               GetSiteStageMegabytesPerSecond(Stats));
+
+        Total.Microseconds += Stats->Microseconds;
+        Total.BuiltCount += Stats->BuiltCount;
+        Total.SkippedCount += Stats->SkippedCount;
+        Total.Io.FilesRead += Stats->Io.FilesRead;
+        Total.Io.BytesRead += Stats->Io.BytesRead;
+        Total.Io.FilesWritten += Stats->Io.FilesWritten;
+        Total.Io.BytesWritten += Stats->Io.BytesWritten;
+    }
+
+    printf("%-14s %9.2f %6d %10d %6llu %12llu %6llu %12llu %9.1f\n", "total",
+           (double)Total.Microseconds / 1000.0, Total.BuiltCount, Total.SkippedCount,
+           (unsigned long long)Total.Io.FilesRead, (unsigned long long)Total.Io.BytesRead,
+           (unsigned long long)Total.Io.FilesWritten, (unsigned long long)Total.Io.BytesWritten,
+           GetSiteStageMegabytesPerSecond(&Total));
+}
+
+internal void WriteSiteReportJson(site_report *Report, u8 *Path)
+{
+    FILE *File = fopen((char *)Path, "wb");
+
+    if (!File)
+    {
+        printf("Error in WriteSiteReportJson: trying to open file \"%s\"\n", Path);
+        return;
+    }
+
+    date Date = GetDate();
+    b32 IsFirstStage = 1;
+
+    fprintf(File, "{\n");
+    fprintf(File, "  \"date\": \"%04d-%02d-%02d\",\n", Date.Year, Date.Month, Date.Day);
+    fprintf(File, "  \"stages\": [");
+
+    for (s32 I = 0; I < site_stage_Count; ++I)
+    {
+        site_stage_stats *Stats = &Report->Stages[I];
+
+        if (!Stats->Ran)
+        {
+            continue;
+        }
+
+        fprintf(File, "%s\n    {\"name\": \"%s\", \"ms\": %.3f, \"built\": %d, \"up_to_date\": %d, "
+                "\"files_read\": %llu, \"bytes_read\": %llu, \"files_written\": %llu, \"bytes_written\": %llu, "
+                "\"mb_per_second\": %.2f}",
+                IsFirstStage ? "" : ",", SiteStageNames[I], (double)Stats->Microseconds / 1000.0,
+                Stats->BuiltCount, Stats->SkippedCount,
+                (unsigned long long)Stats->Io.FilesRead, (unsigned long long)Stats->Io.BytesRead,
+                (unsigned long long)Stats->Io.FilesWritten, (unsigned long long)Stats->Io.BytesWritten,
+                GetSiteStageMegabytesPerSecond(Stats));
+        IsFirstStage = 0;
+    }
+
+    fprintf(File, "\n  ]\n}\n");
+    fclose(File);
+}
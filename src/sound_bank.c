@@ -0,0 +1,455 @@
+/*
+  Sound banks, described by a ../assets/<name>.sfx file:
+
+      # Comments start with a hash.
+      rate 48000
+      peak -8
+      sound sfx_win.wav
+
+  Every "sound" line is a WAV file in ../assets. The asset build mixes each sound down to mono,
+  resamples it to "rate" with a windowed-sinc filter, scales it so its loudest sample is at "peak"
+  dBFS (sounds keep their level without a peak line), and stores them all as signed 16-bit samples
+  in one bank entry (see asset_sound). The rate should be the audio device's, so playing a sound
+  doesn't resample it again.
+
+  Banks are stored uncompressed, so the game's Waves point straight at the samples in the pack.
+*/
+
+#define SOUND_BANK_SOUND_MAX 16
+#define SOUND_BANK_FILTER_ZEROS 16 /* NOTE: Zero crossings of the sinc on each side, more is a sharper filter. */
+#define SOUND_BANK_PI 3.14159265358979323846
+#define SOUND_BANK_VERSION 1 /* NOTE: Bump when decoding, resampling or the bank layout changes, so cached banks are rebuilt. */
+
+typedef struct
+{
+    u8 SoundNames[SOUND_BANK_SOUND_MAX][ASSET_PACK_NAME_MAX]; /* NOTE: Files in ../assets. */
+    u32 SoundCount;
+    u32 SampleRate;
+    b32 Normalize;
+    f32 PeakDecibels;
+} sound_bank_spec;
+
+typedef struct
+{
+    b32 Valid;
+    u16 Format;
+    u16 Channels;
+    u32 SampleRate;
+    u16 BitsPerSample;
+    u8 *Samples;
+    u64 SamplesSize;
+} wave_file;
+
+internal b32 IsRiffChunk(u8 *Id, char *Name)
+{
+    b32 Result = Id[0] == Name[0] && Id[1] == Name[1] && Id[2] == Name[2] && Id[3] == Name[3];
+    return Result;
+}
+
+/* Find the format and the samples in a RIFF/WAVE file. Samples points into Data. */
+internal wave_file ParseWaveFile(u8 *Data, u64 Size)
+{
+    wave_file Wave = {0};
+    b32 HasFormat = 0;
+
+    if (Size < 12 || !IsRiffChunk(Data, "RIFF") || !IsRiffChunk(Data + 8, "WAVE"))
+    {
+        return Wave;
+    }
+
+    u64 At = 12;
+
+    while (At + 8 <= Size)
+    {
+        u8 *Chunk = Data + At + 8;
+        u64 ChunkSize = ReadU32LE(Data + At + 4);
+
+        if (ChunkSize > Size - At - 8)
+        {
+            break;
+        }
+        else if (IsRiffChunk(Data + At, "fmt ") && ChunkSize >= 16)
+        {
+            Wave.Format = ReadU16LE(Chunk);
+            Wave.Channels = ReadU16LE(Chunk + 2);
+            Wave.SampleRate = ReadU32LE(Chunk + 4);
+            Wave.BitsPerSample = ReadU16LE(Chunk + 14);
+            HasFormat = 1;
+
+            if (Wave.Format == 0xfffe && ChunkSize >= 26)
+            {
+                /* NOTE: WAVE_FORMAT_EXTENSIBLE, the real format starts the sub-format GUID. */
+                Wave.Format = ReadU16LE(Chunk + 24);
+            }
+        }
+        else if (IsRiffChunk(Data + At, "data"))
+        {
+            Wave.Samples = Chunk;
+            Wave.SamplesSize = ChunkSize;
+        }
+
+        /* NOTE: Chunks are padded to an even size. */
+        At += 8 + ChunkSize + (ChunkSize & 1);
+    }
+
+    /* NOTE: These are the formats raylib plays from a Wave: 8 and 16 bit PCM, and 32 bit float. */
+    b32 IsPcm = Wave.Format == 1 && (Wave.BitsPerSample == 8 || Wave.BitsPerSample == 16);
+    b32 IsFloat = Wave.Format == 3 && Wave.BitsPerSample == 32;
+
+    Wave.Valid = HasFormat && Wave.Samples && Wave.Channels > 0 && (IsPcm || IsFloat);
+
+    return Wave;
+}
+
+internal b32 ParseSoundBankSpec(u8 *Path, u8 *Text, sound_bank_spec *Spec)
+{
+    s32 LineNumber = 1;
+    u8 *At = Text;
+
+    while (*At)
+    {
+        u8 Keyword[16] = {0};
+        u8 *LineStart = SkipSpriteSheetSpace(At);
+        u8 *Parsed = LineStart;
+        b32 IsBlank = *LineStart == '#' || *LineStart == '\n' || *LineStart == 0;
+
+        if (!IsBlank)
+        {
+            Parsed = ReadSpriteSheetWord(LineStart, Keyword, sizeof(Keyword));
+        }
+
+        if (IsBlank || !Parsed)
+        {
+            /* NOTE: Comment, blank line, or a keyword too long to be one. */
+        }
+        else if (StringsEqual(Keyword, (u8 *)"rate"))
+        {
+            Parsed = ReadSpriteSheetNumber(Parsed, &Spec->SampleRate);
+        }
+        else if (StringsEqual(Keyword, (u8 *)"peak"))
+        {
+            u32 Decibels = 0;
+            Parsed = SkipSpriteSheetSpace(Parsed);
+
+            /* NOTE: Only negative peaks make sense, anything above 0 dBFS would clip. */
+            if (*Parsed == '-')
+            {
+                Parsed = ReadSpriteSheetNumber(Parsed + 1, &Decibels);
+            }
+            else
+            {
+                Parsed = ReadSpriteSheetNumber(Parsed, &Decibels);
+                Parsed = Parsed && Decibels == 0 ? Parsed : 0;
+            }
+
+            Spec->Normalize = 1;
+            Spec->PeakDecibels = -(f32)Decibels;
+        }
+        else if (StringsEqual(Keyword, (u8 *)"sound") && Spec->SoundCount < SOUND_BANK_SOUND_MAX)
+        {
+            u8 *Name = Spec->SoundNames[Spec->SoundCount];
+            Parsed = ReadSpriteSheetWord(Parsed, Name, ASSET_PACK_NAME_MAX);
+            Parsed = Parsed && HasExtension(Name, ".wav") ? Parsed : 0;
+            Spec->SoundCount += Parsed != 0;
+        }
+        else
+        {
+            Parsed = 0;
+        }
+
+        if (Parsed)
+        {
+            Parsed = SkipSpriteSheetSpace(Parsed);
+        }
+
+        if (!Parsed || (*Parsed != '\n' && *Parsed != '#' && *Parsed != 0))
+        {
+            printf("Error in ParseSoundBankSpec: %s line %d is not understood\n", Path, LineNumber);
+            return 0;
+        }
+
+        while (*At && *At != '\n')
+        {
+            At += 1;
+        }
+
+        if (*At == '\n')
+        {
+            At += 1;
+            LineNumber += 1;
+        }
+    }
+
+    if (!Spec->SampleRate || !Spec->SoundCount)
+    {
+        printf("Error in ParseSoundBankSpec: %s needs a rate and at least one sound\n", Path);
+        return 0;
+    }
+
+    return 1;
+}
+
+internal b32 ReadSoundBankSound(ryn_memory_arena *Arena, u8 *Name, u8 **Data, u64 *Size)
+{
+    u8 Path[256];
+    snprintf((char *)Path, sizeof(Path), "../assets/%s", Name);
+
+    if (!platform_GetFileInfo(Path).Exists)
+    {
+        printf("Error in ReadSoundBankSound: could not find \"%s\"\n", Path);
+        return 0;
+    }
+
+    u64 Offset = Arena->Offset;
+    u64 ReadSize = ReadFileIntoAllocator(Arena, Path);
+
+    if (!ReadSize)
+    {
+        printf("Error in ReadSoundBankSound: could not read \"%s\"\n", Path);
+        return 0;
+    }
+
+    *Size = ReadSize - 1; /* NOTE: Minus 1 for the null-terminator. */
+    *Data = Arena->Data + Offset;
+
+    return 1;
+}
+
+/* NOTE: A bank depends on its .sfx file and on every sound it names, this hashes the sounds. */
+internal b32 HashSoundBankSounds(ryn_memory_arena *Arena, u8 *Path, u8 *Text, u64 *Hash)
+{
+    sound_bank_spec Spec = {0};
+    u64 Hashes[SOUND_BANK_SOUND_MAX];
+    b32 Read = ParseSoundBankSpec(Path, Text, &Spec);
+
+    for (u32 I = 0; Read && I < Spec.SoundCount; ++I)
+    {
+        u64 Offset = Arena->Offset;
+        u8 *Data;
+        u64 Size;
+        Read = ReadSoundBankSound(Arena, Spec.SoundNames[I], &Data, &Size);
+        Hashes[I] = Read ? HashBytes(Data, Size) : 0;
+        Arena->Offset = Offset;
+    }
+
+    if (Read)
+    {
+        *Hash = HashBytes((u8 *)Hashes, Spec.SoundCount * sizeof(u64));
+    }
+
+    return Read;
+}
+
+/* Mix the wave down to one channel of floats in [-1, 1]. */
+internal f32 *DecodeWaveMono(ryn_memory_arena *Arena, wave_file *Wave, u32 *FrameCount)
+{
+    u32 SampleSize = Wave->BitsPerSample / 8;
+    u32 FrameSize = SampleSize * Wave->Channels;
+    u32 Count = (u32)(Wave->SamplesSize / FrameSize);
+    f32 *Samples = ryn_memory_PushSize(Arena, Count * sizeof(f32));
+
+    if (!Samples)
+    {
+        LogError("allocating decoded sound");
+        return 0;
+    }
+
+    for (u32 F = 0; F < Count; ++F)
+    {
+        f32 Sum = 0.0f;
+
+        for (u32 C = 0; C < Wave->Channels; ++C)
+        {
+            u8 *Sample = Wave->Samples + (u64)F * FrameSize + C * SampleSize;
+            f32 Value;
+
+            if (Wave->Format == 3)
+            {
+                u32 Bits = ReadU32LE(Sample);
+                memcpy(&Value, &Bits, sizeof(Value));
+            }
+            else if (SampleSize == 2)
+            {
+                Value = (s16)ReadU16LE(Sample) / 32768.0f;
+            }
+            else
+            {
+                /* NOTE: 8-bit PCM is unsigned. */
+                Value = (Sample[0] - 128) / 128.0f;
+            }
+
+            Sum += Value;
+        }
+
+        Samples[F] = Sum / Wave->Channels;
+    }
+
+    *FrameCount = Count;
+    return Samples;
+}
+
+internal f64 Sinc(f64 X)
+{
+    f64 Result = X == 0.0 ? 1.0 : sin(SOUND_BANK_PI * X) / (SOUND_BANK_PI * X);
+    return Result;
+}
+
+/*
+  Resample with a Blackman-windowed sinc. The cutoff is the lower of the two rates' Nyquist
+  frequencies, so downsampling doesn't alias, and samples past either end count as silence.
+*/
+internal f32 *ResampleSound(ryn_memory_arena *Arena, f32 *Samples, u32 FrameCount, u32 Rate, u32 NewRate, u32 *NewFrameCount)
+{
+    if (Rate == NewRate)
+    {
+        *NewFrameCount = FrameCount;
+        return Samples;
+    }
+
+    u32 Count = (u32)(((u64)FrameCount * NewRate + Rate - 1) / Rate);
+    f32 *Resampled = ryn_memory_PushSize(Arena, Count * sizeof(f32));
+
+    if (!Resampled)
+    {
+        LogError("allocating resampled sound");
+        return 0;
+    }
+
+    f64 Step = (f64)Rate / (f64)NewRate;
+    f64 Cutoff = NewRate < Rate ? (f64)NewRate / (f64)Rate : 1.0;
+    f64 HalfWidth = SOUND_BANK_FILTER_ZEROS / Cutoff;
+
+    for (u32 I = 0; I < Count; ++I)
+    {
+        f64 Center = I * Step;
+        s64 First = (s64)ceil(Center - HalfWidth);
+        s64 Last = (s64)floor(Center + HalfWidth);
+        f64 Sum = 0.0;
+        f64 WeightSum = 0.0;
+
+        for (s64 K = First; K <= Last; ++K)
+        {
+            f64 X = (f64)K - Center;
+            f64 T = X / HalfWidth;
+            f64 Window = 0.42 + 0.5 * cos(SOUND_BANK_PI * T) + 0.08 * cos(2.0 * SOUND_BANK_PI * T);
+            f64 Weight = Cutoff * Sinc(Cutoff * X) * Window;
+            WeightSum += Weight;
+
+            if (K >= 0 && K < FrameCount)
+            {
+                Sum += Weight * Samples[K];
+            }
+        }
+
+        /* NOTE: Dividing by the weights keeps the filter's gain at exactly 1 for a constant signal. */
+        Resampled[I] = (f32)(WeightSum != 0.0 ? Sum / WeightSum : 0.0);
+    }
+
+    *NewFrameCount = Count;
+    return Resampled;
+}
+
+/*
+  Build the bank a .sfx file describes. Data gets the bank entry's data (see asset_sound) and
+  Parameters its parameters. Allocates from Arena.
+*/
+internal b32 BuildSoundBank(ryn_memory_arena *Arena, u8 *Path, u8 *Text, u8 **Data, u64 *DataSize, u32 *Parameters)
+{
+    sound_bank_spec Spec = {0};
+    f32 *Sounds[SOUND_BANK_SOUND_MAX];
+    u32 FrameCounts[SOUND_BANK_SOUND_MAX];
+    u64 TotalFrameCount = 0;
+
+    if (!ParseSoundBankSpec(Path, Text, &Spec))
+    {
+        return 0;
+    }
+
+    for (u32 I = 0; I < Spec.SoundCount; ++I)
+    {
+        u8 *FileData;
+        u64 FileSize;
+        u32 FrameCount;
+
+        if (!ReadSoundBankSound(Arena, Spec.SoundNames[I], &FileData, &FileSize))
+        {
+            return 0;
+        }
+
+        wave_file Wave = ParseWaveFile(FileData, FileSize);
+
+        if (!Wave.Valid)
+        {
+            printf("Error in BuildSoundBank: %s is not a WAV file we can read\n", Spec.SoundNames[I]);
+            return 0;
+        }
+
+        f32 *Samples = DecodeWaveMono(Arena, &Wave, &FrameCount);
+        Sounds[I] = Samples ? ResampleSound(Arena, Samples, FrameCount, Wave.SampleRate, Spec.SampleRate, &FrameCounts[I]) : 0;
+
+        if (!Sounds[I])
+        {
+            return 0;
+        }
+
+        if (Spec.Normalize)
+        {
+            f32 Peak = 0.0f;
+
+            for (u32 F = 0; F < FrameCounts[I]; ++F)
+            {
+                f32 Value = fabsf(Sounds[I][F]);
+                Peak = Value > Peak ? Value : Peak;
+            }
+
+            f32 Gain = Peak > 0.0f ? powf(10.0f, Spec.PeakDecibels / 20.0f) / Peak : 1.0f;
+
+            for (u32 F = 0; F < FrameCounts[I]; ++F)
+            {
+                Sounds[I][F] *= Gain;
+            }
+        }
+
+        TotalFrameCount += FrameCounts[I];
+    }
+
+    /* NOTE: The samples start aligned, so the game can use them as s16's in place. */
+    u64 TableSize = (Spec.SoundCount * sizeof(asset_sound) + ASSET_PACK_ALIGNMENT - 1) & ~(u64)(ASSET_PACK_ALIGNMENT - 1);
+    u64 BankSize = TableSize + TotalFrameCount * sizeof(s16);
+    u8 *Bank = ryn_memory_PushSize(Arena, BankSize);
+
+    if (!Bank || BankSize > 0xffffffff)
+    {
+        LogError("allocating sound bank");
+        return 0;
+    }
+
+    SetMemory(Bank, 0, TableSize);
+
+    asset_sound *Table = (asset_sound *)Bank;
+    s16 *Out = (s16 *)(Bank + TableSize);
+
+    for (u32 I = 0; I < Spec.SoundCount; ++I)
+    {
+        s32 NameLength = GetStringLength(Spec.SoundNames[I]) - (s32)(sizeof(".wav") - 1);
+        core_CopyMemory(Spec.SoundNames[I], Table[I].Name, NameLength);
+        Table[I].Offset = (u32)((u8 *)Out - Bank);
+        Table[I].FrameCount = FrameCounts[I];
+
+        for (u32 F = 0; F < FrameCounts[I]; ++F)
+        {
+            f32 Value = Sounds[I][F] * 32767.0f;
+            Value = Value > 32767.0f ? 32767.0f : (Value < -32768.0f ? -32768.0f : Value);
+            *Out++ = (s16)lrintf(Value);
+        }
+    }
+
+    *Data = Bank;
+    *DataSize = BankSize;
+    Parameters[0] = Spec.SoundCount;
+    Parameters[1] = Spec.SampleRate;
+    Parameters[2] = 16;
+    Parameters[3] = 1;
+
+    return 1;
+}
@@ -0,0 +1,800 @@
+/*
+  Sprite sheets, described by a ../assets/<name>.sprites file next to the image they cut up:
+
+      # Comments start with a hash.
+      image scuba.png
+      scale 4
+      sprite Fish 5 3 12 9
+
+  "sprite" lines are a name and a rectangle (x, y, width, height) in the image, and "scale" lines
+  list the scales to bake the atlas at. The asset build finds every .sprites file, packs its
+  sprites into a power-of-two atlas with a skyline packer, and writes ../gen/<name>_sprites.h with
+  an enum of sprite ids and a table of atlas rectangles for every scale. Asset pack definitions
+  name the sheet ("scuba.sprites") to get an image entry per scale, named "<name>@<scale>".
+
+  Scaled atlases are nearest-neighbour upscales, so a game drawing at TEXTURE_MAP_SCALE can copy
+  sprites 1:1 instead of stretching them on every draw. Each sheet is built by its own job, and
+  baked sheets are kept in the asset cache (see asset_cache.c).
+*/
+
+#define SPRITE_SHEET_MAX 16
+#define SPRITE_SHEET_SPRITE_MAX 64
+#define SPRITE_SHEET_SCALE_MAX 4
+#define SPRITE_ATLAS_PADDING 1 /* NOTE: Empty pixels right of and below each sprite, so filtering never bleeds between them. */
+#define SPRITE_ATLAS_SIZE_MAX 4096
+#define SPRITE_ATLAS_NAME_SUFFIX_MAX 11 /* NOTE: "@" and the 10 digits of the biggest u32 scale. */
+#define SKYLINE_RECT_MAX 256
+#define SPRITE_HEADER_TEXT_MAX Kilobytes(64)
+#define SPRITE_SHEET_ARENA_SIZE Megabytes(512)
+#define SPRITE_ATLAS_VERSION 1 /* NOTE: Bump when packing or baking changes, so cached atlases are rebuilt. */
+
+typedef struct
+{
+    u8 Name[ASSET_PACK_NAME_MAX];
+    u32 X, Y, Width, Height; /* NOTE: In the sheet's image. */
+    u32 AtlasX, AtlasY;      /* NOTE: In the atlas, at scale 1. */
+} sprite_definition;
+
+typedef struct
+{
+    u32 X;
+    u32 Y;
+    u32 Width;
+} skyline_node;
+
+typedef struct
+{
+    u32 Width, Height; /* NOTE: Padding included. */
+    u32 X, Y;          /* NOTE: Set by PackSkyline. */
+} skyline_rect;
+
+typedef struct
+{
+    u8 Name[ASSET_PACK_NAME_MAX]; /* NOTE: "<sheet>@<scale>", the asset pack entry name. */
+    u8 *Pixels;                   /* NOTE: RGBA8. */
+    u32 Width;
+    u32 Height;
+} sprite_atlas;
+
+typedef struct
+{
+    u8 Name[ASSET_PACK_NAME_MAX];      /* NOTE: The file name without ".sprites". */
+    u8 ImageName[ASSET_PACK_NAME_MAX];
+    u32 Scales[SPRITE_SHEET_SCALE_MAX];
+    u32 ScaleCount;
+    sprite_definition Sprites[SPRITE_SHEET_SPRITE_MAX];
+    u32 SpriteCount;
+    u32 AtlasWidth, AtlasHeight;       /* NOTE: At scale 1. */
+    sprite_atlas Atlases[SPRITE_SHEET_SCALE_MAX]; /* NOTE: One for each of Scales. */
+} sprite_sheet;
+
+internal b32 HasExtension(u8 *Name, char *Extension)
+{
+    s32 Length = GetStringLength(Name);
+    s32 ExtensionLength = GetStringLength((u8 *)Extension);
+    b32 Result = Length >= ExtensionLength && StringsEqual(Name + Length - ExtensionLength, (u8 *)Extension);
+    return Result;
+}
+
+internal u32 NextPowerOfTwo(u32 Value)
+{
+    u32 Result = 1;
+
+    while (Result < Value)
+    {
+        Result <<= 1;
+    }
+
+    return Result;
+}
+
+internal u8 *SkipSpriteSheetSpace(u8 *At)
+{
+    while (*At == ' ' || *At == '\t' || *At == '\r')
+    {
+        At += 1;
+    }
+
+    return At;
+}
+
+/* NOTE: Returns 0 if the word doesn't fit in WordMax, including the null-terminator. */
+internal u8 *ReadSpriteSheetWord(u8 *At, u8 *Word, s32 WordMax)
+{
+    s32 Length = 0;
+    At = SkipSpriteSheetSpace(At);
+
+    while (*At && *At != ' ' && *At != '\t' && *At != '\r' && *At != '\n')
+    {
+        if (Length + 1 >= WordMax)
+        {
+            return 0;
+        }
+
+        Word[Length++] = *At++;
+    }
+
+    Word[Length] = 0;
+    return At;
+}
+
+internal u8 *ReadSpriteSheetNumber(u8 *At, u32 *Number)
+{
+    u32 Value = 0;
+    At = SkipSpriteSheetSpace(At);
+
+    if (*At < '0' || *At > '9')
+    {
+        return 0;
+    }
+
+    while (*At >= '0' && *At <= '9')
+    {
+        Value = Value * 10 + (*At - '0');
+        At += 1;
+    }
+
+    *Number = Value;
+    return At;
+}
+
+internal b32 ParseSpriteSheet(u8 *Text, sprite_sheet *Sheet)
+{
+    s32 LineNumber = 1;
+    u8 *At = Text;
+
+    while (*At)
+    {
+        u8 Keyword[16] = {0};
+        u8 *LineStart = SkipSpriteSheetSpace(At);
+        u8 *Parsed = LineStart;
+        b32 IsBlank = *LineStart == '#' || *LineStart == '\n' || *LineStart == 0;
+
+        if (!IsBlank)
+        {
+            Parsed = ReadSpriteSheetWord(LineStart, Keyword, sizeof(Keyword));
+        }
+
+        if (IsBlank || !Parsed)
+        {
+            /* NOTE: Comment, blank line, or a keyword too long to be one. */
+        }
+        else if (StringsEqual(Keyword, (u8 *)"image"))
+        {
+            Parsed = ReadSpriteSheetWord(Parsed, Sheet->ImageName, sizeof(Sheet->ImageName));
+        }
+        else if (StringsEqual(Keyword, (u8 *)"scale") && Sheet->ScaleCount < SPRITE_SHEET_SCALE_MAX)
+        {
+            u32 *Scale = &Sheet->Scales[Sheet->ScaleCount];
+            Parsed = ReadSpriteSheetNumber(Parsed, Scale);
+            if (Parsed && (*Scale == 0 || *Scale > SPRITE_ATLAS_SIZE_MAX))
+            {
+                /* NOTE: A scale above the atlas size limit can never be baked, and would overflow the atlas sizes. */
+                Parsed = 0;
+            }
+
+            Sheet->ScaleCount += Parsed != 0;
+        }
+        else if (StringsEqual(Keyword, (u8 *)"sprite") && Sheet->SpriteCount < SPRITE_SHEET_SPRITE_MAX)
+        {
+            sprite_definition *Sprite = &Sheet->Sprites[Sheet->SpriteCount];
+            Parsed = ReadSpriteSheetWord(Parsed, Sprite->Name, sizeof(Sprite->Name));
+            Parsed = Parsed ? ReadSpriteSheetNumber(Parsed, &Sprite->X) : 0;
+            Parsed = Parsed ? ReadSpriteSheetNumber(Parsed, &Sprite->Y) : 0;
+            Parsed = Parsed ? ReadSpriteSheetNumber(Parsed, &Sprite->Width) : 0;
+            Parsed = Parsed ? ReadSpriteSheetNumber(Parsed, &Sprite->Height) : 0;
+            Sheet->SpriteCount += Parsed && Sprite->Width > 0 && Sprite->Height > 0;
+        }
+        else
+        {
+            Parsed = 0;
+        }
+
+        if (Parsed)
+        {
+            Parsed = SkipSpriteSheetSpace(Parsed);
+        }
+
+        if (!Parsed || (*Parsed != '\n' && *Parsed != '#' && *Parsed != 0))
+        {
+            printf("Error in ParseSpriteSheet: %s.sprites line %d is not understood\n", Sheet->Name, LineNumber);
+            return 0;
+        }
+
+        while (*At && *At != '\n')
+        {
+            At += 1;
+        }
+
+        if (*At == '\n')
+        {
+            At += 1;
+            LineNumber += 1;
+        }
+    }
+
+    if (!Sheet->ImageName[0] || !Sheet->SpriteCount)
+    {
+        printf("Error in ParseSpriteSheet: %s.sprites needs an image and at least one sprite\n", Sheet->Name);
+        return 0;
+    }
+
+    if (!Sheet->ScaleCount)
+    {
+        Sheet->Scales[Sheet->ScaleCount++] = 1;
+    }
+
+    return 1;
+}
+
+/*
+  The height the skyline would put a Width wide rectangle at, if its left edge is on node Index.
+  Returns 0 if it doesn't fit in the atlas.
+*/
+internal b32 FitSkyline(skyline_node *Nodes, u32 NodeCount, u32 Index, u32 Width, u32 Height,
+                        u32 AtlasWidth, u32 AtlasHeight, u32 *Y)
+{
+    u32 Top = 0;
+    u32 Remaining = Width;
+
+    if (Nodes[Index].X + Width > AtlasWidth)
+    {
+        return 0;
+    }
+
+    for (u32 I = Index; Remaining > 0; ++I)
+    {
+        if (I == NodeCount)
+        {
+            return 0;
+        }
+
+        Top = Nodes[I].Y > Top ? Nodes[I].Y : Top;
+        Remaining -= Nodes[I].Width < Remaining ? Nodes[I].Width : Remaining;
+    }
+
+    if (Top + Height > AtlasHeight)
+    {
+        return 0;
+    }
+
+    *Y = Top;
+    return 1;
+}
+
+/*
+  Bottom-left skyline packing: the skyline is the top edge of everything placed so far, as a list
+  of horizontal segments, and each rectangle goes where it ends up lowest. Rectangles are placed
+  tallest first, which keeps the skyline flat.
+*/
+internal b32 PackSkyline(skyline_rect *Rects, u32 RectCount, u32 AtlasWidth, u32 AtlasHeight)
+{
+    skyline_node Nodes[SKYLINE_RECT_MAX + 1];
+    u32 NodeCount = 1;
+    u32 Order[SKYLINE_RECT_MAX];
+
+    if (RectCount > SKYLINE_RECT_MAX)
+    {
+        return 0;
+    }
+
+    Nodes[0] = (skyline_node){0, 0, AtlasWidth};
+
+    for (u32 I = 0; I < RectCount; ++I)
+    {
+        u32 J = I;
+
+        while (J > 0 && Rects[Order[J-1]].Height < Rects[I].Height)
+        {
+            Order[J] = Order[J-1];
+            J -= 1;
+        }
+
+        Order[J] = I;
+    }
+
+    for (u32 I = 0; I < RectCount; ++I)
+    {
+        skyline_rect *Rect = &Rects[Order[I]];
+        u32 Width = Rect->Width;
+        u32 Height = Rect->Height;
+        u32 BestIndex = NodeCount;
+        u32 BestBottom = 0xffffffff;
+        u32 BestNodeWidth = 0xffffffff;
+        u32 BestY = 0;
+
+        for (u32 N = 0; N < NodeCount; ++N)
+        {
+            u32 Y;
+
+            if (FitSkyline(Nodes, NodeCount, N, Width, Height, AtlasWidth, AtlasHeight, &Y) &&
+                (Y + Height < BestBottom || (Y + Height == BestBottom && Nodes[N].Width < BestNodeWidth)))
+            {
+                BestIndex = N;
+                BestBottom = Y + Height;
+                BestNodeWidth = Nodes[N].Width;
+                BestY = Y;
+            }
+        }
+
+        if (BestIndex == NodeCount)
+        {
+            return 0;
+        }
+
+        Rect->X = Nodes[BestIndex].X;
+        Rect->Y = BestY;
+
+        { /* Raise the skyline over the new rectangle. */
+            skyline_node NewNode = {Rect->X, BestY + Height, Width};
+            u32 Right = NewNode.X + NewNode.Width;
+
+            for (u32 N = NodeCount; N > BestIndex; --N)
+            {
+                Nodes[N] = Nodes[N-1];
+            }
+
+            Nodes[BestIndex] = NewNode;
+            NodeCount += 1;
+
+            /* NOTE: Cut the covered part off the nodes to the right, removing the ones it covers entirely. */
+            u32 N = BestIndex + 1;
+            while (N < NodeCount && Nodes[N].X < Right)
+            {
+                u32 Overlap = Right - Nodes[N].X;
+
+                if (Overlap >= Nodes[N].Width)
+                {
+                    for (u32 M = N; M + 1 < NodeCount; ++M)
+                    {
+                        Nodes[M] = Nodes[M+1];
+                    }
+
+                    NodeCount -= 1;
+                }
+                else
+                {
+                    Nodes[N].X += Overlap;
+                    Nodes[N].Width -= Overlap;
+                    break;
+                }
+            }
+
+            for (N = 0; N + 1 < NodeCount;)
+            {
+                if (Nodes[N].Y == Nodes[N+1].Y)
+                {
+                    Nodes[N].Width += Nodes[N+1].Width;
+
+                    for (u32 M = N + 1; M + 1 < NodeCount; ++M)
+                    {
+                        Nodes[M] = Nodes[M+1];
+                    }
+
+                    NodeCount -= 1;
+                }
+                else
+                {
+                    N += 1;
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+/*
+  Pack the rectangles into the smallest power-of-two atlas, up to SizeMax on a side. Sizes are tried
+  from the smallest that could hold every rectangle, growing the shorter side first.
+*/
+internal b32 PackSkylineAtlas(skyline_rect *Rects, u32 RectCount, u32 SizeMax, u32 *AtlasWidth, u32 *AtlasHeight)
+{
+    u64 Area = 0;
+    u32 MaxWidth = 0;
+    u32 MaxHeight = 0;
+
+    for (u32 I = 0; I < RectCount; ++I)
+    {
+        Area += (u64)Rects[I].Width * (u64)Rects[I].Height;
+        MaxWidth = Rects[I].Width > MaxWidth ? Rects[I].Width : MaxWidth;
+        MaxHeight = Rects[I].Height > MaxHeight ? Rects[I].Height : MaxHeight;
+    }
+
+    u32 Width = NextPowerOfTwo(MaxWidth);
+    u32 Height = NextPowerOfTwo(MaxHeight);
+
+    while (Width <= SizeMax && Height <= SizeMax)
+    {
+        if ((u64)Width * (u64)Height >= Area && PackSkyline(Rects, RectCount, Width, Height))
+        {
+            *AtlasWidth = Width;
+            *AtlasHeight = Height;
+            return 1;
+        }
+
+        if (Width <= Height)
+        {
+            Width *= 2;
+        }
+        else
+        {
+            Height *= 2;
+        }
+    }
+
+    return 0;
+}
+
+internal b32 PackSpriteAtlas(sprite_sheet *Sheet)
+{
+    skyline_rect Rects[SPRITE_SHEET_SPRITE_MAX];
+
+    for (u32 I = 0; I < Sheet->SpriteCount; ++I)
+    {
+        Rects[I].Width = Sheet->Sprites[I].Width + SPRITE_ATLAS_PADDING;
+        Rects[I].Height = Sheet->Sprites[I].Height + SPRITE_ATLAS_PADDING;
+    }
+
+    if (!PackSkylineAtlas(Rects, Sheet->SpriteCount, SPRITE_ATLAS_SIZE_MAX, &Sheet->AtlasWidth, &Sheet->AtlasHeight))
+    {
+        printf("Error in PackSpriteAtlas: the sprites in %s.sprites don't fit in a %dx%d atlas\n",
+               Sheet->Name, SPRITE_ATLAS_SIZE_MAX, SPRITE_ATLAS_SIZE_MAX);
+        return 0;
+    }
+
+    for (u32 I = 0; I < Sheet->SpriteCount; ++I)
+    {
+        Sheet->Sprites[I].AtlasX = Rects[I].X;
+        Sheet->Sprites[I].AtlasY = Rects[I].Y;
+    }
+
+    return 1;
+}
+
+/* NOTE: The atlases of a sheet are allocated as one block, in order of scale. */
+internal u64 SetSpriteAtlasPixels(sprite_sheet *Sheet, u8 *Pixels)
+{
+    u64 Offset = 0;
+
+    for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+    {
+        sprite_atlas *Atlas = &Sheet->Atlases[S];
+        Atlas->Pixels = Pixels ? Pixels + Offset : 0;
+        Offset += (u64)Atlas->Width * (u64)Atlas->Height * 4;
+    }
+
+    return Offset;
+}
+
+/* Copy the sprites out of the sheet's image into an atlas for every scale, upscaling with nearest-neighbour. */
+internal b32 BakeSpriteAtlases(ryn_memory_arena *Arena, sprite_sheet *Sheet, u32 *Pixels, u32 ImageWidth, u32 ImageHeight)
+{
+    for (u32 I = 0; I < Sheet->SpriteCount; ++I)
+    {
+        sprite_definition *Sprite = &Sheet->Sprites[I];
+
+        if (Sprite->X + Sprite->Width > ImageWidth || Sprite->Y + Sprite->Height > ImageHeight)
+        {
+            printf("Error in BakeSpriteAtlases: sprite %s is outside of %s\n", Sprite->Name, Sheet->ImageName);
+            return 0;
+        }
+    }
+
+    for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+    {
+        u32 Scale = Sheet->Scales[S];
+        sprite_atlas *Atlas = &Sheet->Atlases[S];
+        Atlas->Width = NextPowerOfTwo(Sheet->AtlasWidth * Scale);
+        Atlas->Height = NextPowerOfTwo(Sheet->AtlasHeight * Scale);
+        s32 NameLength = snprintf((char *)Atlas->Name, sizeof(Atlas->Name), "%s@%u", Sheet->Name, Scale);
+
+        if (NameLength < 0 || NameLength >= (s32)sizeof(Atlas->Name))
+        {
+            printf("Error in BakeSpriteAtlases: the atlas name for %s at scale %u is too long\n", Sheet->Name, Scale);
+            return 0;
+        }
+
+        if (Atlas->Width > SPRITE_ATLAS_SIZE_MAX || Atlas->Height > SPRITE_ATLAS_SIZE_MAX)
+        {
+            printf("Error in BakeSpriteAtlases: %s at scale %d is bigger than %dx%d\n",
+                   Sheet->Name, Scale, SPRITE_ATLAS_SIZE_MAX, SPRITE_ATLAS_SIZE_MAX);
+            return 0;
+        }
+    }
+
+    u64 AtlasesSize = SetSpriteAtlasPixels(Sheet, 0);
+    u8 *AtlasesPixels = ryn_memory_PushSize(Arena, AtlasesSize);
+
+    if (!AtlasesPixels)
+    {
+        LogError("allocating sprite atlases");
+        return 0;
+    }
+
+    SetMemory(AtlasesPixels, 0, AtlasesSize);
+    SetSpriteAtlasPixels(Sheet, AtlasesPixels);
+
+    for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+    {
+        u32 Scale = Sheet->Scales[S];
+        sprite_atlas *Atlas = &Sheet->Atlases[S];
+        u32 *AtlasPixels = (u32 *)Atlas->Pixels;
+
+        for (u32 I = 0; I < Sheet->SpriteCount; ++I)
+        {
+            sprite_definition *Sprite = &Sheet->Sprites[I];
+
+            for (u32 Y = 0; Y < Sprite->Height * Scale; ++Y)
+            {
+                u32 *Source = Pixels + (Sprite->Y + Y / Scale) * ImageWidth + Sprite->X;
+                u32 *Destination = AtlasPixels + (Sprite->AtlasY * Scale + Y) * Atlas->Width + Sprite->AtlasX * Scale;
+
+                for (u32 X = 0; X < Sprite->Width * Scale; ++X)
+                {
+                    Destination[X] = Source[X / Scale];
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+internal void WriteSpriteHeader(ryn_memory_arena *Arena, build_manifest *Manifest, sprite_sheet *Sheet)
+{
+    u8 EnumName[ASSET_PACK_NAME_MAX + 8];
+    u8 TableName[ASSET_PACK_NAME_MAX + 8];
+    u8 MacroName[ASSET_PACK_NAME_MAX + 8];
+    u8 HeaderPath[256];
+    u8 *Text = ryn_memory_PushSize(Arena, SPRITE_HEADER_TEXT_MAX);
+    u64 Size = 0;
+    u64 Capacity = SPRITE_HEADER_TEXT_MAX;
+
+    if (!Text)
+    {
+        LogError("allocating sprite header text");
+        return;
+    }
+
+    snprintf((char *)EnumName, sizeof(EnumName), "%s_sprite", Sheet->Name);
+    snprintf((char *)TableName, sizeof(TableName), "%s", Sheet->Name);
+    snprintf((char *)MacroName, sizeof(MacroName), "%s_SPRITE", Sheet->Name);
+    TableName[0] = (TableName[0] >= 'a' && TableName[0] <= 'z') ? TableName[0] - 'a' + 'A' : TableName[0];
+
+    for (u8 *At = MacroName; *At; ++At)
+    {
+        *At = (*At >= 'a' && *At <= 'z') ? *At - 'a' + 'A' : *At;
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "/* NOTE: Generated by \"main.out game_assets\" from assets/%s.sprites, don't edit. */\n"
+                     "typedef enum\n{\n", Sheet->Name);
+
+    for (u32 I = 0; I < Sheet->SpriteCount; ++I)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "    %s_%s,\n", EnumName, Sheet->Sprites[I].Name);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size, "    %s_Count,\n} %s;\n\n", EnumName, EnumName);
+
+    /* NOTE: SCALE_INDEX_<scale> only exists for baked scales, so asking for a missing one is a compile error. */
+    for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "#define %s_SCALE_INDEX_%u %u\n", MacroName, Sheet->Scales[S], S);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size, "#define %s_SCALE_COUNT %u\n\n", MacroName, Sheet->ScaleCount);
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "/* NOTE: Asset pack entry names of the atlas at each scale. */\n"
+                     "global_variable char *%sSpriteAtlasNames[%s_SCALE_COUNT] = {", TableName, MacroName);
+
+    for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+    {
+        Size += snprintf((char *)Text + Size, Capacity - Size, "%s\"%s\"", S ? ", " : "", Sheet->Atlases[S].Name);
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size,
+                     "};\n\nglobal_variable Rectangle %sSpriteRects[%s_SCALE_COUNT][%s_Count] = {\n",
+                     TableName, MacroName, EnumName);
+
+    for (u32 S = 0; S < Sheet->ScaleCount; ++S)
+    {
+        u32 Scale = Sheet->Scales[S];
+        Size += snprintf((char *)Text + Size, Capacity - Size, "    { /* %ux, %ux%u */\n", Scale,
+                         Sheet->Atlases[S].Width, Sheet->Atlases[S].Height);
+
+        for (u32 I = 0; I < Sheet->SpriteCount; ++I)
+        {
+            sprite_definition *Sprite = &Sheet->Sprites[I];
+            Size += snprintf((char *)Text + Size, Capacity - Size, "        {%u.0f, %u.0f, %u.0f, %u.0f}, /* %s */\n",
+                             Sprite->AtlasX * Scale, Sprite->AtlasY * Scale,
+                             Sprite->Width * Scale, Sprite->Height * Scale, Sprite->Name);
+        }
+
+        Size += snprintf((char *)Text + Size, Capacity - Size, "    },\n");
+    }
+
+    Size += snprintf((char *)Text + Size, Capacity - Size, "};\n");
+
+    if (Size >= Capacity)
+    {
+        printf("Error in WriteSpriteHeader: the header for %s.sprites is too big\n", Sheet->Name);
+        return;
+    }
+
+    snprintf((char *)HeaderPath, sizeof(HeaderPath), "../gen/%s_sprites.h", Sheet->Name);
+    WriteOutputIfChanged(Manifest, HeaderPath, Text, Size);
+}
+
+typedef struct
+{
+    u8 *Path;
+    sprite_sheet Sheet;
+    ryn_memory_arena Arena; /* NOTE: Owns the atlases until the packs are written. */
+    u64 CacheKey;
+    b32 Cached;
+    b32 Built;
+} sprite_sheet_job;
+
+/*
+  Read, pack and bake one .sprites file, or load the result from the asset cache. The cache key
+  covers the sheet's name, its .sprites file and its image, so editing any of them rebakes it.
+*/
+internal void BuildSpriteSheetJob(void *Data, s32 WorkerIndex)
+{
+    sprite_sheet_job *Job = Data;
+    sprite_sheet *Sheet = &Job->Sheet;
+    ryn_memory_arena *Arena = &Job->Arena;
+    u8 *FileName = Job->Path;
+    u8 ImagePath[256];
+
+    for (u8 *At = Job->Path; *At; ++At)
+    {
+        if (*At == PATH_SEPARATOR)
+        {
+            FileName = At + 1;
+        }
+    }
+
+    s32 NameLength = GetStringLength(FileName) - (s32)(sizeof(".sprites") - 1);
+
+    if (NameLength <= 0 || NameLength >= ASSET_PACK_NAME_MAX - SPRITE_ATLAS_NAME_SUFFIX_MAX)
+    {
+        printf("Error in BuildSpriteSheetJob: bad sprite sheet name \"%s\"\n", Job->Path);
+        return;
+    }
+
+    *Arena = ryn_memory_CreateArena(SPRITE_SHEET_ARENA_SIZE);
+
+    if (!Arena->Data)
+    {
+        LogError("allocating sprite sheet arena");
+        return;
+    }
+
+    core_CopyMemory(FileName, Sheet->Name, NameLength);
+    Sheet->Name[NameLength] = 0;
+
+    u64 TextOffset = Arena->Offset;
+    u64 TextSize = ReadFileIntoAllocator(Arena, Job->Path);
+
+    if (!TextSize || !ParseSpriteSheet(Arena->Data + TextOffset, Sheet))
+    {
+        return;
+    }
+
+    snprintf((char *)ImagePath, sizeof(ImagePath), "../assets/%s", Sheet->ImageName);
+
+    if (!platform_GetFileInfo(ImagePath).Exists)
+    {
+        printf("Error in BuildSpriteSheetJob: could not find \"%s\"\n", ImagePath);
+        return;
+    }
+
+    u64 ImageOffset = Arena->Offset;
+    u64 ImageFileSize = ReadFileIntoAllocator(Arena, ImagePath);
+    u64 ImageSize = ImageFileSize ? ImageFileSize - 1 : 0; /* NOTE: Minus 1 for the null-terminator. */
+    u8 *Image = Arena->Data + ImageOffset;
+
+    if (!ImageSize)
+    {
+        printf("Error in BuildSpriteSheetJob: could not read \"%s\"\n", ImagePath);
+        return;
+    }
+
+    u64 InputHashes[3] = {HashCString(Sheet->Name), HashBytes(Arena->Data + TextOffset, TextSize - 1), HashBytes(Image, ImageSize)};
+    Job->CacheKey = GetAssetCacheKey("sprites", SPRITE_ATLAS_VERSION, InputHashes, ArrayCount(InputHashes));
+
+    sprite_sheet CachedSheet;
+    u8 *CachedPixels;
+    u64 CachedSize;
+
+    if (ReadAssetCache(Arena, Job->CacheKey, &CachedSheet, sizeof(CachedSheet), &CachedPixels, &CachedSize) &&
+        SetSpriteAtlasPixels(&CachedSheet, 0) == CachedSize)
+    {
+        *Sheet = CachedSheet;
+        SetSpriteAtlasPixels(Sheet, CachedPixels);
+        Job->Cached = 1;
+        Job->Built = 1;
+    }
+    else if (PackSpriteAtlas(Sheet))
+    {
+        s32 Width, Height, ChannelCount;
+        u32 *Pixels = (u32 *)stbi_load_from_memory(Image, (int)ImageSize, &Width, &Height, &ChannelCount, 4);
+
+        if (Pixels)
+        {
+            Job->Built = BakeSpriteAtlases(Arena, Sheet, Pixels, (u32)Width, (u32)Height);
+            stbi_image_free(Pixels);
+        }
+        else
+        {
+            printf("Error in BuildSpriteSheetJob: could not decode \"%s\"\n", ImagePath);
+        }
+
+        if (Job->Built)
+        {
+            /* NOTE: The pointers are meaningless on disk, they're set again when the entry is read. */
+            sprite_sheet SheetToCache = *Sheet;
+            u8 *AtlasesPixels = Sheet->Atlases[0].Pixels;
+            u64 AtlasesSize = SetSpriteAtlasPixels(&SheetToCache, 0);
+            WriteAssetCache(Job->CacheKey, &SheetToCache, sizeof(SheetToCache), AtlasesPixels, AtlasesSize);
+        }
+    }
+}
+
+/* Queue a BuildSpriteSheetJob for every .sprites file in Directory. Returns the number of jobs. */
+internal u32 PushSpriteSheetJobs(ryn_memory_arena *Arena, job_system *JobSystem, u8 *Directory, sprite_sheet_job *Jobs, u32 JobMax)
+{
+    u32 JobCount = 0;
+    u64 ListOffset = Arena->Offset;
+    file_list *Files = WalkDirectory(Arena, Directory);
+
+    /* NOTE: WalkDirectory doesn't allocate anything when the directory is empty. */
+    for (file_list *File = Arena->Offset != ListOffset ? Files : 0; File; File = File->Next)
+    {
+        if (!HasExtension(File->Name.Bytes, ".sprites"))
+        {
+            continue;
+        }
+        else if (JobCount == JobMax)
+        {
+            printf("Error in PushSpriteSheetJobs: more than %u sprite sheets\n", JobMax);
+            break;
+        }
+
+        sprite_sheet_job *Job = &Jobs[JobCount++];
+        SetMemory((u8 *)Job, 0, sizeof(sprite_sheet_job));
+        Job->Path = File->Name.Bytes;
+        PushJob(JobSystem, BuildSpriteSheetJob, Job);
+    }
+
+    return JobCount;
+}
+
+/* Find the sheet built from FileName, which is "<name>.sprites". Sheets that failed to build aren't found. */
+internal sprite_sheet *FindSpriteSheet(sprite_sheet_job *Jobs, u32 JobCount, u8 *FileName)
+{
+    sprite_sheet *Result = 0;
+    s32 NameLength = GetStringLength(FileName) - (s32)(sizeof(".sprites") - 1);
+
+    for (u32 I = 0; NameLength > 0 && I < JobCount; ++I)
+    {
+        sprite_sheet *Sheet = &Jobs[I].Sheet;
+        b32 Matches = Jobs[I].Built && GetStringLength(Sheet->Name) == NameLength;
+
+        for (s32 C = 0; Matches && C < NameLength; ++C)
+        {
+            Matches = Sheet->Name[C] == FileName[C];
+        }
+
+        if (Matches)
+        {
+            Result = Sheet;
+            break;
+        }
+    }
+
+    return Result;
+}
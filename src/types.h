@@ -18,6 +18,7 @@ typedef uint8_t    b8;
 typedef uint32_t   b32;
 
 typedef float      f32;
+typedef double     f64;
 
 typedef size_t     size;
 